@@ -8,6 +8,9 @@
 #include <CommitHistoryView.h>
 #include <CommitHistoryColumns.h>
 #include <CommitInfo.h>
+#include <BlameCache.h>
+#include <GitBase.h>
+#include <GitQlientSettings.h>
 
 #include <QFileSystemModel>
 #include <QTreeView>
@@ -24,11 +27,17 @@ BlameWidget::BlameWidget(const QSharedPointer<RevisionsCache> &cache, const QSha
    , mCache(cache)
    , mGit(git)
    , fileSystemModel(new QFileSystemModel())
-   , mRepoModel(new CommitHistoryModel(mCache, mGit))
+   , mRepoModel(new CommitHistoryModel(mCache))
    , mRepoView(new CommitHistoryView(mCache, mGit))
    , fileSystemView(new QTreeView())
    , mTabWidget(new QTabWidget())
 {
+   GitQlientSettings settings;
+   const auto blamesOnDisk
+       = settings.value(GitQlientSettings::BlameCacheOnDiskKey, GitQlientSettings::BlameCacheOnDiskValue).toBool();
+
+   mBlameCache.reset(new BlameCache(mGit->getWorkingDir(), blamesOnDisk));
+
    mTabWidget->setObjectName("HistoryTab");
    mRepoView->setObjectName("blameGraphView");
    mRepoView->setModel(mRepoModel);
@@ -119,7 +128,7 @@ void BlameWidget::showFileHistory(const QString &filePath)
          mRepoView->blockSignals(false);
 
          const auto previousSha = shaHistory.count() > 1 ? shaHistory.at(1) : QString(tr("No info"));
-         const auto fileBlameWidget = new FileBlameWidget(mCache, mGit);
+         const auto fileBlameWidget = new FileBlameWidget(mCache, mGit, mBlameCache);
 
          fileBlameWidget->setup(filePath, shaHistory.constFirst(), previousSha);
          connect(fileBlameWidget, &FileBlameWidget::signalCommitSelected, mRepoView, &CommitHistoryView::focusOnCommit);
@@ -27,6 +27,7 @@
 #include <QMap>
 
 class RevisionsCache;
+class BlameCache;
 class GitBase;
 class QFileSystemModel;
 class FileBlameWidget;
@@ -110,6 +111,7 @@ public:
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
+   QSharedPointer<BlameCache> mBlameCache;
    QFileSystemModel *fileSystemModel = nullptr;
    CommitHistoryModel *mRepoModel = nullptr;
    CommitHistoryView *mRepoView = nullptr;
@@ -1,22 +1,31 @@
 #include "Controls.h"
 
 #include <GitBase.h>
+#include <GitJobScheduler.h>
 #include <GitStashes.h>
 #include <GitQlientStyles.h>
 #include <GitRemote.h>
 #include <BranchDlg.h>
 #include <RepoConfigDlg.h>
 
-#include <QApplication>
 #include <QToolButton>
 #include <QHBoxLayout>
 #include <QMenu>
 #include <QMessageBox>
 #include <QPushButton>
 
-Controls::Controls(const QSharedPointer<GitBase> &git, QWidget *parent)
+namespace
+{
+const QString FETCH_JOB = "fetch";
+const QString PULL_JOB = "pull";
+const QString PUSH_JOB = "push";
+const QString PRUNE_JOB = "prune";
+}
+
+Controls::Controls(const QSharedPointer<GitBase> &git, const QSharedPointer<GitJobScheduler> &jobs, QWidget *parent)
    : QFrame(parent)
    , mGit(git)
+   , mJobs(jobs)
    , mHistory(new QToolButton())
    , mDiff(new QToolButton())
    , mBlame(new QToolButton())
@@ -160,6 +169,8 @@ Controls::Controls(const QSharedPointer<GitBase> &git, QWidget *parent)
    connect(mRefreshBtn, &QToolButton::clicked, this, &Controls::signalRepositoryUpdated);
    connect(mConfigBtn, &QToolButton::clicked, this, &Controls::showConfigDlg);
    connect(mMergeWarning, &QPushButton::clicked, this, &Controls::signalGoMerge);
+   connect(mJobs.data(), &GitJobScheduler::signalJobFinished, this, &Controls::onJobFinished);
+   connect(mJobs.data(), &GitJobScheduler::signalJobCanceled, this, &Controls::onJobCanceled);
 
    enableButtons(false);
 }
@@ -198,11 +209,43 @@ void Controls::enableButtons(bool enabled)
 
 void Controls::pullCurrentBranch()
 {
-   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-   QScopedPointer<GitRemote> git(new GitRemote(mGit));
-   const auto ret = git->pull();
-   QApplication::restoreOverrideCursor();
+   mPullBtn->setEnabled(false);
+
+   mJobs->schedule(PULL_JOB, GitJobPriority::User, [git = mGit]() {
+      QScopedPointer<GitRemote> remote(new GitRemote(git));
+      return remote->pull();
+   });
+}
+
+void Controls::onJobFinished(int, const QString &key, const GitExecResult &ret)
+{
+   if (key == FETCH_JOB || key == PRUNE_JOB)
+   {
+      if (ret.success)
+         emit signalRepositoryUpdated();
+   }
+   else if (key == PULL_JOB)
+   {
+      mPullBtn->setEnabled(true);
+      processPullResult(ret);
+   }
+   else if (key == PUSH_JOB)
+   {
+      mPushBtn->setEnabled(true);
+      processPushResult(ret);
+   }
+}
+
+void Controls::onJobCanceled(int, const QString &key)
+{
+   if (key == PULL_JOB)
+      mPullBtn->setEnabled(true);
+   else if (key == PUSH_JOB)
+      mPushBtn->setEnabled(true);
+}
 
+void Controls::processPullResult(const GitExecResult &ret)
+{
    if (ret.success)
       emit signalRepositoryUpdated();
    else
@@ -229,13 +272,22 @@ void Controls::pullCurrentBranch()
 
 void Controls::fetchAll()
 {
-   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-   QScopedPointer<GitRemote> git(new GitRemote(mGit));
-   const auto ret = git->fetch();
-   QApplication::restoreOverrideCursor();
+   fetch(false);
+}
 
-   if (ret)
-      emit signalRepositoryUpdated();
+void Controls::fetchInBackground()
+{
+   fetch(true);
+}
+
+void Controls::fetch(bool background)
+{
+   const auto priority = background ? GitJobPriority::Background : GitJobPriority::User;
+
+   mJobs->schedule(FETCH_JOB, priority, [git = mGit]() {
+      QScopedPointer<GitRemote> remote(new GitRemote(git));
+      return GitExecResult(remote->fetch(), QString());
+   });
 }
 
 void Controls::activateMergeWarning()
@@ -265,11 +317,16 @@ ControlsMainViews Controls::getCurrentSelectedButton() const
 
 void Controls::pushCurrentBranch()
 {
-   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-   QScopedPointer<GitRemote> git(new GitRemote(mGit));
-   const auto ret = git->push();
-   QApplication::restoreOverrideCursor();
+   mPushBtn->setEnabled(false);
 
+   mJobs->schedule(PUSH_JOB, GitJobPriority::User, [git = mGit]() {
+      QScopedPointer<GitRemote> remote(new GitRemote(git));
+      return remote->push();
+   });
+}
+
+void Controls::processPushResult(const GitExecResult &ret)
+{
    if (ret.output.toString().contains("has no upstream branch"))
    {
       const auto currentBranch = mGit->getCurrentBranch();
@@ -323,13 +380,10 @@ void Controls::popStashedWork()
 
 void Controls::pruneBranches()
 {
-   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-   QScopedPointer<GitRemote> git(new GitRemote(mGit));
-   const auto ret = git->prune();
-   QApplication::restoreOverrideCursor();
-
-   if (ret.success)
-      emit signalRepositoryUpdated();
+   mJobs->schedule(PRUNE_JOB, GitJobPriority::User, [git = mGit]() {
+      QScopedPointer<GitRemote> remote(new GitRemote(git));
+      return remote->prune();
+   });
 }
 
 void Controls::showConfigDlg()
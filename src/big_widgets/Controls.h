@@ -28,6 +28,8 @@
 class QToolButton;
 class QPushButton;
 class GitBase;
+class GitJobScheduler;
+struct GitExecResult;
 
 /*!
  \brief Enum used to configure the different views handled by the Controls widget.
@@ -86,9 +88,11 @@ public:
     \brief Default constructor.
 
     \param git The git object to perform Git operations.
+    \param jobs The scheduler that runs the remote operations in background.
     \param parent The parent widget if needed.
    */
-   explicit Controls(const QSharedPointer<GitBase> &git, QWidget *parent = nullptr);
+   explicit Controls(const QSharedPointer<GitBase> &git, const QSharedPointer<GitJobScheduler> &jobs,
+                     QWidget *parent = nullptr);
    /*!
     \brief Process the toggled button and triggers its corresponding action.
 
@@ -112,6 +116,12 @@ public:
 
    */
    void fetchAll();
+   /*!
+    \brief Performs the fetch action with background priority so it never delays the user actions. Used by the
+    auto-fetch timer.
+
+   */
+   void fetchInBackground();
    /*!
     \brief Activates the merge warning frame.
 
@@ -142,6 +152,7 @@ public:
 private:
    QString mCurrentSha;
    QSharedPointer<GitBase> mGit;
+   QSharedPointer<GitJobScheduler> mJobs;
    QToolButton *mHistory = nullptr;
    QToolButton *mDiff = nullptr;
    QToolButton *mBlame = nullptr;
@@ -152,6 +163,12 @@ private:
    QToolButton *mConfigBtn = nullptr;
    QPushButton *mMergeWarning = nullptr;
 
+   /*!
+    \brief Schedules the fetch of all the remotes.
+
+    \param background True if the fetch was triggered by the auto-fetch timer, false if it was requested by the user.
+   */
+   void fetch(bool background);
    /*!
     \brief Pulls the current branch.
 
@@ -181,4 +198,29 @@ private:
     * \brief Shows the config dialog for both Local and Global user data.
     */
    void showConfigDlg();
+   /*!
+    \brief Processes the result of the remote operations once the scheduler has run them.
+
+    \param key The key of the job.
+    \param ret The result of the job.
+   */
+   void onJobFinished(int, const QString &key, const GitExecResult &ret);
+   /*!
+    \brief Enables again the buttons of a remote operation that has been canceled.
+
+    \param key The key of the job.
+   */
+   void onJobCanceled(int, const QString &key);
+   /*!
+    \brief Shows the conflicts or the errors of a pull operation.
+
+    \param ret The result of the pull.
+   */
+   void processPullResult(const GitExecResult &ret);
+   /*!
+    \brief Asks for the upstream branch or shows the errors of a push operation.
+
+    \param ret The result of the push.
+   */
+   void processPushResult(const GitExecResult &ret);
 };
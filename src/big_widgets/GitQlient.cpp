@@ -8,6 +8,7 @@
 #include <QTabWidget>
 #include <QTabBar>
 #include <GitQlientRepo.h>
+#include <RevisionsCache.h>
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QFile>
@@ -19,6 +20,12 @@
 using namespace QLogger;
 using namespace GitQlientTools;
 
+namespace
+{
+constexpr int LANE_BENCHMARK_BRANCHES = 256;
+constexpr int LANE_BENCHMARK_COMMITS_PER_BRANCH = 2000;
+}
+
 GitQlient::GitQlient(QWidget *parent)
    : GitQlient(QStringList(), parent)
 {
@@ -38,6 +45,9 @@ GitQlient::GitQlient(const QStringList &arguments, QWidget *parent)
    QLog_Info("UI", QString("*                  %1                  *").arg(VER));
    QLog_Info("UI", "*******************************************");
 
+   if (mLaneBenchmark)
+      RevisionsCache::runLaneBenchmark(LANE_BENCHMARK_BRANCHES, LANE_BENCHMARK_COMMITS_PER_BRANCH);
+
    QFile styles(":/stylesheet");
 
    setStyleSheet(GitQlientStyles::getStyles());
@@ -126,6 +136,12 @@ QStringList GitQlient::parseArguments(const QStringList &arguments)
    if (arguments.contains("-noLog") || settings.value("logsDisabled", false).toBool())
       QLoggerManager::getInstance()->pause();
 
+   if (arguments.contains("-scrollBenchmark"))
+      mScrollBenchmark = true;
+
+   if (arguments.contains("-laneBenchmark"))
+      mLaneBenchmark = true;
+
    QLog_Info("UI", QString("Getting arguments {%1}").arg(arguments.join(", ")));
 
    QStringList repos;
@@ -172,6 +188,7 @@ void GitQlient::addRepoTab(const QString &repoPath)
    if (!mCurrentRepos.contains(repoPath))
    {
       const auto newRepo = new GitQlientRepo(repoPath);
+      newRepo->setScrollBenchmark(mScrollBenchmark);
       connect(newRepo, &GitQlientRepo::signalEditFile, this, &GitQlient::signalEditDocument);
       connect(newRepo, &GitQlientRepo::signalOpenSubmodule, this, [this](const QString &repoName) {
          const auto currentDir = dynamic_cast<GitQlientRepo *>(sender())->currentDir();
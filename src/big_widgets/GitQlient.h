@@ -78,6 +78,8 @@ private:
    QTabWidget *mRepos = nullptr;
    ConfigWidget *mConfigWidget = nullptr;
    QSet<QString> mCurrentRepos;
+   bool mScrollBenchmark = false;
+   bool mLaneBenchmark = false;
 
    /*!
     \brief This method parses all the arguments and configures GitQlient settings with them. Part of the arguments can
@@ -19,10 +19,11 @@
 #include <GitConfig.h>
 #include <GitBase.h>
 #include <GitHistory.h>
+#include <GitDiffPrefetcher.h>
+#include <GitJobScheduler.h>
+#include <GitRepoWatcher.h>
 
 #include <QTimer>
-#include <QDirIterator>
-#include <QFileSystemWatcher>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QStackedWidget>
@@ -32,14 +33,24 @@
 
 using namespace QLogger;
 
+namespace
+{
+const QString PREFETCH_FILES_JOB = "prefetch-files";
+const QString SEARCH_INDEX_JOB = "search-index";
+// Every job indexes only a part of the history so the jobs scheduled meanwhile don't wait for the whole repository.
+constexpr int SEARCH_INDEX_JOB_COMMITS = 50000;
+}
+
 GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    : QFrame(parent)
    , mGitQlientCache(new RevisionsCache())
    , mGitBase(new GitBase(repoPath))
+   , mJobScheduler(new GitJobScheduler())
    , mGitLoader(new GitRepoLoader(mGitBase, mGitQlientCache))
+   , mDiffPrefetcher(new GitDiffPrefetcher(mGitBase, mGitQlientCache))
    , mHistoryWidget(new HistoryWidget(mGitQlientCache, mGitBase))
    , mStackedLayout(new QStackedLayout())
-   , mControls(new Controls(mGitBase))
+   , mControls(new Controls(mGitBase, mJobScheduler))
    , mDiffWidget(new DiffWidget(mGitBase, mGitQlientCache))
    , mBlameWidget(new BlameWidget(mGitQlientCache, mGitBase))
    , mMergeWidget(new MergeWidget(mGitQlientCache, mGitBase))
@@ -66,13 +77,21 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    mainLayout->addLayout(mStackedLayout);
 
    GitQlientSettings settings;
-   const auto fetchInterval = settings.value("autoFetch", mConfig.mAutoFetchSecs).toInt();
+   // The auto-fetch interval is configured in minutes. Zero, the default of the configuration page, disables it.
+   const auto fetchInterval = settings.value("autoFetch", 0).toInt();
 
-   mAutoFetch->setInterval(fetchInterval * 1000);
+   mAutoFetch->setInterval(fetchInterval * 60 * 1000);
    mAutoFilesUpdate->setInterval(mConfig.mAutoFileUpdateSecs * 1000);
 
-   connect(mAutoFetch, &QTimer::timeout, mControls, &Controls::fetchAll);
+   mConfig.mWatcherBatchMsecs = settings.value("watcherBatchWindow", mConfig.mWatcherBatchMsecs).toInt();
+
+   const auto filesCacheMb
+       = settings.value(GitQlientSettings::RevisionFilesCacheKey, GitQlientSettings::RevisionFilesCacheValue).toInt();
+   mGitQlientCache->setRevisionFilesBudget(static_cast<qint64>(filesCacheMb) * 1024 * 1024);
+
+   connect(mAutoFetch, &QTimer::timeout, mControls, &Controls::fetchInBackground);
    connect(mAutoFilesUpdate, &QTimer::timeout, this, &GitQlientRepo::updateUiFromWatcher);
+   connect(mJobScheduler.data(), &GitJobScheduler::signalJobFinished, this, &GitQlientRepo::onJobFinished);
 
    connect(mControls, &Controls::signalGoRepo, this, &GitQlientRepo::showHistoryView);
    connect(mControls, &Controls::signalGoBlame, this, &GitQlientRepo::showBlameView);
@@ -83,6 +102,7 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    connect(mControls, &Controls::signalPullConflict, this, &GitQlientRepo::showPullConflict);
 
    connect(mHistoryWidget, &HistoryWidget::signalEditFile, this, &GitQlientRepo::signalEditFile);
+   connect(mHistoryWidget, &HistoryWidget::signalCommitSelected, this, &GitQlientRepo::prefetchCommitFiles);
    connect(mHistoryWidget, &HistoryWidget::signalAllBranchesActive, mGitLoader.data(), &GitRepoLoader::setShowAll);
    connect(mHistoryWidget, &HistoryWidget::signalAllBranchesActive, this, &GitQlientRepo::updateCache);
    connect(mHistoryWidget, &HistoryWidget::signalUpdateCache, this, &GitQlientRepo::updateCache);
@@ -115,15 +135,23 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    connect(mMergeWidget, &MergeWidget::signalMergeFinished, mControls, &Controls::disableMergeWarning);
    connect(mMergeWidget, &MergeWidget::signalEditFile, this, &GitQlientRepo::signalEditFile);
 
+   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStarted, this, &GitQlientRepo::onRepoLoadStarted);
    connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStarted, this, &GitQlientRepo::createProgressDialog);
+   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingProgress, mHistoryWidget,
+           &HistoryWidget::onRevisionsAppended);
+   connect(mGitLoader.data(), &GitRepoLoader::signalRevisionsInserted, mHistoryWidget,
+           &HistoryWidget::onRevisionsInserted);
    connect(mGitLoader.data(), &GitRepoLoader::signalLoadingFinished, this, &GitQlientRepo::onRepoLoadFinished);
+   connect(mGitLoader.data(), &GitRepoLoader::signalWipUpdated, this, &GitQlientRepo::onWipUpdated);
 
    m_loaderThread = new QThread();
    mGitLoader->moveToThread(m_loaderThread);
    connect(this, &GitQlientRepo::signalLoadRepo, mGitLoader.data(), &GitRepoLoader::loadRepository);
+   connect(this, &GitQlientRepo::signalUpdateRepo, mGitLoader.data(), &GitRepoLoader::updateRepository);
    m_loaderThread->start();
 
    mGitLoader->setShowAll(settings.value("ShowAllBranches", true).toBool());
+   mGitQlientCache->setLazyGraph(settings.value("LazyGraph", false).toBool());
 
    setRepository(repoPath);
 }
@@ -151,6 +179,9 @@ void GitQlientRepo::setConfig(const GitQlientRepoConfig &config)
    mAutoFilesUpdate->stop();
    mAutoFilesUpdate->setInterval(mConfig.mAutoFileUpdateSecs);
    mAutoFilesUpdate->start();
+
+   if (mGitWatcher)
+      mGitWatcher->setBatchWindow(mConfig.mWatcherBatchMsecs);
 }
 
 void GitQlientRepo::updateCache()
@@ -159,7 +190,7 @@ void GitQlientRepo::updateCache()
    {
       QLog_Debug("UI", QString("Updating the GitQlient UI"));
 
-      emit signalLoadRepo();
+      emit signalUpdateRepo();
 
       mDiffWidget->reload();
    }
@@ -169,13 +200,29 @@ void GitQlientRepo::updateUiFromWatcher()
 {
    QLog_Info("UI", QString("Updating the GitQlient UI from watcher"));
 
-   mGitLoader->updateWipRevision();
+   mGitLoader->requestWipUpdate(true);
+}
 
+void GitQlientRepo::scheduleSearchIndex()
+{
+   mJobScheduler->schedule(SEARCH_INDEX_JOB, GitJobPriority::Background, [cache = mGitQlientCache]() {
+      return GitExecResult(true, cache->updateSearchIndex(SEARCH_INDEX_JOB_COMMITS));
+   });
+}
+
+void GitQlientRepo::onWipUpdated()
+{
    mHistoryWidget->updateUiFromWatcher();
 
    mDiffWidget->reload();
 }
 
+void GitQlientRepo::onJobFinished(int, const QString &key, const GitExecResult &result)
+{
+   if (key == SEARCH_INDEX_JOB && result.output.toInt() > 0)
+      scheduleSearchIndex();
+}
+
 void GitQlientRepo::setRepository(const QString &newDir)
 {
    if (!newDir.isEmpty())
@@ -202,24 +249,31 @@ void GitQlientRepo::setRepository(const QString &newDir)
 
 void GitQlientRepo::setWatcher()
 {
-   mGitWatcher = new QFileSystemWatcher(this);
-   connect(mGitWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &path) {
-      if (!path.endsWith(".autosave") && !path.endsWith(".tmp") && !path.endsWith(".user"))
-         updateUiFromWatcher();
-   });
+   mGitWatcher = new GitRepoWatcher(mGitBase, mJobScheduler, this);
+   mGitWatcher->setBatchWindow(mConfig.mWatcherBatchMsecs);
 
-   QLog_Info("UI", QString("Setting the file watcher for dir {%1}").arg(mCurrentDir));
+   connect(mGitWatcher, &GitRepoWatcher::signalWorkTreeChanged, this, &GitQlientRepo::updateWipFromWatcher);
+   connect(mGitWatcher, &GitRepoWatcher::signalIndexChanged, this, &GitQlientRepo::updateUiFromWatcher);
+   connect(mGitWatcher, &GitRepoWatcher::signalReferencesChanged, this, &GitQlientRepo::updateCache);
 
-   mGitWatcher->addPath(mCurrentDir);
+   mGitWatcher->start();
+}
 
-   QDirIterator it(mCurrentDir, QDirIterator::Subdirectories);
-   while (it.hasNext())
-   {
-      const auto dir = it.next();
+void GitQlientRepo::updateWipFromWatcher(const QStringList &dirs, const QStringList &trees)
+{
+   mGitLoader->addWipChanges(dirs, trees);
 
-      if (it.fileInfo().isDir() && !dir.endsWith(".") && !dir.endsWith(".."))
-         mGitWatcher->addPath(dir);
-   }
+   // The pending refresh takes all the changes accumulated by the time it runs.
+   mGitLoader->requestWipUpdate(false);
+}
+
+void GitQlientRepo::prefetchCommitFiles(const QString &sha)
+{
+   mDiffPrefetcher->setSelectedCommit(sha);
+
+   // The pending job loads the files around the commit selected by the time it runs.
+   mJobScheduler->schedule(PREFETCH_FILES_JOB, GitJobPriority::Background,
+                           [prefetcher = mDiffPrefetcher]() { return prefetcher->prefetch(); });
 }
 
 void GitQlientRepo::clearWindow()
@@ -257,6 +311,11 @@ void GitQlientRepo::createProgressDialog()
    }
 }
 
+void GitQlientRepo::onRepoLoadStarted(int totalCommits)
+{
+   mHistoryWidget->onNewRevisions(totalCommits);
+}
+
 void GitQlientRepo::onRepoLoadFinished()
 {
    if (mProgressDlg)
@@ -280,6 +339,8 @@ void GitQlientRepo::onRepoLoadFinished()
       mControls->enableButtons(true);
 
       mAutoFilesUpdate->start();
+      if (mAutoFetch->interval() > 0)
+         mAutoFetch->start();
 
       QScopedPointer<GitConfig> git(new GitConfig(mGitBase));
 
@@ -300,8 +361,17 @@ void GitQlientRepo::onRepoLoadFinished()
    const auto totalCommits = mGitQlientCache->count();
 
    mHistoryWidget->loadBranches();
-   mHistoryWidget->onNewRevisions(totalCommits);
+   mHistoryWidget->onRevisionsAppended(totalCommits);
+   mHistoryWidget->updateUiFromWatcher();
    mBlameWidget->onNewRevisions(totalCommits);
+
+   scheduleSearchIndex();
+
+   if (mScrollBenchmark)
+   {
+      mScrollBenchmark = false;
+      mHistoryWidget->runScrollBenchmark();
+   }
 }
 
 void GitQlientRepo::loadFileDiff(const QString &currentSha, const QString &previousSha, const QString &file)
@@ -396,8 +466,8 @@ void GitQlientRepo::showPreviousView()
 void GitQlientRepo::updateWip()
 {
    mHistoryWidget->resetWip();
-   mGitLoader.data()->updateWipRevision();
-   mHistoryWidget->updateUiFromWatcher();
+
+   mGitLoader->requestWipUpdate(true);
 }
 
 void GitQlientRepo::openCommitDiff(const QString currentSha)
@@ -433,6 +503,7 @@ void GitQlientRepo::closeEvent(QCloseEvent *ce)
    QLog_Info("UI", QString("Closing GitQlient for repository {%1}").arg(mCurrentDir));
 
    mGitLoader->cancelAll();
+   mJobScheduler->cancelAll();
 
    QWidget::closeEvent(ce);
 }
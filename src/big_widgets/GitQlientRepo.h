@@ -28,10 +28,13 @@
 #include <QPointer>
 
 class GitBase;
+class GitDiffPrefetcher;
+class GitJobScheduler;
+struct GitExecResult;
 class RevisionsCache;
 class GitRepoLoader;
 class QCloseEvent;
-class QFileSystemWatcher;
+class GitRepoWatcher;
 class QStackedLayout;
 class Controls;
 class HistoryWidget;
@@ -57,6 +60,7 @@ struct GitQlientRepoConfig
    int mAutoFetchSecs = 300; /*!< The auto-fetch interval in seconds. Default value: 300. */
    int mAutoFileUpdateSecs
        = 5; /*!< The interval where GitQlient retrieves information from disk for the current WIP. Default: 10 secs.*/
+   int mWatcherBatchMsecs = 500; /*!< The time without file-system events after which the changes are processed. */
 };
 
 /*!
@@ -85,6 +89,7 @@ signals:
    void signalEditFile(const QString &fileName, int line, int column);
 
    void signalLoadRepo();
+   void signalUpdateRepo();
 
 public:
    /*!
@@ -112,6 +117,12 @@ public:
     \return QString The current working dir.
    */
    QString currentDir() const { return mCurrentDir; }
+   /*!
+    \brief Enables the scroll benchmark of the graph view. It runs once the repository is loaded.
+
+    \param enabled True to run the benchmark.
+   */
+   void setScrollBenchmark(bool enabled) { mScrollBenchmark = enabled; }
    /*!
     \brief Sets the repository once the widget is created.
 
@@ -132,7 +143,9 @@ private:
    GitQlientRepoConfig mConfig;
    QSharedPointer<RevisionsCache> mGitQlientCache;
    QSharedPointer<GitBase> mGitBase;
+   QSharedPointer<GitJobScheduler> mJobScheduler;
    QSharedPointer<GitRepoLoader> mGitLoader;
+   QSharedPointer<GitDiffPrefetcher> mDiffPrefetcher;
    HistoryWidget *mHistoryWidget = nullptr;
    QStackedLayout *mStackedLayout = nullptr;
    Controls *mControls = nullptr;
@@ -143,10 +156,11 @@ private:
    QTimer *mAutoFetch = nullptr;
    QTimer *mAutoFilesUpdate = nullptr;
    QPointer<ProgressDlg> mProgressDlg;
-   QFileSystemWatcher *mGitWatcher = nullptr;
+   GitRepoWatcher *mGitWatcher = nullptr;
    QPair<ControlsMainViews, QWidget *> mPreviousView;
 
    bool mIsInit = false;
+   bool mScrollBenchmark = false;
    QThread *m_loaderThread;
 
    /*!
@@ -155,10 +169,38 @@ private:
    */
    void updateCache();
    /*!
-    \brief Performs a light UI update triggered by the QFileSystemWatcher.
+    \brief Performs a light UI update triggered by the timer.
 
    */
    void updateUiFromWatcher();
+   /*!
+    \brief Schedules the indexing in background of the commits that are not in the search index yet.
+   */
+   void scheduleSearchIndex();
+   /*!
+    \brief Refreshes the WIP only for the directories that changed in the work tree.
+
+    \param dirs The directories whose files changed.
+    \param trees The directories that were created or removed.
+   */
+   void updateWipFromWatcher(const QStringList &dirs, const QStringList &trees);
+   /*!
+    \brief Refreshes the widgets once the WIP has been updated in background.
+   */
+   void onWipUpdated();
+   /*!
+    \brief Keeps indexing the commits until all of them are searchable.
+
+    \param key The key of the job.
+    \param result The result of the job.
+   */
+   void onJobFinished(int, const QString &key, const GitExecResult &result);
+   /*!
+    \brief Loads in background the files of the commits around the selected one.
+
+    \param sha The selected commit SHA.
+   */
+   void prefetchCommitFiles(const QString &sha);
    /*!
     \brief Opens the diff view with the selected commit from the repository view.
     \param currentSha The current selected commit SHA.
@@ -204,6 +246,14 @@ private:
    */
    void createProgressDialog();
 
+   /*!
+    \brief Resets the history view when the repository starts loading. The commits will be added progressively while
+    they are received.
+
+    \param totalCommits The commits already available in the cache.
+   */
+   void onRepoLoadStarted(int totalCommits);
+
    /*!
     \brief When the loading finishes this method closes and destroyes the dialog.
 
@@ -4,6 +4,10 @@
 
 const QString GitQlientSettings::ExternalEditorKey = "externalEditor";
 const QString GitQlientSettings::ExternalEditorValue = "gedit";
+const QString GitQlientSettings::RevisionFilesCacheKey = "revisionFilesCacheMB";
+const int GitQlientSettings::RevisionFilesCacheValue = 64;
+const QString GitQlientSettings::BlameCacheOnDiskKey = "blameCacheOnDisk";
+const bool GitQlientSettings::BlameCacheOnDiskValue = true;
 
 void GitQlientSettings::setValue(const QString &key, const QVariant &value)
 {
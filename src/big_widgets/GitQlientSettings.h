@@ -106,4 +106,20 @@ public:
     * @brief ExternalEditorValue The value for the external editor settings key.
     */
    static const QString ExternalEditorValue;
+   /**
+    * @brief RevisionFilesCacheKey The key for the memory budget of the files changed in the commits, in MB.
+    */
+   static const QString RevisionFilesCacheKey;
+   /**
+    * @brief RevisionFilesCacheValue The default memory budget of the files changed in the commits, in MB.
+    */
+   static const int RevisionFilesCacheValue;
+   /**
+    * @brief BlameCacheOnDiskKey The key to store the blames on disk so they are reused in the next sessions.
+    */
+   static const QString BlameCacheOnDiskKey;
+   /**
+    * @brief BlameCacheOnDiskValue The default value for the blames on disk settings key.
+    */
+   static const bool BlameCacheOnDiskValue;
 };
@@ -18,6 +18,7 @@
 #include <FileEditor.h>
 #include <GitQlientSettings.h>
 #include <GitQlientStyles.h>
+#include <SearchIndex.h>
 
 #include <QLogger.h>
 
@@ -28,15 +29,22 @@
 #include <QCheckBox>
 #include <QMessageBox>
 #include <QApplication>
+#include <QTimer>
 
 using namespace QLogger;
 
+namespace
+{
+// The filter waits until the user stops typing, so it isn't applied on every keystroke.
+constexpr int FILTER_DELAY_MS = 250;
+}
+
 HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> git,
                              QWidget *parent)
    : QFrame(parent)
    , mGit(git)
    , mCache(cache)
-   , mRepositoryModel(new CommitHistoryModel(mCache, git))
+   , mRepositoryModel(new CommitHistoryModel(mCache))
    , mRepositoryView(new CommitHistoryView(mCache, git))
    , mBranchesWidget(new BranchesWidget(mCache, git))
    , mSearchInput(new QLineEdit())
@@ -45,6 +53,8 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    , mAmendWidget(new AmendWidget(mCache, git))
    , mCommitInfoWidget(new CommitInfoWidget(mCache, git))
    , mChShowAllBranches(new QCheckBox(tr("Show all branches")))
+   , mChFilter(new QCheckBox(tr("Filter")))
+   , mFilterTimer(new QTimer(this))
    , mGraphFrame(new QFrame())
    , mFileEditor(new FileEditor())
 {
@@ -82,7 +92,7 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    connect(mCommitInfoWidget, &CommitInfoWidget::signalOpenFileCommit, this, &HistoryWidget::signalShowDiff);
    connect(mCommitInfoWidget, &CommitInfoWidget::signalShowFileHistory, this, &HistoryWidget::signalShowFileHistory);
 
-   mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA or log message..."));
+   mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA, message or author..."));
    connect(mSearchInput, &QLineEdit::returnPressed, this, &HistoryWidget::search);
 
    connect(mRepositoryView, &CommitHistoryView::signalViewUpdated, this, &HistoryWidget::signalViewUpdated);
@@ -120,8 +130,22 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    cherryPickBtn->setEnabled(false);
    cherryPickBtn->setObjectName("pbCherryPick");
    connect(cherryPickBtn, &QPushButton::clicked, this, &HistoryWidget::cherryPickCommit);
-   connect(mSearchInput, &QLineEdit::textChanged, this,
-           [cherryPickBtn](const QString &text) { cherryPickBtn->setEnabled(!text.isEmpty()); });
+   connect(mSearchInput, &QLineEdit::textChanged, this, [this, cherryPickBtn](const QString &text) {
+      cherryPickBtn->setEnabled(!text.isEmpty());
+
+      if (text.isEmpty())
+         clearSearch();
+
+      if (mChFilter->isChecked())
+         mFilterTimer->start();
+   });
+
+   mFilterTimer->setSingleShot(true);
+   mFilterTimer->setInterval(FILTER_DELAY_MS);
+   connect(mFilterTimer, &QTimer::timeout, this, &HistoryWidget::applyTextFilter);
+
+   mChFilter->setToolTip(tr("Show only the commits that match the search while typing"));
+   connect(mChFilter, &QCheckBox::toggled, this, &HistoryWidget::onFilterToggled);
 
    mChShowAllBranches->setChecked(settings.value("ShowAllBranches", true).toBool());
    connect(mChShowAllBranches, &QCheckBox::toggled, this, &HistoryWidget::onShowAllUpdated);
@@ -131,6 +155,7 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    graphOptionsLayout->setSpacing(10);
    graphOptionsLayout->addWidget(mSearchInput);
    graphOptionsLayout->addWidget(cherryPickBtn);
+   graphOptionsLayout->addWidget(mChFilter);
    graphOptionsLayout->addWidget(mChShowAllBranches);
 
    const auto viewLayout = new QVBoxLayout(mGraphFrame);
@@ -160,6 +185,7 @@ HistoryWidget::~HistoryWidget()
 
 void HistoryWidget::clear()
 {
+   clearSearch();
    mRepositoryView->clear();
    resetWip();
    mBranchesWidget->clear();
@@ -201,6 +227,8 @@ QString HistoryWidget::getCurrentSha() const
 
 void HistoryWidget::onNewRevisions(int totalCommits)
 {
+   clearSearch();
+
    mRepositoryModel->onNewRevisions(totalCommits);
 
    onCommitSelected(CommitInfo::ZERO_SHA);
@@ -210,6 +238,25 @@ void HistoryWidget::onNewRevisions(int totalCommits)
        QItemSelectionModel::Select);
 }
 
+void HistoryWidget::onRevisionsAppended(int totalCommits)
+{
+   mRepositoryModel->onRevisionsAppended(totalCommits);
+   mRepositoryView->viewport()->update();
+}
+
+void HistoryWidget::onRevisionsInserted(int row, int count)
+{
+   // The rows of the results are not valid anymore.
+   clearSearch();
+
+   mRepositoryModel->onRevisionsInserted(row, count);
+}
+
+void HistoryWidget::runScrollBenchmark()
+{
+   mRepositoryView->runScrollBenchmark();
+}
+
 void HistoryWidget::search()
 {
    const auto text = mSearchInput->text();
@@ -222,6 +269,16 @@ void HistoryWidget::search()
          goToSha(text);
       else
       {
+         if (text != mSearchText)
+         {
+            mSearchText = text;
+            mSearchRows = mCache->searchCommits(text);
+            mRepositoryView->setHighlightedRows(mSearchRows);
+         }
+
+         if (mSearchRows.isEmpty())
+            return;
+
          auto selectedItems = mRepositoryView->selectedIndexes();
          auto startingRow = 0;
 
@@ -229,17 +286,27 @@ void HistoryWidget::search()
          {
             std::sort(selectedItems.begin(), selectedItems.end(),
                       [](const QModelIndex index1, const QModelIndex index2) { return index1.row() <= index2.row(); });
-            startingRow = selectedItems.constFirst().row();
+            startingRow = mRepositoryView->sourceRow(selectedItems.constFirst().row());
          }
 
-         commitInfo = mCache->getCommitInfoByField(CommitInfo::Field::SHORT_LOG, text, startingRow + 1);
+         // The search goes on from the selected commit and wraps around at the end of the history.
+         auto nextRow = std::upper_bound(mSearchRows.cbegin(), mSearchRows.cend(), startingRow);
+
+         if (nextRow == mSearchRows.cend())
+            nextRow = mSearchRows.cbegin();
 
-         if (commitInfo.isValid())
-            goToSha(commitInfo.sha());
+         goToSha(mRepositoryModel->sha(*nextRow));
       }
    }
 }
 
+void HistoryWidget::clearSearch()
+{
+   mSearchText.clear();
+   mSearchRows.clear();
+   mRepositoryView->setHighlightedRows({});
+}
+
 void HistoryWidget::goToSha(const QString &sha)
 {
    mRepositoryView->focusOnCommit(sha);
@@ -249,14 +316,14 @@ void HistoryWidget::goToSha(const QString &sha)
 
 void HistoryWidget::commitSelected(const QModelIndex &index)
 {
-   const auto sha = mRepositoryModel->sha(index.row());
+   const auto sha = mRepositoryModel->sha(mRepositoryView->sourceRow(index.row()));
 
    onCommitSelected(sha);
 }
 
 void HistoryWidget::openDiff(const QModelIndex &index)
 {
-   const auto sha = mRepositoryModel->sha(index.row());
+   const auto sha = mRepositoryModel->sha(mRepositoryView->sourceRow(index.row()));
 
    emit signalOpenDiff(sha);
 }
@@ -269,6 +336,25 @@ void HistoryWidget::onShowAllUpdated(bool showAll)
    emit signalAllBranchesActive(showAll);
 }
 
+void HistoryWidget::onFilterToggled(bool filter)
+{
+   if (filter)
+      applyTextFilter();
+   else
+   {
+      mFilterTimer->stop();
+      mRepositoryView->activateFilter(false);
+   }
+}
+
+void HistoryWidget::applyTextFilter()
+{
+   if (const auto text = mSearchInput->text(); text.size() >= SearchIndex::MIN_QUERY_LENGTH)
+      mRepositoryView->filterByText(text);
+   else
+      mRepositoryView->activateFilter(false);
+}
+
 void HistoryWidget::onBranchCheckout()
 {
    QScopedPointer<GitBranches> gitBranches(new GitBranches(mGit));
@@ -347,6 +433,8 @@ void HistoryWidget::onCommitSelected(const QString &goToSha)
       mWipWidget->configure(goToSha);
    else
       mCommitInfoWidget->configure(goToSha);
+
+   emit signalCommitSelected(goToSha);
 }
 
 void HistoryWidget::onAmendCommit(const QString &sha)
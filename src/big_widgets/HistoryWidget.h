@@ -24,6 +24,7 @@
  ***************************************************************************************/
 
 #include <QFrame>
+#include <QVector>
 
 class RevisionsCache;
 class GitBase;
@@ -36,6 +37,7 @@ class WipWidget;
 class AmendWidget;
 class CommitInfoWidget;
 class QCheckBox;
+class QTimer;
 class RepositoryViewDelegate;
 class FileEditor;
 
@@ -144,6 +146,12 @@ signals:
     \brief Signal triggered  when the WIP needs to be updated.
    */
    void signalUpdateWip();
+   /*!
+    \brief Signal triggered when a commit has been selected and its information is shown.
+
+    \param sha The selected commit SHA.
+   */
+   void signalCommitSelected(const QString &sha);
 
 public:
    /*!
@@ -212,6 +220,25 @@ public:
     \param totalCommits The new total of commits to show in the graph.
    */
    void onNewRevisions(int totalCommits);
+   /*!
+    \brief Adds to the repository graph view the commits that have been loaded since the last update without resetting
+    the view.
+
+    \param totalCommits The new total of commits to show in the graph.
+   */
+   void onRevisionsAppended(int totalCommits);
+   /*!
+    \brief Inserts in the repository graph view the commits added by an incremental update of the repository.
+
+    \param row The first row where the commits were inserted.
+    \param count The number of commits inserted.
+   */
+   void onRevisionsInserted(int row, int count);
+   /*!
+    \brief Scrolls the repository graph view from top to bottom and back measuring the frames painted per second. The
+    result is written in the log.
+   */
+   void runScrollBenchmark();
 
 private:
    QSharedPointer<GitBase> mGit;
@@ -225,15 +252,24 @@ private:
    AmendWidget *mAmendWidget = nullptr;
    CommitInfoWidget *mCommitInfoWidget = nullptr;
    QCheckBox *mChShowAllBranches = nullptr;
+   QCheckBox *mChFilter = nullptr;
+   QTimer *mFilterTimer = nullptr;
    RepositoryViewDelegate *mItemDelegate = nullptr;
    QFrame *mGraphFrame = nullptr;
    FileEditor *mFileEditor = nullptr;
+   QString mSearchText;
+   QVector<int> mSearchRows;
 
    /*!
-    \brief Performs a search based on the input of the search QLineEdit with the users input.
+    \brief Performs a search based on the input of the search QLineEdit with the users input. All the matching
+    commits are highlighted and every search goes to the next one after the selected commit.
 
    */
    void search();
+   /*!
+    \brief Discards the results of the last search and removes their highlight from the view.
+   */
+   void clearSearch();
    /*!
     \brief Goes to the selected SHA.
 
@@ -260,6 +296,17 @@ private:
     \param showAll True to show all branches, false to show only the current branch.
    */
    void onShowAllUpdated(bool showAll);
+   /*!
+    \brief Shows only the commits that match the text of the search QLineEdit or shows the whole history again.
+
+    \param filter True to filter the history while typing, false to show all the commits.
+   */
+   void onFilterToggled(bool filter);
+   /*!
+    \brief Filters the history with the text of the search QLineEdit. Texts shorter than the minimum length of the
+    search index show the whole history, so they never scan all the commits.
+   */
+   void applyTextFilter();
    /*!
     \brief Updates the visible widgets when a different branch to the former one is checked out.
 
@@ -0,0 +1,242 @@
+#include "BlameCache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <QLogger.h>
+#include <BenchmarkTool.h>
+
+#include <algorithm>
+
+using namespace QLogger;
+using namespace GitQlientTools;
+
+static const quint32 BLAME_MAGIC = 0x4751424C; // "GQBL"
+static const quint32 BLAME_VERSION = 2;
+// The blames stored on disk are checked against MAX_DISK_BYTES when the cache is created and every so many saves.
+static const int PRUNE_INTERVAL = 64;
+
+// header: magic, version, key
+// commits: count and for every commit the sha, author, date and title
+// lines: count and for every line the index of its commit
+// Texts are stored as UTF-8.
+
+namespace
+{
+QString readText(QDataStream &stream)
+{
+   QByteArray text;
+   stream >> text;
+
+   return QString::fromUtf8(text);
+}
+
+QByteArray hashKey(const QString &key)
+{
+   return QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+}
+
+QString getBlamesDir()
+{
+   return QString("%1/blame").arg(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+}
+}
+
+BlameCache::BlameCache(const QString &repoPath, bool onDisk)
+   : mRepoPath(repoPath)
+   , mOnDisk(onDisk)
+   , mBlames(MAX_CACHED_LINES)
+{
+   if (mOnDisk)
+      pruneDisk();
+}
+
+bool BlameCache::find(const QString &file, const QString &sha, const QString &blobId, Blame &blame)
+{
+   const auto key = getKey(file, sha, blobId);
+
+   if (const auto cached = mBlames.object(key))
+   {
+      blame = *cached;
+      return true;
+   }
+
+   if (mOnDisk && load(key, blame))
+   {
+      mBlames.insert(key, new Blame(blame), std::max(1, blame.lineCommits.count()));
+      return true;
+   }
+
+   return false;
+}
+
+void BlameCache::insert(const QString &file, const QString &sha, const QString &blobId, const Blame &blame)
+{
+   const auto key = getKey(file, sha, blobId);
+
+   mBlames.insert(key, new Blame(blame), std::max(1, blame.lineCommits.count()));
+
+   if (mOnDisk)
+      save(key, blame);
+}
+
+QString BlameCache::getKey(const QString &file, const QString &sha, const QString &blobId)
+{
+   return QString("%1:%2:%3").arg(sha, blobId, file);
+}
+
+QString BlameCache::getFilePath(const QString &key) const
+{
+   return QString("%1/%2/%3.blame")
+       .arg(getBlamesDir(), QString::fromLatin1(hashKey(mRepoPath)), QString::fromLatin1(hashKey(key)));
+}
+
+bool BlameCache::load(const QString &key, Blame &blame) const
+{
+   BenchmarkStart();
+
+   QFile file(getFilePath(key));
+
+   if (!file.exists() || !file.open(QIODevice::ReadOnly))
+   {
+      BenchmarkEnd();
+      return false;
+   }
+
+   QDataStream stream(&file);
+   stream.setVersion(QDataStream::Qt_5_9);
+
+   quint32 magic = 0;
+   quint32 version = 0;
+   QString storedKey;
+   qint32 commitsCount = 0;
+
+   stream >> magic >> version >> storedKey >> commitsCount;
+
+   if (stream.status() != QDataStream::Ok || magic != BLAME_MAGIC || version != BLAME_VERSION || storedKey != key
+       || commitsCount < 0)
+   {
+      QLog_Info("Git", QString("The blame {%1} has an old format and will be discarded.").arg(file.fileName()));
+
+      BenchmarkEnd();
+      return false;
+   }
+
+   Blame stored;
+   stored.commits.reserve(commitsCount);
+
+   for (auto i = 0; i < commitsCount; ++i)
+   {
+      Commit commit;
+      commit.sha = readText(stream);
+      commit.author = readText(stream);
+
+      qint64 secsSinceEpoch = 0;
+      stream >> secsSinceEpoch;
+
+      commit.dateTime = QDateTime::fromSecsSinceEpoch(secsSinceEpoch);
+      commit.title = readText(stream);
+
+      stored.commits.append(commit);
+   }
+
+   stream >> stored.lineCommits;
+
+   const auto isValid = std::all_of(stored.lineCommits.cbegin(), stored.lineCommits.cend(),
+                                    [commitsCount](int commit) { return commit >= 0 && commit < commitsCount; });
+
+   if (stream.status() != QDataStream::Ok || !isValid)
+   {
+      QLog_Warning("Git", QString("The blame {%1} is corrupted and will be discarded.").arg(file.fileName()));
+
+      BenchmarkEnd();
+      return false;
+   }
+
+   blame = stored;
+
+   BenchmarkEnd();
+
+   return true;
+}
+
+void BlameCache::save(const QString &key, const Blame &blame)
+{
+   BenchmarkStart();
+
+   QByteArray data;
+   QDataStream stream(&data, QIODevice::WriteOnly);
+   stream.setVersion(QDataStream::Qt_5_9);
+
+   stream << BLAME_MAGIC << BLAME_VERSION << key << static_cast<qint32>(blame.commits.count());
+
+   for (const auto &commit : blame.commits)
+   {
+      stream << commit.sha.toUtf8() << commit.author.toUtf8();
+      stream << static_cast<qint64>(commit.dateTime.toSecsSinceEpoch());
+      stream << commit.title.toUtf8();
+   }
+
+   stream << blame.lineCommits;
+
+   const auto filePath = getFilePath(key);
+   QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+   QSaveFile file(filePath);
+
+   if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+      QLog_Warning("Git", QString("The blame {%1} couldn't be saved.").arg(filePath));
+
+   if (++mSavesSincePrune >= PRUNE_INTERVAL)
+   {
+      mSavesSincePrune = 0;
+      pruneDisk();
+   }
+
+   BenchmarkEnd();
+}
+
+void BlameCache::pruneDisk()
+{
+   BenchmarkStart();
+
+   QVector<QFileInfo> blames;
+   qint64 totalSize = 0;
+   QDirIterator iter(getBlamesDir(), { "*.blame" }, QDir::Files, QDirIterator::Subdirectories);
+
+   while (iter.hasNext())
+   {
+      iter.next();
+
+      blames.append(iter.fileInfo());
+      totalSize += blames.constLast().size();
+   }
+
+   if (totalSize > MAX_DISK_BYTES)
+   {
+      std::sort(blames.begin(), blames.end(), [](const QFileInfo &first, const QFileInfo &second) {
+         return first.lastModified() < second.lastModified();
+      });
+
+      auto removed = 0;
+
+      for (auto i = 0; i < blames.count() && totalSize > MAX_DISK_BYTES; ++i)
+      {
+         if (QFile::remove(blames.at(i).absoluteFilePath()))
+         {
+            totalSize -= blames.at(i).size();
+            ++removed;
+         }
+      }
+
+      QLog_Info("Git", QString("Removed {%1} blames from the disk cache.").arg(removed));
+   }
+
+   BenchmarkEnd();
+}
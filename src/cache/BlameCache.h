@@ -0,0 +1,109 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+#include <QCache>
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The BlameCache class keeps the blames of the files of a repository so they are not calculated again when a
+ * file is reopened.
+ *
+ * A blame is identified by the path of the file, the last commit that modified the file and the SHA of the blob of
+ * the file in that commit. Since the blame doesn't change until the file is modified again, the blame of any later
+ * commit is the same. The blob alone is not enough: a revert or a cherry-pick brings back the content of an older
+ * commit, but its lines are credited to the new commit, so the same content can have different blames. The blames
+ * are kept in memory up to a number of lines and optionally stored on disk, so they are also reused in the next
+ * sessions. The blames on disk are shared by all the repositories and limited to MAX_DISK_BYTES: the oldest ones are
+ * removed first.
+ *
+ * The class is not thread-safe: the owner is in charge of the synchronization.
+ */
+class BlameCache
+{
+public:
+   /**
+    * @brief The Commit struct contains the information of a commit that appears in a blame.
+    */
+   struct Commit
+   {
+      QString sha;
+      QString author;
+      QDateTime dateTime;
+      QString title;
+   };
+
+   /**
+    * @brief The Blame struct contains the commits that appear in a blame and the index of the commit of every line.
+    */
+   struct Blame
+   {
+      QVector<Commit> commits;
+      QVector<int> lineCommits;
+   };
+
+   /**
+    * @brief Creates the cache.
+    * @param repoPath The path of the repository, used to separate the blames stored on disk.
+    * @param onDisk Stores the blames on disk when true.
+    */
+   explicit BlameCache(const QString &repoPath, bool onDisk);
+
+   /**
+    * @brief Finds the blame of a file, loading it from the disk if it's not in memory.
+    * @param file The path of the file relative to the repository.
+    * @param sha The SHA of the last commit that modified the file.
+    * @param blobId The SHA of the blob of the file in that commit.
+    * @param blame The blame found.
+    * @return True if the blame was found, otherwise false.
+    */
+   bool find(const QString &file, const QString &sha, const QString &blobId, Blame &blame);
+   /**
+    * @brief Stores the blame of a file.
+    * @param file The path of the file relative to the repository.
+    * @param sha The SHA of the last commit that modified the file.
+    * @param blobId The SHA of the blob of the file in that commit.
+    * @param blame The blame.
+    */
+   void insert(const QString &file, const QString &sha, const QString &blobId, const Blame &blame);
+
+   static constexpr int MAX_CACHED_LINES = 1000000;
+   static constexpr qint64 MAX_DISK_BYTES = 256 * 1024 * 1024;
+
+private:
+   QString mRepoPath;
+   bool mOnDisk = false;
+   QCache<QString, Blame> mBlames;
+   int mSavesSincePrune = 0;
+
+   static QString getKey(const QString &file, const QString &sha, const QString &blobId);
+   QString getFilePath(const QString &key) const;
+   bool load(const QString &key, Blame &blame) const;
+   void save(const QString &key, const Blame &blame);
+   /**
+    * @brief Removes the oldest blames stored on disk until they fit in MAX_DISK_BYTES.
+    */
+   static void pruneDisk();
+};
@@ -1,18 +1,36 @@
 INCLUDEPATH += $$PWD
 
 HEADERS += \
+    $$PWD/BlameCache.h \
+    $$PWD/CacheSnapshot.h \
     $$PWD/CommitInfo.h \
+    $$PWD/CommitStore.h \
     $$PWD/Lane.h \
     $$PWD/LaneType.h \
+    $$PWD/LegacyLanes.h \
+    $$PWD/ObjectId.h \
+    $$PWD/PathTable.h \
     $$PWD/References.h \
     $$PWD/RevisionFiles.h \
+    $$PWD/RevisionFilesCache.h \
     $$PWD/RevisionsCache.h \
+    $$PWD/SearchIndex.h \
+    $$PWD/WorkTreeStatus.h \
     $$PWD/lanes.h
 
 SOURCES += \
+    $$PWD/BlameCache.cpp \
+    $$PWD/CacheSnapshot.cpp \
     $$PWD/CommitInfo.cpp \
+    $$PWD/CommitStore.cpp \
     $$PWD/Lane.cpp \
+    $$PWD/LegacyLanes.cpp \
+    $$PWD/ObjectId.cpp \
+    $$PWD/PathTable.cpp \
     $$PWD/References.cpp \
     $$PWD/RevisionFiles.cpp \
+    $$PWD/RevisionFilesCache.cpp \
     $$PWD/RevisionsCache.cpp \
+    $$PWD/SearchIndex.cpp \
+    $$PWD/WorkTreeStatus.cpp \
     $$PWD/lanes.cpp
@@ -0,0 +1,712 @@
+#include "CacheSnapshot.h"
+
+#include <RevisionsCache.h>
+#include <LaneType.h>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <QLogger.h>
+#include <BenchmarkTool.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace QLogger;
+using namespace GitQlientTools;
+
+static const quint32 SNAPSHOT_MAGIC = 0x47515348; // "GQSH"
+static const quint32 SNAPSHOT_VERSION = 4;
+// Above this amount of segments the snapshot is written again from scratch.
+static const int MAX_SNAPSHOT_SEGMENTS = 16;
+
+// The file is memory-mapped and the arrays are copied from it as they are, so the layout must only change together
+// with SNAPSHOT_VERSION. The numbers use the byte order of the machine: in a different one the magic doesn't match.
+// header: FileHeader, repo path
+// segment: SegmentHeader, the columns of the new commits (SHAs, boundaries, committers, authors, dates, text offsets,
+// subject and body sizes), the texts, the new people (sizes and UTF-8 names), the parents (offsets, counts and SHAs),
+// the new rows, the lanes of the rows that changed (ids, counts and types), the tips and the lanes state (the lanes
+// after the last commit and the checkpoints used for the incremental updates).
+// Every array starts at a multiple of 8 bytes.
+
+namespace
+{
+struct FileHeader
+{
+   quint32 magic = SNAPSHOT_MAGIC;
+   quint32 version = SNAPSHOT_VERSION;
+   quint8 showAll = 0;
+   quint8 lazyGraph = 0;
+   quint16 reserved = 0;
+   qint32 repoPathSize = 0;
+};
+
+struct SegmentHeader
+{
+   qint64 size = 0; // Including the header.
+   qint32 firstCommit = 0;
+   qint32 commits = 0;
+   qint32 firstPerson = 0;
+   qint32 people = 0;
+   qint32 peopleBytes = 0;
+   qint32 firstEdge = 0;
+   qint32 edges = 0;
+   qint32 firstText = 0;
+   qint32 textsSize = 0;
+   qint32 rows = 0;
+   qint32 laneRows = 0;
+   qint32 laneBytes = 0;
+   qint32 tipsSize = 0;
+   qint32 lanesStateSize = 0;
+};
+
+static_assert(sizeof(FileHeader) % 8 == 0 && sizeof(SegmentHeader) % 8 == 0, "The headers must keep the alignment");
+
+struct Segment
+{
+   SegmentHeader header;
+   const char *shas = nullptr;
+   const char *boundaries = nullptr;
+   const char *committers = nullptr;
+   const char *authors = nullptr;
+   const char *dates = nullptr;
+   const char *textOffsets = nullptr;
+   const char *shortLogSizes = nullptr;
+   const char *longLogSizes = nullptr;
+   const char *texts = nullptr;
+   const char *peopleSizes = nullptr;
+   const char *people = nullptr;
+   const char *parentsOffset = nullptr;
+   const char *parentsCount = nullptr;
+   const char *parentShas = nullptr;
+   const char *rows = nullptr;
+   const char *laneIds = nullptr;
+   const char *laneCounts = nullptr;
+   const char *laneTypes = nullptr;
+   const char *tips = nullptr;
+   const char *lanesState = nullptr;
+};
+
+class SnapshotReader
+{
+public:
+   SnapshotReader(const uchar *data, qint64 size, qint64 pos)
+      : mData(reinterpret_cast<const char *>(data))
+      , mSize(size)
+      , mPos(pos)
+   {
+   }
+
+   const char *read(qint64 size)
+   {
+      if (!mOk || size < 0 || mPos + size > mSize)
+      {
+         mOk = false;
+         return nullptr;
+      }
+
+      const auto data = mData + mPos;
+      mPos += (size + 7) / 8 * 8;
+
+      return data;
+   }
+
+   bool isOk() const { return mOk; }
+   qint64 pos() const { return mPos; }
+
+private:
+   const char *mData = nullptr;
+   qint64 mSize = 0;
+   qint64 mPos = 0;
+   bool mOk = true;
+};
+
+void writeRaw(QByteArray &data, const void *raw, qint64 size)
+{
+   data.append(static_cast<const char *>(raw), static_cast<int>(size));
+   data.append((8 - data.size() % 8) % 8, '\0');
+}
+
+template <typename T>
+void writeArray(QByteArray &data, const T *values, int count)
+{
+   writeRaw(data, values, static_cast<qint64>(sizeof(T)) * count);
+}
+
+template <typename T>
+T readValue(const char *array, int index)
+{
+   T value;
+   memcpy(&value, array + sizeof(T) * static_cast<size_t>(index), sizeof(T));
+
+   return value;
+}
+
+template <typename T>
+void appendColumn(QVector<T> &column, const char *array, int count)
+{
+   const auto size = column.size();
+
+   column.resize(size + count);
+   memcpy(column.data() + size, array, sizeof(T) * static_cast<size_t>(count));
+}
+
+bool readSegment(const uchar *data, qint64 size, qint64 pos, Segment &segment)
+{
+   if (pos + static_cast<qint64>(sizeof(SegmentHeader)) > size)
+      return false;
+
+   auto &header = segment.header;
+   memcpy(&header, data + pos, sizeof(SegmentHeader));
+
+   if (header.size < static_cast<qint64>(sizeof(SegmentHeader)) || pos + header.size > size || header.commits < 0
+       || header.edges < 0 || header.people < 0 || header.rows < 0 || header.laneRows < 0)
+   {
+      return false;
+   }
+
+   // The arrays can't go beyond the segment.
+   SnapshotReader reader(data, pos + header.size, pos + sizeof(SegmentHeader));
+   const qint64 commits = header.commits;
+
+   segment.shas = reader.read(commits * ObjectId::SIZE);
+   segment.boundaries = reader.read(commits);
+   segment.committers = reader.read(commits * sizeof(qint32));
+   segment.authors = reader.read(commits * sizeof(qint32));
+   segment.dates = reader.read(commits * sizeof(qint64));
+   segment.textOffsets = reader.read(commits * sizeof(qint32));
+   segment.shortLogSizes = reader.read(commits * sizeof(qint32));
+   segment.longLogSizes = reader.read(commits * sizeof(qint32));
+   segment.texts = reader.read(header.textsSize);
+   segment.peopleSizes = reader.read(static_cast<qint64>(header.people) * sizeof(qint32));
+   segment.people = reader.read(header.peopleBytes);
+   segment.parentsOffset = reader.read(commits * sizeof(qint32));
+   segment.parentsCount = reader.read(commits * sizeof(quint16));
+   segment.parentShas = reader.read(static_cast<qint64>(header.edges) * ObjectId::SIZE);
+   segment.rows = reader.read(static_cast<qint64>(header.rows) * sizeof(qint32));
+   segment.laneIds = reader.read(static_cast<qint64>(header.laneRows) * sizeof(qint32));
+   segment.laneCounts = reader.read(static_cast<qint64>(header.laneRows) * sizeof(quint16));
+   segment.laneTypes = reader.read(header.laneBytes);
+   segment.tips = reader.read(header.tipsSize);
+   segment.lanesState = reader.read(header.lanesStateSize);
+
+   return reader.isOk();
+}
+
+bool isConsistent(const Segment &segment, int people, int textsSize, int edges)
+{
+   const auto &header = segment.header;
+
+   for (auto i = 0; i < header.commits; ++i)
+   {
+      const auto committer = readValue<qint32>(segment.committers, i);
+      const auto author = readValue<qint32>(segment.authors, i);
+      const auto textOffset = readValue<qint32>(segment.textOffsets, i);
+      const auto textSize
+          = qint64(readValue<qint32>(segment.shortLogSizes, i)) + readValue<qint32>(segment.longLogSizes, i);
+      const auto parentsOffset = readValue<qint32>(segment.parentsOffset, i);
+
+      if (committer < 0 || committer >= people || author < 0 || author >= people || textOffset < 0
+          || textOffset + textSize > textsSize || parentsOffset < 0
+          || parentsOffset + readValue<quint16>(segment.parentsCount, i) > edges)
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+void writeLanes(QDataStream &stream, const Lanes &lanes)
+{
+   const auto types = lanes.getLanes();
+   const auto nextShas = lanes.getNextShas();
+
+   stream << static_cast<qint16>(lanes.getActiveLane()) << static_cast<quint16>(types.count());
+
+   for (auto i = 0; i < types.count(); ++i)
+   {
+      stream << static_cast<quint8>(types.at(i).getType());
+      stream.writeRawData(reinterpret_cast<const char *>(nextShas.at(i).bytes), ObjectId::SIZE);
+   }
+}
+
+Lanes readLanes(QDataStream &stream)
+{
+   qint16 activeLane = 0;
+   quint16 count = 0;
+   stream >> activeLane >> count;
+
+   QVector<Lane> types;
+   QVector<ObjectId> nextShas(count);
+   types.reserve(count);
+
+   for (auto i = 0; i < count; ++i)
+   {
+      quint8 type = 0;
+      stream >> type;
+      stream.readRawData(reinterpret_cast<char *>(nextShas[i].bytes), ObjectId::SIZE);
+
+      types.append(Lane(static_cast<LaneType>(type)));
+   }
+
+   Lanes lanes;
+   lanes.restore(activeLane, types, nextShas);
+
+   return lanes;
+}
+}
+
+CacheSnapshot::CacheSnapshot(const QString &repoPath, bool showAll, bool lazyGraph)
+   : mRepoPath(repoPath)
+   , mShowAll(showAll)
+   , mLazyGraph(lazyGraph)
+{
+}
+
+CacheSnapshot::~CacheSnapshot()
+{
+   close();
+}
+
+bool CacheSnapshot::open()
+{
+   close();
+
+   mFile.setFileName(getFilePath());
+
+   if (!mFile.exists() || !mFile.open(QIODevice::ReadOnly))
+      return false;
+
+   mSize = mFile.size();
+   mData = mSize > 0 ? mFile.map(0, mSize) : nullptr;
+
+   if (!mData)
+   {
+      QLog_Warning("Git", QString("The snapshot {%1} couldn't be mapped.").arg(mFile.fileName()));
+      close();
+      return false;
+   }
+
+   FileHeader header;
+
+   if (mSize >= static_cast<qint64>(sizeof(FileHeader)))
+      memcpy(&header, mData, sizeof(FileHeader));
+
+   if (mSize < static_cast<qint64>(sizeof(FileHeader)) || header.magic != SNAPSHOT_MAGIC
+       || header.version != SNAPSHOT_VERSION)
+   {
+      QLog_Info("Git", QString("The snapshot {%1} has an old format and will be discarded.").arg(mFile.fileName()));
+      close();
+      return false;
+   }
+
+   SnapshotReader reader(mData, mSize, sizeof(FileHeader));
+   const auto repoPath = reader.read(header.repoPathSize);
+
+   if (!reader.isOk() || QString::fromUtf8(repoPath, header.repoPathSize) != mRepoPath
+       || (header.showAll != 0) != mShowAll || (header.lazyGraph != 0) != mLazyGraph)
+   {
+      close();
+      return false;
+   }
+
+   // A segment that was not completely written is ignored together with anything after it.
+   Segment segment;
+
+   for (auto pos = reader.pos(); readSegment(mData, mSize, pos, segment); pos += segment.header.size)
+   {
+      if (segment.header.firstCommit != mCommitsCount)
+         break;
+
+      mSegments.append(pos);
+      mCommitsCount += segment.header.commits;
+      mTips = QByteArray(segment.tips, segment.header.tipsSize);
+   }
+
+   if (mSegments.isEmpty())
+   {
+      close();
+      return false;
+   }
+
+   return true;
+}
+
+void CacheSnapshot::close()
+{
+   if (mData)
+   {
+      mFile.unmap(mData);
+      mData = nullptr;
+   }
+
+   mFile.close();
+   mSize = 0;
+   mTips.clear();
+   mCommitsCount = 0;
+   mSegments.clear();
+}
+
+bool CacheSnapshot::restore(RevisionsCache &cache)
+{
+   BenchmarkStart();
+
+   if (!mData)
+   {
+      BenchmarkEnd();
+      return false;
+   }
+
+   QLog_Debug("Git", QString("Restoring {%1} revisions from {%2} snapshot segments.")
+                         .arg(mCommitsCount)
+                         .arg(mSegments.count()));
+
+   QMutexLocker lock(&cache.mMutex);
+
+   auto &store = cache.mStore;
+   auto success = store.count() == 0;
+   QVector<Segment> segments;
+
+   store.reserve(mCommitsCount);
+
+   for (auto offset : qAsConst(mSegments))
+   {
+      Segment segment;
+      const auto &header = segment.header;
+
+      if (!success || !readSegment(mData, mSize, offset, segment) || header.firstCommit != store.count()
+          || header.firstPerson != store.mPeople.count() || header.firstEdge != store.mParentShas.count()
+          || header.firstText != store.mTexts.size()
+          || !isConsistent(segment, header.firstPerson + header.people, header.firstText + header.textsSize,
+                           header.firstEdge + header.edges))
+      {
+         success = false;
+         break;
+      }
+
+      // The columns are copied as they are, only the people and the links between commits are built again.
+      appendColumn(store.mShas, segment.shas, header.commits);
+      store.mBoundaries.append(segment.boundaries, header.commits);
+      appendColumn(store.mCommitters, segment.committers, header.commits);
+      appendColumn(store.mAuthors, segment.authors, header.commits);
+      appendColumn(store.mDates, segment.dates, header.commits);
+      appendColumn(store.mTextOffsets, segment.textOffsets, header.commits);
+      appendColumn(store.mShortLogSizes, segment.shortLogSizes, header.commits);
+      appendColumn(store.mLongLogSizes, segment.longLogSizes, header.commits);
+      store.mTexts.append(segment.texts, header.textsSize);
+      appendColumn(store.mParentsOffset, segment.parentsOffset, header.commits);
+      appendColumn(store.mParentsCount, segment.parentsCount, header.commits);
+      appendColumn(store.mParentShas, segment.parentShas, header.edges);
+      store.mParents.insert(store.mParents.size(), header.edges, -1);
+      store.mNextSiblings.insert(store.mNextSiblings.size(), header.edges, -1);
+      store.mFirstChilds.insert(store.mFirstChilds.size(), header.commits, -1);
+      store.mLanesOffset.insert(store.mLanesOffset.size(), header.commits, store.mLanes.size());
+      store.mLanesCount.insert(store.mLanesCount.size(), header.commits, 0);
+
+      for (auto i = 0, personOffset = 0; i < header.people; ++i)
+      {
+         const auto size = readValue<qint32>(segment.peopleSizes, i);
+
+         if (size < 0 || personOffset + size > header.peopleBytes)
+         {
+            success = false;
+            break;
+         }
+
+         const auto person = QString::fromUtf8(segment.people + personOffset, size);
+
+         store.mPeopleIds.insert(person, store.mPeople.count());
+         store.mPeople.append(person);
+         personOffset += size;
+      }
+
+      for (auto id = header.firstCommit; success && id < store.count(); ++id)
+         store.linkCommit(id);
+
+      for (auto i = 0, laneOffset = 0; success && i < header.laneRows; ++i)
+      {
+         const auto id = readValue<qint32>(segment.laneIds, i);
+         const auto count = readValue<quint16>(segment.laneCounts, i);
+
+         if (id < 0 || id >= store.count() || laneOffset + count > header.laneBytes)
+         {
+            success = false;
+            break;
+         }
+
+         memcpy(store.allocateLanes(id, count), segment.laneTypes + laneOffset, count);
+         laneOffset += count;
+      }
+
+      segments.append(segment);
+   }
+
+   // Every segment has the rows of its commits, which were prepended to the rows of the previous ones.
+   cache.mRowsById.fill(-1, store.count());
+
+   for (auto i = segments.count() - 1; success && i >= 0; --i)
+   {
+      const auto &segment = segments.at(i);
+
+      for (auto j = 0; j < segment.header.rows; ++j)
+      {
+         const auto id = readValue<qint32>(segment.rows, j);
+
+         if (id < 0 || id >= store.count() || cache.mRowsById.at(id) != -1)
+         {
+            success = false;
+            break;
+         }
+
+         cache.mRowsById[id] = cache.mRows.count();
+         cache.mRows.append(id);
+      }
+   }
+
+   success = success && cache.mRows.count() == store.count();
+
+   // Without the checkpoints the first incremental update would recalculate the lanes of the whole history.
+   if (success)
+   {
+      const auto &header = segments.constLast().header;
+      const auto lanesState = QByteArray::fromRawData(segments.constLast().lanesState, header.lanesStateSize);
+      QDataStream stream(lanesState);
+      stream.setVersion(QDataStream::Qt_5_9);
+
+      cache.mLanes = readLanes(stream);
+
+      qint32 checkpointsCount = 0;
+      stream >> checkpointsCount;
+
+      for (auto i = 0; i < checkpointsCount && stream.status() == QDataStream::Ok; ++i)
+      {
+         qint32 row = 0;
+         stream >> row;
+
+         cache.mLaneCheckpoints.insert(row, readLanes(stream));
+      }
+
+      success = stream.status() == QDataStream::Ok;
+   }
+
+   if (success)
+   {
+      cache.mSnapshotCommits = store.count();
+      cache.mSnapshotLaneRows = 0;
+   }
+   else
+   {
+      QLog_Warning("Git", QString("The snapshot {%1} is corrupted.").arg(mFile.fileName()));
+
+      // The cache is left as it was, with only the WIP.
+      store.clear();
+      cache.mRows.clear();
+      cache.mRowsById.clear();
+      cache.mLanes.clear();
+      cache.mLaneCheckpoints.clear();
+   }
+
+   cache.markUpdated();
+
+   BenchmarkEnd();
+
+   return success;
+}
+
+bool CacheSnapshot::save(RevisionsCache &cache, const QByteArray &tips)
+{
+   BenchmarkStart();
+
+   CommitStore store;
+   QVector<int> rows;
+   Lanes lanes;
+   decltype(cache.mLaneCheckpoints) checkpoints;
+   auto savedCommits = -1;
+   auto changedLaneRows = 0;
+
+   {
+      // The containers are implicitly shared: copying them is cheap and the cache is not locked while serializing.
+      QMutexLocker lock(&cache.mMutex);
+
+      store = cache.mStore;
+      rows = cache.mRows;
+      lanes = cache.mLanes;
+      checkpoints = cache.mLaneCheckpoints;
+      savedCommits = cache.mSnapshotCommits;
+      changedLaneRows = cache.mSnapshotLaneRows;
+   }
+
+   // The commits added by an incremental update are at the top of the graph. They are appended in a new segment
+   // unless the file is not the one the cache was restored from or saved to.
+   auto firstCommit = 0;
+
+   if (savedCommits > 0 && savedCommits <= store.count() && open() && mCommitsCount == savedCommits
+       && mSegments.count() < MAX_SNAPSHOT_SEGMENTS)
+   {
+      const auto newRows = store.count() - savedCommits;
+      const auto isNewRow = [savedCommits](int id) { return id >= savedCommits; };
+
+      if (std::all_of(rows.cbegin(), rows.cbegin() + newRows, isNewRow))
+         firstCommit = savedCommits;
+   }
+
+   close();
+
+   const auto append = firstCommit > 0;
+   const auto repoPath = mRepoPath.toUtf8();
+   QByteArray data;
+
+   if (!append)
+   {
+      FileHeader fileHeader;
+      fileHeader.showAll = mShowAll ? 1 : 0;
+      fileHeader.lazyGraph = mLazyGraph ? 1 : 0;
+      fileHeader.repoPathSize = repoPath.size();
+
+      writeRaw(data, &fileHeader, sizeof(FileHeader));
+      writeRaw(data, repoPath.constData(), repoPath.size());
+   }
+
+   // The people are interned in the order of the commits, so the ones of the previous segments are the people
+   // referenced by their commits.
+   auto firstPerson = 0;
+
+   for (auto id = 0; id < firstCommit; ++id)
+      firstPerson = std::max({ firstPerson, store.mCommitters.at(id) + 1, store.mAuthors.at(id) + 1 });
+
+   QVector<qint32> peopleSizes;
+   QByteArray people;
+
+   for (auto i = firstPerson; i < store.mPeople.count(); ++i)
+   {
+      const auto person = store.mPeople.at(i).toUtf8();
+
+      peopleSizes.append(person.size());
+      people.append(person);
+   }
+
+   // Only the rows whose lanes changed are written. The lazy graph mode doesn't store the lanes of the commits.
+   const auto laneRows = mLazyGraph ? 0 : std::min(append ? changedLaneRows : rows.count(), rows.count());
+   QVector<qint32> laneIds;
+   QVector<quint16> laneCounts;
+   QByteArray laneTypes;
+
+   for (auto row = 0; row < laneRows; ++row)
+   {
+      const auto id = rows.at(row);
+      const auto count = store.mLanesCount.at(id);
+
+      laneIds.append(id);
+      laneCounts.append(count);
+      laneTypes.append(store.mLanes.constData() + store.mLanesOffset.at(id), count);
+   }
+
+   QByteArray lanesState;
+   QDataStream stream(&lanesState, QIODevice::WriteOnly);
+   stream.setVersion(QDataStream::Qt_5_9);
+
+   writeLanes(stream, lanes);
+
+   stream << static_cast<qint32>(checkpoints.count());
+
+   for (auto iter = checkpoints.constBegin(); iter != checkpoints.constEnd(); ++iter)
+   {
+      stream << static_cast<qint32>(iter.key());
+      writeLanes(stream, iter.value());
+   }
+
+   const auto commits = store.count() - firstCommit;
+   const auto hasCommits = commits > 0;
+
+   SegmentHeader header;
+   header.firstCommit = firstCommit;
+   header.commits = commits;
+   header.firstPerson = firstPerson;
+   header.people = peopleSizes.count();
+   header.peopleBytes = people.size();
+   header.firstEdge = hasCommits ? store.mParentsOffset.at(firstCommit) : store.mParentShas.count();
+   header.edges = store.mParentShas.count() - header.firstEdge;
+   header.firstText = hasCommits ? store.mTextOffsets.at(firstCommit) : store.mTexts.size();
+   header.textsSize = store.mTexts.size() - header.firstText;
+   header.rows = commits;
+   header.laneRows = laneIds.count();
+   header.laneBytes = laneTypes.size();
+   header.tipsSize = tips.size();
+   header.lanesStateSize = lanesState.size();
+
+   const auto segmentOffset = data.size();
+
+   writeRaw(data, &header, sizeof(SegmentHeader));
+   writeArray(data, store.mShas.constData() + firstCommit, commits);
+   writeArray(data, store.mBoundaries.constData() + firstCommit, commits);
+   writeArray(data, store.mCommitters.constData() + firstCommit, commits);
+   writeArray(data, store.mAuthors.constData() + firstCommit, commits);
+   writeArray(data, store.mDates.constData() + firstCommit, commits);
+   writeArray(data, store.mTextOffsets.constData() + firstCommit, commits);
+   writeArray(data, store.mShortLogSizes.constData() + firstCommit, commits);
+   writeArray(data, store.mLongLogSizes.constData() + firstCommit, commits);
+   writeRaw(data, store.mTexts.constData() + header.firstText, header.textsSize);
+   writeArray(data, peopleSizes.constData(), peopleSizes.count());
+   writeRaw(data, people.constData(), people.size());
+   writeArray(data, store.mParentsOffset.constData() + firstCommit, commits);
+   writeArray(data, store.mParentsCount.constData() + firstCommit, commits);
+   writeArray(data, store.mParentShas.constData() + header.firstEdge, header.edges);
+   writeArray(data, rows.constData(), commits);
+   writeArray(data, laneIds.constData(), laneIds.count());
+   writeArray(data, laneCounts.constData(), laneCounts.count());
+   writeRaw(data, laneTypes.constData(), laneTypes.size());
+   writeRaw(data, tips.constData(), tips.size());
+   writeRaw(data, lanesState.constData(), lanesState.size());
+
+   header.size = data.size() - segmentOffset;
+   memcpy(data.data() + segmentOffset, &header, sizeof(SegmentHeader));
+
+   const auto filePath = getFilePath();
+   auto success = false;
+
+   if (append)
+   {
+      QFile file(filePath);
+      success = file.open(QIODevice::WriteOnly | QIODevice::Append) && file.write(data) == data.size();
+   }
+   else
+   {
+      QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+      QSaveFile file(filePath);
+      success = file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit();
+   }
+
+   {
+      QMutexLocker lock(&cache.mMutex);
+
+      // If the file couldn't be written, the next save writes it from scratch.
+      cache.mSnapshotCommits = success ? store.count() : -1;
+      cache.mSnapshotLaneRows = 0;
+   }
+
+   if (success)
+      QLog_Debug("Git", QString("Snapshot saved in {%1} with {%2} new revisions.").arg(filePath).arg(commits));
+   else
+      QLog_Warning("Git", QString("The snapshot {%1} couldn't be saved.").arg(filePath));
+
+   BenchmarkEnd();
+
+   return success;
+}
+
+QString CacheSnapshot::getFilePath() const
+{
+   const auto key
+       = QCryptographicHash::hash(QString("%1:%2:%3").arg(mRepoPath).arg(mShowAll).arg(mLazyGraph).toUtf8(),
+                                  QCryptographicHash::Sha1)
+             .toHex();
+
+   return QString("%1/snapshots/%2.snapshot")
+       .arg(QStandardPaths::writableLocation(QStandardPaths::CacheLocation), QString::fromLatin1(key));
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QFile>
+#include <QVector>
+
+class RevisionsCache;
+
+/**
+ * @brief The CacheSnapshot class persists the commits of the RevisionsCache between sessions. The file has a fixed
+ * layout: a header followed by segments, where every segment stores the columns of the CommitStore for the commits
+ * added since the previous one as raw arrays. Restoring copies the arrays in bulk instead of decoding the commits.
+ *
+ * After an incremental update only a new segment is appended. The file is written again from scratch after a full
+ * load or when it has too many segments.
+ */
+class CacheSnapshot
+{
+public:
+   explicit CacheSnapshot(const QString &repoPath, bool showAll, bool lazyGraph);
+   ~CacheSnapshot();
+
+   /**
+    * @brief Maps the snapshot file and validates its header and its segments.
+    * @return True if there is a valid snapshot, otherwise false.
+    */
+   bool open();
+   void close();
+   /**
+    * @brief Gets the HEAD and the show-ref output the snapshot was saved with.
+    * @return The tips.
+    */
+   QByteArray getTips() const { return mTips; }
+   /**
+    * @brief Restores the commits into an empty cache.
+    * @param cache The cache, with only the WIP.
+    * @return True if the snapshot was restored, otherwise false.
+    */
+   bool restore(RevisionsCache &cache);
+   /**
+    * @brief Saves the commits of the cache. If the snapshot already contains the first commits of the cache, only the
+    * new ones are appended.
+    *
+    * @param cache The cache.
+    * @param tips The HEAD and the show-ref output the cache was loaded with.
+    * @return True if the snapshot was saved, otherwise false.
+    */
+   bool save(RevisionsCache &cache, const QByteArray &tips);
+
+private:
+   QString mRepoPath;
+   bool mShowAll = true;
+   bool mLazyGraph = false;
+   QFile mFile;
+   uchar *mData = nullptr;
+   qint64 mSize = 0;
+   QByteArray mTips;
+   qint32 mCommitsCount = 0;
+   // The offsets of the segments in the file.
+   QVector<qint64> mSegments;
+
+   QString getFilePath() const;
+};
@@ -2,6 +2,8 @@
 
 #include <QStringList>
 
+#include <algorithm>
+
 const QString CommitInfo::ZERO_SHA = QString("0000000000000000000000000000000000000000");
 
 CommitInfo::CommitInfo(const QString &sha, const QStringList &parents, const QString &author, long long secsSinceEpoch,
@@ -11,35 +13,58 @@ CommitInfo::CommitInfo(const QString &sha, const QStringList &parents, const QSt
    mParentsSha = parents;
    mCommitter = author;
    mAuthor = author;
-   mCommitDate = QDateTime::fromSecsSinceEpoch(secsSinceEpoch);
+   mCommitDate = secsSinceEpoch;
    mShortLog = log;
    mLongLog = longLog;
 }
 
+CommitInfo::CommitInfo(const QString &sha, const QStringList &parents, QChar boundaryInfo, const QString &committer,
+                       const QString &author, long long secsSinceEpoch, const QString &log, const QString &longLog)
+   : mBoundaryInfo(boundaryInfo)
+   , mSha(sha)
+   , mParentsSha(parents)
+   , mCommitter(committer)
+   , mAuthor(author)
+   , mCommitDate(secsSinceEpoch)
+   , mShortLog(log)
+   , mLongLog(longLog)
+{
+}
+
 CommitInfo::CommitInfo(const QByteArray &b)
 {
-   const auto fields = QString::fromUtf8(b).split('\n');
+   // The record is split as bytes and only the text fields are decoded, so this can run in parallel for many records.
+   const auto fields = b.split('\n');
 
-   if (fields.count() > 6)
+   if (fields.count() > 6 && !fields.at(1).isEmpty())
    {
-      auto combinedShas = fields.at(1);
-      auto sha = combinedShas.split('X').first();
-      mBoundaryInfo = sha.at(0);
-      sha.remove(0, 1);
-      mSha = sha;
-      combinedShas = combinedShas.remove(0, mSha.size() + 1 + 1);
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-      mParentsSha = combinedShas.trimmed().split(' ', Qt::SkipEmptyParts);
-#else
-      mParentsSha = combinedShas.trimmed().split(' ', QString::SkipEmptyParts);
-#endif
-      mCommitter = fields.at(2);
-      mAuthor = fields.at(3);
-      mCommitDate = QDateTime::fromSecsSinceEpoch(fields.at(4).toInt());
-      mShortLog = fields.at(5);
+      const auto &combinedShas = fields.at(1);
+      const auto separator = combinedShas.indexOf('X');
+      const auto shaEnd = separator == -1 ? combinedShas.size() : separator;
+
+      mBoundaryInfo = QLatin1Char(combinedShas.at(0));
+      mSha = QString::fromLatin1(combinedShas.mid(1, shaEnd - 1));
+
+      if (separator != -1)
+      {
+         for (const auto &parent : combinedShas.mid(separator + 1).trimmed().split(' '))
+         {
+            if (!parent.isEmpty())
+               mParentsSha.append(QString::fromLatin1(parent));
+         }
+      }
+
+      mCommitter = QString::fromUtf8(fields.at(2));
+      mAuthor = QString::fromUtf8(fields.at(3));
+      mCommitDate = fields.at(4).toLongLong();
+      mShortLog = QString::fromUtf8(fields.at(5));
+
+      QByteArray longLog;
 
       for (auto i = 6; i < fields.count(); ++i)
-         mLongLog += fields.at(i);
+         longLog += fields.at(i);
+
+      mLongLog = QString::fromUtf8(longLog);
    }
 }
 
@@ -81,9 +106,12 @@ QString CommitInfo::getFieldStr(CommitInfo::Field field) const
 
 bool CommitInfo::isValid() const
 {
-   QRegExp hexMatcher("^[0-9A-F]{40}$", Qt::CaseInsensitive);
+   const auto isHexDigit = [](QChar c) {
+      const auto value = c.unicode();
+      return (value >= '0' && value <= '9') || (value >= 'a' && value <= 'f') || (value >= 'A' && value <= 'F');
+   };
 
-   return !mSha.isEmpty() && hexMatcher.exactMatch(mSha);
+   return mSha.size() == 40 && std::all_of(mSha.cbegin(), mSha.cend(), isHexDigit);
 }
 
 int CommitInfo::getActiveLane() const
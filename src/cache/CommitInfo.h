@@ -47,12 +47,15 @@ public:
    CommitInfo() = default;
    explicit CommitInfo(const QString &sha, const QStringList &parents, const QString &author, long long secsSinceEpoch,
                        const QString &log, const QString &longLog = QString());
+   explicit CommitInfo(const QString &sha, const QStringList &parents, QChar boundaryInfo, const QString &committer,
+                       const QString &author, long long secsSinceEpoch, const QString &log, const QString &longLog);
    explicit CommitInfo(const QByteArray &b);
    bool operator==(const CommitInfo &commit) const;
    bool operator!=(const CommitInfo &commit) const;
 
    QString getFieldStr(CommitInfo::Field field) const;
    bool isBoundary() const { return mBoundaryInfo == '-'; }
+   QChar boundaryInfo() const { return mBoundaryInfo; }
    int parentsCount() const { return mParentsSha.count(); }
    QString parent(int idx) const { return mParentsSha.count() > idx ? mParentsSha.at(idx) : QString(); }
    QStringList parents() const { return mParentsSha; }
@@ -60,7 +63,8 @@ public:
    QString sha() const { return mSha; }
    QString committer() const { return mCommitter; }
    QString author() const { return mAuthor; }
-   QString authorDate() const { return QString::number(mCommitDate.toSecsSinceEpoch()); }
+   QString authorDate() const { return QString::number(mCommitDate); }
+   long long dateSinceEpoch() const { return mCommitDate; }
    QString shortLog() const { return mShortLog; }
    QString longLog() const { return mLongLog; }
    QString fullLog() const { return QString("%1\n\n%2").arg(mShortLog, mLongLog.trimmed()); }
@@ -77,11 +81,11 @@ public:
    void addReference(References::Type type, const QString &reference);
    void addReferences(const References &refs) { mReferences = refs; }
    QStringList getReferences(References::Type type) const { return mReferences.getReferences(type); }
+   References getAllReferences() const { return mReferences; }
    bool hasReferences() const { return !mReferences.isEmpty(); }
 
-   void addChildReference(CommitInfo *commit) { mChilds.insert(commit->sha(), commit); }
-   QList<CommitInfo *> getChilds() const { return mChilds.values(); }
-   bool hasChilds() const { return !mChilds.empty(); }
+   void setHasChilds(bool hasChilds) { mHasChilds = hasChilds; }
+   bool hasChilds() const { return mHasChilds; }
 
    void clearReferences() { mReferences.clear(); }
 
@@ -93,11 +97,10 @@ private:
    QStringList mParentsSha;
    QString mCommitter;
    QString mAuthor;
-   QDateTime mCommitDate;
+   long long mCommitDate = 0;
    QString mShortLog;
    QString mLongLog;
-   QString mDiff;
    QVector<Lane> mLanes;
    References mReferences;
-   QMap<QString, CommitInfo *> mChilds;
+   bool mHasChilds = false;
 };
@@ -0,0 +1,390 @@
+#include "CommitStore.h"
+
+#include <LaneType.h>
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+// The unused lane bytes that are tolerated before the lanes buffer is compacted.
+constexpr int MIN_UNUSED_LANE_BYTES = 64 * 1024;
+}
+
+bool CommitView::isValid() const
+{
+   return valid;
+}
+
+QString CommitView::getSha() const
+{
+   return isWip ? CommitInfo::ZERO_SHA : sha.toSha();
+}
+
+int CommitView::getActiveLane() const
+{
+   for (auto i = 0; i < lanes.count(); ++i)
+   {
+      if (Lane(static_cast<LaneType>(static_cast<quint8>(lanes.at(i)))).isActive())
+         return i;
+   }
+
+   return -1;
+}
+
+void CommitStore::clear()
+{
+   mShas.clear();
+   mBoundaries.clear();
+   mCommitters.clear();
+   mAuthors.clear();
+   mDates.clear();
+   mTextOffsets.clear();
+   mShortLogSizes.clear();
+   mLongLogSizes.clear();
+   mTexts.clear();
+   mPeople.clear();
+   mPeopleIds.clear();
+   mIds.clear();
+   mParentsOffset.clear();
+   mParentsCount.clear();
+   mParentShas.clear();
+   mParents.clear();
+   mNextSiblings.clear();
+   mFirstChilds.clear();
+   mPendingEdges.clear();
+   mLanesOffset.clear();
+   mLanesCount.clear();
+   mLanes.clear();
+   mLanesUsed = 0;
+   mReferences.clear();
+   mSortedIds.clear();
+}
+
+void CommitStore::reserve(int commits)
+{
+   mShas.reserve(commits);
+   mBoundaries.reserve(commits);
+   mCommitters.reserve(commits);
+   mAuthors.reserve(commits);
+   mDates.reserve(commits);
+   mTextOffsets.reserve(commits);
+   mShortLogSizes.reserve(commits);
+   mLongLogSizes.reserve(commits);
+   mIds.reserve(commits);
+   mParentsOffset.reserve(commits);
+   mParentsCount.reserve(commits);
+   mFirstChilds.reserve(commits);
+   mLanesOffset.reserve(commits);
+   mLanesCount.reserve(commits);
+}
+
+int CommitStore::insert(const CommitInfo &commit)
+{
+   const auto sha = ObjectId::fromSha(commit.sha());
+
+   if (const auto iter = mIds.constFind(sha); iter != mIds.constEnd())
+      return iter.value();
+
+   const auto id = mShas.count();
+   const auto shortLog = commit.shortLog().toUtf8();
+   const auto longLog = commit.longLog().toUtf8();
+
+   mShas.append(sha);
+   mBoundaries.append(commit.boundaryInfo().toLatin1());
+   mCommitters.append(internPerson(commit.committer()));
+   mAuthors.append(internPerson(commit.author()));
+   mDates.append(commit.dateSinceEpoch());
+   mTextOffsets.append(mTexts.size());
+   mShortLogSizes.append(shortLog.size());
+   mLongLogSizes.append(longLog.size());
+   mTexts.append(shortLog).append(longLog);
+   mFirstChilds.append(-1);
+
+   const auto parents = commit.parents();
+
+   mParentsOffset.append(mParentShas.count());
+   mParentsCount.append(static_cast<quint16>(parents.count()));
+
+   for (const auto &parentSha : parents)
+   {
+      mParentShas.append(ObjectId::fromSha(parentSha));
+      mParents.append(-1);
+      mNextSiblings.append(-1);
+   }
+
+   linkCommit(id);
+
+   mLanesOffset.append(mLanes.size());
+   mLanesCount.append(0);
+   setLanes(id, commit.getLanes());
+
+   if (commit.hasReferences())
+      mReferences.insert(id, commit.getAllReferences());
+
+   return id;
+}
+
+int CommitStore::indexOf(const QString &sha) const
+{
+   return mIds.value(ObjectId::fromSha(sha), -1);
+}
+
+int CommitStore::indexOfPrefix(const QString &prefix) const
+{
+   const auto isHex = std::all_of(prefix.cbegin(), prefix.cend(), [](QChar c) { return isxdigit(c.toLatin1()); });
+
+   if (prefix.isEmpty() || prefix.size() > ObjectId::SIZE * 2 || !isHex)
+      return -1;
+
+   updateSortedIds();
+
+   // The prefix completed with zeros is the lowest SHA that can match it, so the candidate is its lower bound.
+   const auto lowestSha = ObjectId::fromSha(prefix + QString(ObjectId::SIZE * 2 - prefix.size(), '0'));
+   const auto lessThan = [this](int id, const ObjectId &sha) {
+      return memcmp(mShas.at(id).bytes, sha.bytes, ObjectId::SIZE) < 0;
+   };
+   const auto iter = std::lower_bound(mSortedIds.cbegin(), mSortedIds.cend(), lowestSha, lessThan);
+
+   if (iter == mSortedIds.cend())
+      return -1;
+
+   // The prefix is compared in binary: first the complete bytes and then the remaining half byte, if any.
+   const auto fullBytes = prefix.size() / 2;
+   const auto hasHalfByte = prefix.size() % 2 != 0;
+   const auto matches = [&](int id) {
+      const auto &candidate = mShas.at(id);
+      return memcmp(candidate.bytes, lowestSha.bytes, static_cast<size_t>(fullBytes)) == 0
+          && (!hasHalfByte || (candidate.bytes[fullBytes] & 0xF0) == lowestSha.bytes[fullBytes]);
+   };
+
+   if (!matches(*iter))
+      return -1;
+
+   // The commits that match are consecutive, so the prefix is ambiguous when the next one matches too.
+   if (const auto next = std::next(iter); next != mSortedIds.cend() && matches(*next))
+      return -1;
+
+   return *iter;
+}
+
+CommitInfo CommitStore::commit(int id) const
+{
+   const auto textOffset = mTextOffsets.at(id);
+   const auto shortLogSize = mShortLogSizes.at(id);
+
+   CommitInfo commit(sha(id), parents(id), QLatin1Char(mBoundaries.at(id)), mPeople.at(mCommitters.at(id)),
+                     mPeople.at(mAuthors.at(id)), mDates.at(id),
+                     QString::fromUtf8(mTexts.constData() + textOffset, shortLogSize),
+                     QString::fromUtf8(mTexts.constData() + textOffset + shortLogSize, mLongLogSizes.at(id)));
+
+   commit.setLanes(getLanes(id));
+   commit.setHasChilds(hasChilds(id));
+
+   if (const auto iter = mReferences.constFind(id); iter != mReferences.constEnd())
+      commit.addReferences(iter.value());
+
+   return commit;
+}
+
+CommitView CommitStore::view(int id) const
+{
+   CommitView view;
+   view.valid = true;
+   view.sha = mShas.at(id);
+   view.hasChilds = hasChilds(id);
+   view.parentsCount = mParentsCount.at(id);
+   view.lanes = QByteArray(mLanes.constData() + mLanesOffset.at(id), mLanesCount.at(id));
+   view.references = mReferences.value(id);
+
+   return view;
+}
+
+QStringList CommitStore::parents(int id) const
+{
+   QStringList parents;
+   const auto offset = mParentsOffset.at(id);
+
+   for (auto i = 0; i < mParentsCount.at(id); ++i)
+      parents.append(mParentShas.at(offset + i).toSha());
+
+   return parents;
+}
+
+QVector<int> CommitStore::childs(int id) const
+{
+   QVector<int> childs;
+
+   for (auto edge = mFirstChilds.at(id); edge != -1; edge = mNextSiblings.at(edge))
+      childs.append(edgeOwner(edge));
+
+   return childs;
+}
+
+QString CommitStore::getFieldStr(int id, CommitInfo::Field field) const
+{
+   const auto textOffset = mTextOffsets.at(id);
+   const auto shortLogSize = mShortLogSizes.at(id);
+
+   switch (field)
+   {
+      case CommitInfo::Field::SHA:
+         return sha(id);
+      case CommitInfo::Field::PARENTS_SHA:
+         return parents(id).join(",");
+      case CommitInfo::Field::COMMITER:
+         return mPeople.at(mCommitters.at(id));
+      case CommitInfo::Field::AUTHOR:
+         return mPeople.at(mAuthors.at(id));
+      case CommitInfo::Field::DATE:
+         return QString::number(mDates.at(id));
+      case CommitInfo::Field::SHORT_LOG:
+         return QString::fromUtf8(mTexts.constData() + textOffset, shortLogSize);
+      case CommitInfo::Field::LONG_LOG:
+         return QString::fromUtf8(mTexts.constData() + textOffset + shortLogSize, mLongLogSizes.at(id));
+      default:
+         return QString();
+   }
+}
+
+QVector<Lane> CommitStore::getLanes(int id) const
+{
+   const auto offset = mLanesOffset.at(id);
+   const auto count = mLanesCount.at(id);
+
+   QVector<Lane> lanes;
+   lanes.reserve(count);
+
+   for (auto i = 0; i < count; ++i)
+      lanes.append(Lane(static_cast<LaneType>(static_cast<quint8>(mLanes.at(offset + i)))));
+
+   return lanes;
+}
+
+void CommitStore::setLanes(int id, const QVector<Lane> &lanes)
+{
+   const auto types = allocateLanes(id, lanes.count());
+
+   for (auto i = 0; i < lanes.count(); ++i)
+      types[i] = static_cast<char>(lanes.at(i).getType());
+}
+
+char *CommitStore::allocateLanes(int id, int count)
+{
+   // The lanes are overwritten in place when they fit. Otherwise they are appended and the old ones are left unused
+   // until there are enough unused bytes to compact the buffer.
+   if (count > mLanesCount.at(id))
+   {
+      mLanesUsed -= mLanesCount.at(id);
+      mLanesCount[id] = 0;
+
+      const auto unused = mLanes.size() - mLanesUsed;
+
+      if (unused > MIN_UNUSED_LANE_BYTES && unused > mLanesUsed)
+         compactLanes();
+
+      mLanesOffset[id] = mLanes.size();
+   }
+
+   const auto offset = mLanesOffset.at(id);
+
+   mLanesUsed += count - mLanesCount.at(id);
+   mLanesCount[id] = static_cast<quint16>(count);
+
+   if (offset + count > mLanes.size())
+      mLanes.resize(offset + count);
+
+   return mLanes.data() + offset;
+}
+
+void CommitStore::compactLanes()
+{
+   QByteArray lanes;
+   lanes.reserve(mLanesUsed);
+
+   for (auto id = 0; id < mLanesOffset.count(); ++id)
+   {
+      const auto offset = mLanesOffset.at(id);
+      mLanesOffset[id] = lanes.size();
+      lanes.append(mLanes.constData() + offset, mLanesCount.at(id));
+   }
+
+   mLanes = lanes;
+}
+
+void CommitStore::addReference(int id, References::Type type, const QString &reference)
+{
+   mReferences[id].addReference(type, reference);
+}
+
+int CommitStore::internPerson(const QString &person)
+{
+   if (const auto iter = mPeopleIds.constFind(person); iter != mPeopleIds.constEnd())
+      return iter.value();
+
+   const auto personId = mPeople.count();
+
+   mPeople.append(person);
+   mPeopleIds.insert(person, personId);
+
+   return personId;
+}
+
+void CommitStore::linkCommit(int id)
+{
+   const auto &sha = mShas.at(id);
+   const auto firstEdge = mParentsOffset.at(id);
+   const auto lastEdge = firstEdge + mParentsCount.at(id);
+
+   mIds.insert(sha, id);
+
+   for (auto edge = firstEdge; edge < lastEdge; ++edge)
+   {
+      const auto &parentId = mParentShas.at(edge);
+
+      if (const auto iter = mIds.constFind(parentId); iter != mIds.constEnd())
+         linkEdge(edge, iter.value());
+      else
+         mPendingEdges.insert(parentId, edge);
+   }
+
+   // The children that were stored before this commit were waiting for it.
+   for (auto iter = mPendingEdges.find(sha); iter != mPendingEdges.end() && iter.key() == sha;)
+   {
+      linkEdge(iter.value(), id);
+      iter = mPendingEdges.erase(iter);
+   }
+}
+
+void CommitStore::linkEdge(int edge, int parentId)
+{
+   mParents[edge] = parentId;
+   mNextSiblings[edge] = mFirstChilds.at(parentId);
+   mFirstChilds[parentId] = edge;
+}
+
+void CommitStore::updateSortedIds() const
+{
+   const auto sortedCount = mSortedIds.count();
+
+   if (sortedCount == mShas.count())
+      return;
+
+   const auto lessThan = [this](int first, int second) {
+      return memcmp(mShas.at(first).bytes, mShas.at(second).bytes, ObjectId::SIZE) < 0;
+   };
+
+   for (auto id = sortedCount; id < mShas.count(); ++id)
+      mSortedIds.append(id);
+
+   std::sort(mSortedIds.begin() + sortedCount, mSortedIds.end(), lessThan);
+   std::inplace_merge(mSortedIds.begin(), mSortedIds.begin() + sortedCount, mSortedIds.end(), lessThan);
+}
+
+int CommitStore::edgeOwner(int edge) const
+{
+   // The edges are stored in the same order as the commits, so the owner is the last commit that starts before it.
+   const auto iter = std::upper_bound(mParentsOffset.cbegin(), mParentsOffset.cend(), edge);
+
+   return static_cast<int>(iter - mParentsOffset.cbegin()) - 1;
+}
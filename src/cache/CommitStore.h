@@ -0,0 +1,200 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+#include <ObjectId.h>
+
+#include <QHash>
+#include <QMap>
+#include <QVector>
+
+/**
+ * @brief The CommitView struct is a lightweight copy of the properties of a commit that are needed to paint it: unlike
+ * CommitInfo, it doesn't decode the texts of the commit nor the SHAs of its parents.
+ */
+struct CommitView
+{
+   ObjectId sha;
+   bool valid = false;
+   bool isWip = false;
+   bool hasChilds = false;
+   int parentsCount = 0;
+   // The types of the lanes, one byte per lane.
+   QByteArray lanes;
+   References references;
+
+   bool isValid() const;
+   /**
+    * @brief Gets the SHA in hexadecimal. The WIP returns CommitInfo::ZERO_SHA.
+    */
+   QString getSha() const;
+   int getActiveLane() const;
+};
+
+/**
+ * @brief The CommitStore class keeps the commits of the repository in a columnar way: every property of the commits is
+ * stored in its own array indexed by the commit id, that is the order of insertion. The SHAs are stored in binary,
+ * the relationships between commits are integer ids, the author and committer names are interned and the logs are
+ * stored in a single UTF-8 buffer.
+ *
+ * The commits are never removed individually, so the ids are stable until the store is cleared. The class is not
+ * thread-safe: the owner is in charge of the synchronization.
+ */
+class CommitStore
+{
+public:
+   /**
+    * @brief Gets the number of commits stored.
+    * @return The number of commits.
+    */
+   int count() const { return mShas.count(); }
+   /**
+    * @brief Removes all the commits and releases the memory.
+    */
+   void clear();
+   /**
+    * @brief Reserves memory for @p commits commits.
+    * @param commits The expected number of commits.
+    */
+   void reserve(int commits);
+   /**
+    * @brief Stores a commit including its lanes and references. If a commit with the same SHA is already in the
+    * store, nothing is done.
+    *
+    * @param commit The commit to store.
+    * @return The id of the commit.
+    */
+   int insert(const CommitInfo &commit);
+   /**
+    * @brief Gets the id of the commit with the given full SHA.
+    * @param sha The SHA of the commit.
+    * @return The id of the commit or -1 if it's not stored.
+    */
+   int indexOf(const QString &sha) const;
+   /**
+    * @brief Gets the id of the commit whose SHA starts with @p prefix.
+    *
+    * @param prefix The prefix of the SHA in hexadecimal.
+    * @return The id of the commit or -1 if there is none or the prefix is ambiguous.
+    */
+   int indexOfPrefix(const QString &prefix) const;
+   /**
+    * @brief Builds the CommitInfo of the given commit.
+    * @param id The id of the commit.
+    * @return The commit.
+    */
+   CommitInfo commit(int id) const;
+   /**
+    * @brief Builds the view of the given commit.
+    * @param id The id of the commit.
+    * @return The view of the commit.
+    */
+   CommitView view(int id) const;
+
+   QString sha(int id) const { return mShas.at(id).toSha(); }
+   QString author(int id) const { return mPeople.at(mAuthors.at(id)); }
+   QByteArray shortLogUtf8(int id) const { return mTexts.mid(mTextOffsets.at(id), mShortLogSizes.at(id)); }
+   qint64 date(int id) const { return mDates.at(id); }
+   ObjectId getObjectId(int id) const { return mShas.at(id); }
+   QStringList parents(int id) const;
+   QVector<ObjectId> getParentIds(int id) const { return mParentShas.mid(mParentsOffset.at(id), mParentsCount.at(id)); }
+   int parentsCount(int id) const { return mParentsCount.at(id); }
+   /**
+    * @brief Gets the id of a parent of a commit.
+    * @param id The id of the commit.
+    * @param index The position of the parent.
+    * @return The id of the parent or -1 if the parent is not stored.
+    */
+   int parent(int id, int index) const { return mParents.at(mParentsOffset.at(id) + index); }
+   QVector<int> childs(int id) const;
+   bool hasChilds(int id) const { return mFirstChilds.at(id) != -1; }
+   QString getFieldStr(int id, CommitInfo::Field field) const;
+
+   QVector<Lane> getLanes(int id) const;
+   void setLanes(int id, const QVector<Lane> &lanes);
+
+   void addReference(int id, References::Type type, const QString &reference);
+   void clearReferences() { mReferences.clear(); }
+   QMap<int, References> getReferences() const { return mReferences; }
+
+private:
+   friend class CacheSnapshot;
+
+   QVector<ObjectId> mShas;
+   QByteArray mBoundaries;
+   QVector<int> mCommitters;
+   QVector<int> mAuthors;
+   QVector<qint64> mDates;
+   QVector<int> mTextOffsets;
+   QVector<int> mShortLogSizes;
+   QVector<int> mLongLogSizes;
+   QByteArray mTexts;
+   QVector<QString> mPeople;
+   QHash<QString, int> mPeopleIds;
+   QHash<ObjectId, int> mIds;
+
+   // Every parent relationship is an edge. The edges of a commit are consecutive and the edges that point to the same
+   // parent are linked to build the list of children.
+   QVector<int> mParentsOffset;
+   QVector<quint16> mParentsCount;
+   QVector<ObjectId> mParentShas;
+   QVector<int> mParents;
+   QVector<int> mNextSiblings;
+   QVector<int> mFirstChilds;
+   QMultiHash<ObjectId, int> mPendingEdges;
+
+   QVector<int> mLanesOffset;
+   QVector<quint16> mLanesCount;
+   QByteArray mLanes;
+   // The bytes of mLanes that belong to a commit. The rest were left behind when the lanes of a commit grew.
+   int mLanesUsed = 0;
+
+   QMap<int, References> mReferences;
+
+   // The ids sorted by SHA for the prefix lookups. The commits inserted since the last lookup are merged on demand.
+   mutable QVector<int> mSortedIds;
+
+   int internPerson(const QString &person);
+   /**
+    * @brief Links a commit whose columns are already stored with its parents and with the children that were waiting
+    * for it.
+    * @param id The id of the commit.
+    */
+   void linkCommit(int id);
+   void linkEdge(int edge, int parentId);
+   /**
+    * @brief Makes room for the lanes of a commit.
+    * @param id The id of the commit.
+    * @param count The number of lanes.
+    * @return The buffer where the types of the lanes are written.
+    */
+   char *allocateLanes(int id, int count);
+   /**
+    * @brief Rebuilds the lanes buffer without the bytes that don't belong to any commit.
+    */
+   void compactLanes();
+   int edgeOwner(int edge) const;
+   void updateSortedIds() const;
+};
@@ -0,0 +1,20 @@
+#include "ObjectId.h"
+
+#include <QByteArray>
+
+#include <algorithm>
+
+ObjectId ObjectId::fromSha(const QString &sha)
+{
+   ObjectId id;
+   const auto binarySha = QByteArray::fromHex(sha.left(SIZE * 2).toLatin1());
+
+   memcpy(id.bytes, binarySha.constData(), static_cast<size_t>(std::min(binarySha.size(), SIZE)));
+
+   return id;
+}
+
+QString ObjectId::toSha() const
+{
+   return QString::fromLatin1(QByteArray::fromRawData(reinterpret_cast<const char *>(bytes), SIZE).toHex());
+}
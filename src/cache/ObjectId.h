@@ -0,0 +1,56 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+
+#include <cstring>
+
+/**
+ * @brief The ObjectId struct is the binary form of a Git SHA-1.
+ */
+struct ObjectId
+{
+   static constexpr int SIZE = 20;
+
+   quint8 bytes[SIZE] = {};
+
+   static ObjectId fromSha(const QString &sha);
+   QString toSha() const;
+
+   bool operator==(const ObjectId &other) const { return memcmp(bytes, other.bytes, SIZE) == 0; }
+   bool operator!=(const ObjectId &other) const { return !(*this == other); }
+};
+Q_DECLARE_TYPEINFO(ObjectId, Q_PRIMITIVE_TYPE);
+
+/**
+ * @brief The SHA-1 is already uniformly distributed so the first bytes are a good enough hash.
+ */
+inline uint qHash(const ObjectId &id, uint seed = 0)
+{
+   uint hash;
+   memcpy(&hash, id.bytes, sizeof(hash));
+
+   return hash ^ seed;
+}
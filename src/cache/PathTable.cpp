@@ -0,0 +1,105 @@
+#include "PathTable.h"
+
+PathTable &PathTable::instance()
+{
+   static PathTable table;
+
+   return table;
+}
+
+int PathTable::intern(const QString &path)
+{
+   QMutexLocker lock(&mMutex);
+
+   if (const auto iter = mIds.constFind(path); iter != mIds.constEnd())
+   {
+      ++mReferences[iter.value()];
+      return iter.value();
+   }
+
+   auto id = 0;
+
+   if (!mFreeIds.isEmpty())
+   {
+      id = mFreeIds.takeLast();
+      mPaths[id] = path;
+      mReferences[id] = 1;
+   }
+   else
+   {
+      id = mPaths.count();
+      mPaths.append(path);
+      mReferences.append(1);
+   }
+
+   mIds.insert(path, id);
+
+   return id;
+}
+
+int PathTable::find(const QString &path) const
+{
+   QMutexLocker lock(&mMutex);
+
+   return mIds.value(path, -1);
+}
+
+QString PathTable::path(int id) const
+{
+   QMutexLocker lock(&mMutex);
+
+   return mPaths.at(id);
+}
+
+void PathTable::retain(const QVector<int> &ids)
+{
+   QMutexLocker lock(&mMutex);
+
+   for (const auto id : ids)
+      ++mReferences[id];
+}
+
+void PathTable::release(int id)
+{
+   QMutexLocker lock(&mMutex);
+
+   releaseId(id);
+}
+
+void PathTable::release(const QVector<int> &ids)
+{
+   QMutexLocker lock(&mMutex);
+
+   for (const auto id : ids)
+      releaseId(id);
+}
+
+qint64 PathTable::memoryUsage(const QVector<int> &ids) const
+{
+   QMutexLocker lock(&mMutex);
+
+   // The path is stored twice (in the list and as the key of the lookup) but the data is implicitly shared.
+   qint64 bytes = 0;
+
+   for (const auto id : ids)
+      bytes += static_cast<qint64>(2 * sizeof(QString) + sizeof(int) + mPaths.at(id).capacity() * sizeof(QChar));
+
+   return bytes;
+}
+
+int PathTable::count() const
+{
+   QMutexLocker lock(&mMutex);
+
+   return mIds.count();
+}
+
+void PathTable::releaseId(int id)
+{
+   if (--mReferences[id] > 0)
+      return;
+
+   mIds.remove(mPaths.at(id));
+   mPaths[id] = QString();
+   mFreeIds.append(id);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The PathTable class interns the paths of the files shown in the commits. Every path is stored once and is
+ * identified by an integer id, so the RevisionFiles only store ids and comparing two paths is comparing two integers.
+ *
+ * The table is shared by all the repositories. The ids are reference counted: the RevisionFiles retain the ids they
+ * store and release them when they are destroyed, so the paths of the evicted revisions are removed from the table
+ * and their ids are reused. All the methods are thread-safe.
+ */
+class PathTable
+{
+public:
+   /**
+    * @brief Gets the table shared by the application.
+    * @return The path table.
+    */
+   static PathTable &instance();
+   /**
+    * @brief Gets the id of a path, adding it to the table if it's not there yet. The id is returned with a reference
+    * that the caller must release once the id is stored somewhere else.
+    *
+    * @param path The path of the file relative to the work tree.
+    * @return The id of the path.
+    */
+   int intern(const QString &path);
+   /**
+    * @brief Gets the id of a path without adding it nor retaining it.
+    * @param path The path of the file relative to the work tree.
+    * @return The id of the path or -1 if it's not in the table.
+    */
+   int find(const QString &path) const;
+   /**
+    * @brief Gets the path of an id.
+    * @param id The id returned by intern.
+    * @return The path or an empty string if the id was released.
+    */
+   QString path(int id) const;
+   /**
+    * @brief Adds a reference to every id.
+    * @param ids The ids.
+    */
+   void retain(const QVector<int> &ids);
+   /**
+    * @brief Removes a reference from an id. The path is removed when its last reference is released.
+    * @param id The id.
+    */
+   void release(int id);
+   /**
+    * @brief Removes a reference from every id.
+    * @param ids The ids.
+    */
+   void release(const QVector<int> &ids);
+   /**
+    * @brief Gets the memory used by the paths of the given ids, including the lookup entries.
+    * @param ids The ids.
+    * @return The size in bytes.
+    */
+   qint64 memoryUsage(const QVector<int> &ids) const;
+   /**
+    * @brief Gets the number of paths in the table.
+    * @return The number of paths.
+    */
+   int count() const;
+
+private:
+   mutable QMutex mMutex;
+   QHash<QString, int> mIds;
+   QVector<QString> mPaths;
+   QVector<int> mReferences;
+   QVector<int> mFreeIds;
+
+   PathTable() = default;
+
+   void releaseId(int id);
+};
@@ -1,9 +1,30 @@
 #include "RevisionFiles.h"
 
+#include <PathTable.h>
+
+RevisionFiles::PathIds::PathIds(const PathIds &other)
+   : QSharedData(other)
+   , ids(other.ids)
+{
+   PathTable::instance().retain(ids);
+}
+
+RevisionFiles::PathIds::~PathIds()
+{
+   if (!ids.isEmpty())
+      PathTable::instance().release(ids);
+}
+
+RevisionFiles::RevisionFiles()
+   : mPathIds(new PathIds())
+{
+}
+
 bool RevisionFiles::operator==(const RevisionFiles &revFiles) const
 {
-   return mFiles == revFiles.mFiles && mOnlyModified == revFiles.mOnlyModified && mergeParent == revFiles.mergeParent
-       && mFileStatus == revFiles.mFileStatus && mRenamedFiles == revFiles.mRenamedFiles;
+   return mPathIds->ids == revFiles.mPathIds->ids && mOnlyModified == revFiles.mOnlyModified
+       && mergeParent == revFiles.mergeParent && mFileStatus == revFiles.mFileStatus
+       && mRenamedFiles == revFiles.mRenamedFiles;
 }
 
 bool RevisionFiles::operator!=(const RevisionFiles &revFiles) const
@@ -29,51 +50,139 @@ const QString RevisionFiles::extendedStatus(int idx) const
    return !mRenamedFiles.isEmpty() && idx < mRenamedFiles.count() ? mRenamedFiles.at(idx) : "";
 }
 
-void RevisionFiles::setStatus(const QString &rowSt)
+int RevisionFiles::toStatus(QChar rowSt)
 {
-   switch (rowSt.at(0).toLatin1())
+   switch (rowSt.toLatin1())
    {
-      case 'M':
-      case 'T':
-         mFileStatus.append(RevisionFiles::MODIFIED);
-         break;
       case 'U':
-         mFileStatus.append(RevisionFiles::MODIFIED);
-         mFileStatus[mFileStatus.count() - 1] |= RevisionFiles::CONFLICT;
-         mOnlyModified = false;
-         break;
+         return RevisionFiles::MODIFIED | RevisionFiles::CONFLICT;
       case 'D':
-         mFileStatus.append(RevisionFiles::DELETED);
-         mOnlyModified = false;
-         break;
+         return RevisionFiles::DELETED;
       case 'A':
-         mFileStatus.append(RevisionFiles::NEW);
-         mOnlyModified = false;
-         break;
+         return RevisionFiles::NEW;
       case '?':
-         mFileStatus.append(RevisionFiles::UNKNOWN);
-         mOnlyModified = false;
-         break;
-      default:
-         mFileStatus.append(RevisionFiles::MODIFIED);
-         break;
+         return RevisionFiles::UNKNOWN;
+      default: // 'M' and 'T' among others
+         return RevisionFiles::MODIFIED;
    }
 }
 
-void RevisionFiles::setStatus(RevisionFiles::StatusFlag flag)
+void RevisionFiles::setExtStatus(int pos, const QString &extStatus)
 {
-   mFileStatus.append(flag);
+   if (mRenamedFiles.count() <= pos)
+      mRenamedFiles.resize(pos + 1);
 
-   if (flag == RevisionFiles::DELETED || flag == RevisionFiles::NEW || flag == RevisionFiles::UNKNOWN)
+   mRenamedFiles[pos] = extStatus;
+}
+
+QString RevisionFiles::getFile(int index) const
+{
+   return PathTable::instance().path(mPathIds->ids.at(index));
+}
+
+QStringList RevisionFiles::getFiles() const
+{
+   QStringList files;
+   files.reserve(mPathIds->ids.count());
+
+   for (const auto id : mPathIds->ids)
+      files.append(PathTable::instance().path(id));
+
+   return files;
+}
+
+int RevisionFiles::indexOf(const QString &fileName) const
+{
+   const auto id = PathTable::instance().find(fileName);
+
+   return id == -1 ? -1 : mPathIds->ids.indexOf(id);
+}
+
+void RevisionFiles::appendFile(int pathId, int status, int parent)
+{
+   PathTable::instance().retain({ pathId });
+
+   mPathIds->ids.append(pathId);
+   mFileStatus.append(static_cast<quint8>(status));
+   mergeParent.append(parent);
+
+   if (status != RevisionFiles::MODIFIED)
+      mOnlyModified = false;
+}
+
+void RevisionFiles::appendFile(const QString &file, int status, int parent)
+{
+   const auto pathId = PathTable::instance().intern(file);
+
+   appendFile(pathId, status, parent);
+
+   PathTable::instance().release(pathId);
+}
+
+void RevisionFiles::setFileStatus(int pos, int status)
+{
+   mFileStatus[pos] = static_cast<quint8>(status);
+
+   if (status != RevisionFiles::MODIFIED)
       mOnlyModified = false;
 }
 
-void RevisionFiles::setStatus(int pos, RevisionFiles::StatusFlag flag)
+void RevisionFiles::removeFiles(const QVector<int> &sortedPositions)
 {
-   mFileStatus[pos] = flag;
+   if (sortedPositions.isEmpty())
+      return;
+
+   // Single pass that moves the kept files over the removed ones.
+   auto &ids = mPathIds->ids;
+   QVector<int> removedIds;
+   auto removed = 0;
+   auto next = 0;
+
+   for (auto i = 0; i < ids.count(); ++i)
+   {
+      if (next < sortedPositions.count() && sortedPositions.at(next) == i)
+      {
+         removedIds.append(ids.at(i));
+         ++next;
+         ++removed;
+         continue;
+      }
+
+      if (removed > 0)
+      {
+         ids[i - removed] = ids.at(i);
+         mFileStatus[i - removed] = mFileStatus.at(i);
+         mergeParent[i - removed] = mergeParent.at(i);
+
+         if (i < mRenamedFiles.count())
+            mRenamedFiles[i - removed] = mRenamedFiles.at(i);
+      }
+   }
+
+   const auto newCount = ids.count() - removed;
+
+   ids.resize(newCount);
+   mFileStatus.resize(newCount);
+   mergeParent.resize(newCount);
+
+   if (mRenamedFiles.count() > newCount)
+      mRenamedFiles.resize(newCount);
+
+   PathTable::instance().release(removedIds);
 }
 
-void RevisionFiles::appendStatus(int pos, RevisionFiles::StatusFlag flag)
+qint64 RevisionFiles::memoryUsage() const
 {
-   mFileStatus[pos] |= flag;
+   // The paths are kept in the PathTable while the files are alive, so they count as well. A path shared with other
+   // revisions is counted in each of them, so the real usage is lower.
+   auto bytes = static_cast<qint64>(sizeof(RevisionFiles));
+   bytes += static_cast<qint64>(mPathIds->ids.capacity() * sizeof(int));
+   bytes += PathTable::instance().memoryUsage(mPathIds->ids);
+   bytes += static_cast<qint64>(mFileStatus.capacity() * sizeof(quint8));
+   bytes += static_cast<qint64>(mergeParent.capacity() * sizeof(int));
+
+   for (const auto &renamed : mRenamedFiles)
+      bytes += static_cast<qint64>(sizeof(QString) + renamed.capacity() * sizeof(QChar));
+
+   return bytes;
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QByteArray>
+#include <QSharedData>
+#include <QSharedDataPointer>
 #include <QVector>
 #include <QStringList>
 
@@ -19,30 +21,45 @@ public:
       CONFLICT = 128
    };
 
-   RevisionFiles() = default;
+   RevisionFiles();
    bool operator==(const RevisionFiles &revFiles) const;
    bool operator!=(const RevisionFiles &revFiles) const;
 
    QVector<int> mergeParent;
-   QVector<QString> mFiles;
 
    // helper functions
-   int count() const { return mFiles.count(); }
+   int count() const { return mPathIds->ids.count(); }
    bool statusCmp(int idx, StatusFlag sf) const;
    const QString extendedStatus(int idx) const;
-   void setStatus(const QString &rowSt);
-   void setStatus(RevisionFiles::StatusFlag flag);
-   void setStatus(int pos, RevisionFiles::StatusFlag flag);
-   void appendStatus(int pos, RevisionFiles::StatusFlag flag);
+   static int toStatus(QChar rowSt);
    int getStatus(int pos) const { return mFileStatus.at(pos); }
    void setOnlyModified(bool onlyModified) { mOnlyModified = onlyModified; }
    int getFilesCount() const { return mFileStatus.size(); }
-   void appendExtStatus(const QString &file) { mRenamedFiles.append(file); }
-   QString getFile(int index) const { return mFiles.at(index); }
-   QStringList getFiles() const { return mFiles.toList(); }
-   bool containsFile(const QString &fileName) { return mFiles.contains(fileName); }
+   void setExtStatus(int pos, const QString &extStatus);
+   int getPathId(int index) const { return mPathIds->ids.at(index); }
+   QString getFile(int index) const;
+   QStringList getFiles() const;
+   int indexOf(const QString &fileName) const;
+   bool containsFile(const QString &fileName) const { return indexOf(fileName) != -1; }
+   void appendFile(int pathId, int status, int parent = 1);
+   void appendFile(const QString &file, int status, int parent = 1);
+   void setFileStatus(int pos, int status);
+   void removeFiles(const QVector<int> &sortedPositions);
+   qint64 memoryUsage() const;
 
 private:
+   // The ids retained in the PathTable. The copies of the RevisionFiles share them and the ids are released when the
+   // last copy is destroyed.
+   class PathIds : public QSharedData
+   {
+   public:
+      PathIds() = default;
+      PathIds(const PathIds &other);
+      ~PathIds();
+
+      QVector<int> ids;
+   };
+
    // Status information is splitted in a flags vector and in a string
    // vector in 'status' are stored flags according to the info returned
    // by 'git diff-tree' without -C option.
@@ -53,7 +70,9 @@ private:
    // files info.
    // When status of all the files is 'modified' then onlyModified is
    // set, this let us to do some optimization in this common case
+   // The files are stored as ids of the PathTable.
    bool mOnlyModified = true;
-   QVector<int> mFileStatus;
+   QSharedDataPointer<PathIds> mPathIds;
+   QVector<quint8> mFileStatus;
    QVector<QString> mRenamedFiles;
 };
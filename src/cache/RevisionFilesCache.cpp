@@ -0,0 +1,116 @@
+#include "RevisionFilesCache.h"
+
+RevisionFilesCache::RevisionFilesCache(qint64 maxBytes)
+   : mMaxBytes(maxBytes)
+{
+}
+
+void RevisionFilesCache::setMaxBytes(qint64 maxBytes)
+{
+   mMaxBytes = maxBytes;
+
+   evict();
+}
+
+void RevisionFilesCache::clear()
+{
+   mEntries.clear();
+   mUsage.clear();
+   mBytes = 0;
+}
+
+bool RevisionFilesCache::contains(const Key &key)
+{
+   const auto iter = mEntries.find(key);
+
+   if (iter == mEntries.end())
+   {
+      ++mMisses;
+      return false;
+   }
+
+   ++mHits;
+   mUsage.splice(mUsage.begin(), mUsage, iter->usage);
+
+   return true;
+}
+
+RevisionFiles RevisionFilesCache::value(const Key &key)
+{
+   const auto iter = mEntries.find(key);
+
+   if (iter == mEntries.end())
+      return RevisionFiles();
+
+   mUsage.splice(mUsage.begin(), mUsage, iter->usage);
+
+   return iter->files;
+}
+
+bool RevisionFilesCache::insert(const Key &key, const RevisionFiles &files)
+{
+   const auto bytes = entrySize(key, files);
+
+   if (const auto iter = mEntries.find(key); iter != mEntries.end())
+   {
+      mUsage.splice(mUsage.begin(), mUsage, iter->usage);
+
+      if (iter->files == files)
+         return false;
+
+      mBytes += bytes - iter->bytes;
+      iter->files = files;
+      iter->bytes = bytes;
+   }
+   else
+   {
+      mUsage.push_front(key);
+
+      Entry entry;
+      entry.files = files;
+      entry.bytes = bytes;
+      entry.usage = mUsage.begin();
+
+      mEntries.insert(key, entry);
+      mBytes += bytes;
+   }
+
+   evict();
+
+   return true;
+}
+
+RevisionFilesCache::Stats RevisionFilesCache::getStats() const
+{
+   Stats stats;
+   stats.hits = mHits;
+   stats.misses = mMisses;
+   stats.evictions = mEvictions;
+   stats.bytes = mBytes;
+   stats.maxBytes = mMaxBytes;
+   stats.count = mEntries.count();
+
+   return stats;
+}
+
+qint64 RevisionFilesCache::entrySize(const Key &key, const RevisionFiles &files)
+{
+   // The SHAs are stored twice: in the hash and in the usage list.
+   const auto keyBytes = 2 * static_cast<qint64>((key.first.size() + key.second.size()) * sizeof(QChar));
+
+   return static_cast<qint64>(sizeof(Entry)) + keyBytes + files.memoryUsage();
+}
+
+void RevisionFilesCache::evict()
+{
+   // The most recent entry is always kept, even if it doesn't fit in the budget by itself.
+   while (mBytes > mMaxBytes && mUsage.size() > 1)
+   {
+      const auto iter = mEntries.find(mUsage.back());
+
+      mBytes -= iter->bytes;
+      mEntries.erase(iter);
+      mUsage.pop_back();
+      ++mEvictions;
+   }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <RevisionFiles.h>
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+
+#include <list>
+
+/**
+ * @brief The RevisionFilesCache class keeps the files changed between two revisions with a memory budget. When the
+ * budget is exceeded the least recently used entries are removed, so they will be requested to git again if the user
+ * goes back to them. The budget includes the paths of the files, that leave the PathTable once no entry uses them.
+ *
+ * The class is not thread-safe: the owner is in charge of the synchronization.
+ */
+class RevisionFilesCache
+{
+public:
+   using Key = QPair<QString, QString>;
+
+   /**
+    * @brief The Stats struct contains the usage counters of the cache.
+    */
+   struct Stats
+   {
+      quint64 hits = 0;
+      quint64 misses = 0;
+      quint64 evictions = 0;
+      qint64 bytes = 0;
+      qint64 maxBytes = 0;
+      int count = 0;
+   };
+
+   /**
+    * @brief Creates the cache.
+    * @param maxBytes The memory budget in bytes.
+    */
+   explicit RevisionFilesCache(qint64 maxBytes = DEFAULT_MAX_BYTES);
+
+   /**
+    * @brief Changes the memory budget, removing the entries that don't fit anymore.
+    * @param maxBytes The memory budget in bytes.
+    */
+   void setMaxBytes(qint64 maxBytes);
+   /**
+    * @brief Removes all the entries. The counters are kept.
+    */
+   void clear();
+   /**
+    * @brief Checks if the files between two revisions are stored. This is the lookup that counts as hit or miss.
+    * @param key The pair of SHAs.
+    * @return True if they are stored, otherwise false.
+    */
+   bool contains(const Key &key);
+   /**
+    * @brief Gets the files between two revisions marking them as recently used.
+    * @param key The pair of SHAs.
+    * @return The files or an empty RevisionFiles if they are not stored.
+    */
+   RevisionFiles value(const Key &key);
+   /**
+    * @brief Checks if the files between two revisions are stored without counting it as a lookup nor changing the
+    * recency of the entry.
+    *
+    * @param key The pair of SHAs.
+    * @return True if they are stored, otherwise false.
+    */
+   bool isStored(const Key &key) const { return mEntries.contains(key); }
+   /**
+    * @brief Stores the files between two revisions, removing the least recently used entries if the budget is
+    * exceeded.
+    *
+    * @param key The pair of SHAs.
+    * @param files The files.
+    * @return True if the stored files changed, otherwise false.
+    */
+   bool insert(const Key &key, const RevisionFiles &files);
+   /**
+    * @brief Gets the usage counters.
+    * @return The counters.
+    */
+   Stats getStats() const;
+
+   static constexpr qint64 DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+
+private:
+   struct Entry
+   {
+      RevisionFiles files;
+      qint64 bytes = 0;
+      std::list<Key>::iterator usage;
+   };
+
+   QHash<Key, Entry> mEntries;
+   // The most recently used key goes first.
+   std::list<Key> mUsage;
+   qint64 mMaxBytes = DEFAULT_MAX_BYTES;
+   qint64 mBytes = 0;
+   quint64 mHits = 0;
+   quint64 mMisses = 0;
+   quint64 mEvictions = 0;
+
+   static qint64 entrySize(const Key &key, const RevisionFiles &files);
+   void evict();
+};
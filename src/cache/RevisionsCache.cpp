@@ -1,8 +1,92 @@
 #include "RevisionsCache.h"
 
+#include <PathTable.h>
+#include <LegacyLanes.h>
 #include <QLogger.h>
+#include <BenchmarkTool.h>
+
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <queue>
 
 using namespace QLogger;
+using namespace GitQlientTools;
+
+static const int LANES_CHECKPOINT_INTERVAL = 1024;
+static const int PARSING_CHUNK_SIZE = 2048;
+static const int MAX_LANE_BLOCKS = 8;
+static const int SEARCH_INDEX_CHUNK_SIZE = 2048;
+static const int BENCHMARK_MERGE_INTERVAL = 16;
+
+namespace
+{
+QVector<CommitInfo> parseCommits(const QList<QByteArray> &commits)
+{
+   const auto totalCommits = commits.count();
+   QVector<CommitInfo> revisions(totalCommits);
+   const auto parsedCommits = revisions.data();
+
+   const auto parseChunk = [&commits, parsedCommits, totalCommits](int first) {
+      const auto last = std::min(first + PARSING_CHUNK_SIZE, totalCommits);
+
+      for (auto i = first; i < last; ++i)
+         parsedCommits[i] = CommitInfo(commits.at(i));
+   };
+
+   // Every record is decoded in its own slot, so the chunks can be parsed in parallel and the order is kept.
+   if (totalCommits <= PARSING_CHUNK_SIZE)
+      parseChunk(0);
+   else
+   {
+      QVector<int> chunks;
+
+      for (auto first = 0; first < totalCommits; first += PARSING_CHUNK_SIZE)
+         chunks.append(first);
+
+      QtConcurrent::blockingMap(chunks, parseChunk);
+   }
+
+   const auto end = std::remove_if(revisions.begin(), revisions.end(),
+                                   [](const CommitInfo &revision) { return !revision.isValid(); });
+   revisions.erase(end, revisions.end());
+
+   return revisions;
+}
+
+// The lanes calculation as it was done before the lanes were tracked by binary SHA. It's the reference of the lane
+// benchmark.
+QVector<Lane> calculateLegacyLanes(LegacyLanes &lanes, const QString &sha, const QStringList &parents)
+{
+   bool isDiscontinuity;
+   bool isFork = lanes.isFork(sha, isDiscontinuity);
+   bool isMerge = parents.count() > 1;
+
+   if (isDiscontinuity)
+      lanes.changeActiveLane(sha); // uses previous isBoundary state
+
+   if (isFork)
+      lanes.setFork(sha);
+   if (isMerge)
+      lanes.setMerge(parents);
+   if (parents.isEmpty())
+      lanes.setInitial();
+
+   const auto rowLanes = lanes.getLanes();
+
+   lanes.nextParent(parents.isEmpty() ? QString() : parents.first());
+
+   if (isMerge)
+      lanes.afterMerge();
+   if (isFork)
+      lanes.afterFork();
+   if (lanes.isBranch())
+      lanes.afterBranch();
+
+   return rowLanes;
+}
+}
 
 RevisionsCache::RevisionsCache(QObject *parent)
    : QObject(parent)
@@ -12,9 +96,8 @@ RevisionsCache::RevisionsCache(QObject *parent)
 
 RevisionsCache::~RevisionsCache()
 {
-   mCommits.clear();
-   mCommitsMap.clear();
-   mReferences.clear();
+   mRows.clear();
+   mStore.clear();
 }
 
 void RevisionsCache::setup(const WipRevisionInfo &wipInfo, const QList<QByteArray> &commits)
@@ -27,155 +110,549 @@ void RevisionsCache::setup(const WipRevisionInfo &wipInfo, const QList<QByteArra
 
    mConfigured = false;
 
-   mDirNames.clear();
-   mFileNames.clear();
-   mRevisionFilesMap.clear();
+   const auto stats = mRevisionFiles.getStats();
+
+   QLog_Debug("Git",
+              QString("Revision files cache: {%1} hits, {%2} misses, {%3} evictions, {%4} bytes in {%5} entries.")
+                  .arg(stats.hits)
+                  .arg(stats.misses)
+                  .arg(stats.evictions)
+                  .arg(stats.bytes)
+                  .arg(stats.count));
+
+   mRevisionFiles.clear();
    mLanes.clear();
+   mLaneCheckpoints.clear();
+   mLaneBlocks.clear();
+   mLaneBlocksUsage.clear();
+   mSnapshotCommits = -1;
+   mSnapshotLaneRows = 0;
+   mWipCommit = CommitInfo();
+   mRows.clear();
+   mRowsById.clear();
+   mStore.clear();
+   mWorkTreeStatus.clear();
+   mSearchIndex.clear();
+
+   mRows.reserve(totalCommits);
+   mRowsById.reserve(totalCommits);
+   mStore.reserve(totalCommits);
 
-   for (auto reference : mReferences)
-      reference->clearReferences();
+   QLog_Debug("Git", QString("Adding WIP revision."));
+
+   mWorkTreeStatus.update(wipInfo.status);
+   insertWipRevision(wipInfo.parentSha);
 
-   mReferences.clear();
+   appendCommits(commits);
 
-   if (mCommitsMap.isEmpty())
-      mCommitsMap.reserve(totalCommits);
+   markUpdated();
+}
 
-   if (mCommits.isEmpty() || totalCommits > mCommits.count())
-      mCommits.resize(totalCommits);
-   else if (totalCommits < mCommits.count())
+int RevisionsCache::appendCommits(const QList<QByteArray> &commits)
+{
+   QLog_Debug("Git", QString("Adding {%1} commited revisions.").arg(commits.count()));
+
+   // The records are decoded before taking the lock so the UI thread can keep reading the cache in the meantime.
+   auto revisions = parseCommits(commits);
+
+   QMutexLocker lock(&mMutex);
+
+   // The rows that already exist don't change, so the views don't need to be notified.
+   for (auto &revision : revisions)
+      insertCommitInfo(std::move(revision));
+
+   return count();
+}
+
+CommitInfo RevisionsCache::getCommitInfoByRow(int row)
+{
+   QMutexLocker lock(&mMutex);
+
+   if (row == 0)
+      return mWipCommit;
+
+   if (row < 0 || row > mRows.count())
+      return CommitInfo();
+
+   auto commit = buildCommitInfo(mRows.at(row - 1));
+
+   if (mLazyGraph)
+      commit.setLanes(getLazyLanes(row));
+
+   return commit;
+}
+
+CommitView RevisionsCache::getCommitViewByRow(int row)
+{
+   QMutexLocker lock(&mMutex);
+
+   const auto toBytes = [](const QVector<Lane> &lanes) {
+      QByteArray types;
+      types.reserve(lanes.count());
+
+      for (const auto &lane : lanes)
+         types.append(static_cast<char>(lane.getType()));
+
+      return types;
+   };
+
+   if (row == 0)
    {
-      const auto commitsToRemove = std::abs(totalCommits - mCommits.count());
-      for (auto i = 0, pos = 1; i < commitsToRemove; ++i, ++pos)
-      {
-         mCommits.remove(pos);
-      }
+      CommitView view;
+      view.valid = !mWipCommit.sha().isEmpty();
+      view.isWip = true;
+      view.hasChilds = mWipCommit.hasChilds();
+      view.parentsCount = mWipCommit.parentsCount();
+      view.lanes = toBytes(mWipCommit.getLanes());
+      view.references = mWipCommit.getAllReferences();
+
+      return view;
    }
 
-   QLog_Debug("Git", QString("Adding WIP revision."));
+   if (row < 0 || row > mRows.count())
+      return CommitView();
 
-   insertWipRevision(wipInfo.parentSha, wipInfo.diffIndex, wipInfo.diffIndexCached);
+   auto view = mStore.view(mRows.at(row - 1));
 
-   auto count = 1;
+   // The WIP is not part of the store but it's a child of the commit it's based on.
+   if (!view.hasChilds && mWipCommit.parentsCount() > 0 && view.sha == ObjectId::fromSha(mWipCommit.parent(0)))
+      view.hasChilds = true;
 
-   QLog_Debug("Git", QString("Adding commited revisions."));
+   if (mLazyGraph)
+      view.lanes = toBytes(getLazyLanes(row));
 
-   for (const auto &commitInfo : commits)
-   {
-      CommitInfo revision(commitInfo);
+   return view;
+}
 
-      if (revision.isValid())
-         insertCommitInfo(std::move(revision), count);
-      else
-         break;
+QString RevisionsCache::getCommitField(int row, CommitInfo::Field field)
+{
+   QMutexLocker lock(&mMutex);
 
-      ++count;
-   }
+   if (row == 0)
+      return mWipCommit.getFieldStr(field);
+
+   if (row < 0 || row > mRows.count())
+      return QString();
+
+   return mStore.getFieldStr(mRows.at(row - 1), field);
 }
 
-CommitInfo RevisionsCache::getCommitInfoByRow(int row)
+QVector<RevisionsCache::DisplayFields> RevisionsCache::getDisplayFields(int firstRow, int count)
 {
    QMutexLocker lock(&mMutex);
 
-   const auto commit = row >= 0 && row < mCommits.count() ? mCommits.at(row) : nullptr;
+   const auto first = qMax(0, firstRow);
+   const auto last = qMin(firstRow + count, mRows.count() + 1);
+   QVector<DisplayFields> fields;
+   fields.reserve(qMax(0, last - first));
+
+   for (auto row = first; row < last; ++row)
+   {
+      if (row == 0)
+      {
+         fields.append({ ObjectId(), mWipCommit.author(), static_cast<qint64>(mWipCommit.dateSinceEpoch()),
+                         mWipCommit.shortLog().toUtf8() });
+      }
+      else
+      {
+         const auto id = mRows.at(row - 1);
+         fields.append({ mStore.getObjectId(id), mStore.author(id), mStore.date(id), mStore.shortLogUtf8(id) });
+      }
+   }
 
-   return commit ? *commit : CommitInfo();
+   return fields;
 }
 
 int RevisionsCache::getCommitPos(const QString &sha)
 {
    QMutexLocker lock(&mMutex);
 
-   const auto iter = std::find_if(mCommitsMap.begin(), mCommitsMap.end(),
-                                  [sha](const CommitInfo &commit) { return commit.sha().startsWith(sha); });
-
-   if (iter != mCommitsMap.constEnd())
-      return mCommits.indexOf(&iter.value());
+   if (const auto id = findCommitId(sha); id != -1)
+      return mRowsById.at(id) + 1;
 
-   return -1;
+   // Blame reports the local changes with an abbreviated WIP SHA.
+   return mWipCommit.isValid() && !sha.isEmpty() && CommitInfo::ZERO_SHA.startsWith(sha) ? 0 : -1;
 }
 
-CommitInfo RevisionsCache::getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint)
+QVector<int> RevisionsCache::searchCommits(const QString &text)
 {
+   BenchmarkStart();
+
    QMutexLocker lock(&mMutex);
-   auto commitIter = searchCommit(field, text, startingPoint);
 
-   if (commitIter == mCommits.constEnd() && startingPoint > 0)
-      commitIter = searchCommit(field, text);
+   QVector<int> rows;
+
+   if (text.isEmpty())
+   {
+      BenchmarkEnd();
+      return rows;
+   }
+
+   if (mWipCommit.isValid() && commitMatches(mWipCommit, text))
+      rows.append(0);
 
-   return commitIter != mCommits.constEnd() ? **commitIter : CommitInfo();
+   auto firstNotIndexed = 0;
+
+   if (text.size() >= SearchIndex::MIN_QUERY_LENGTH)
+   {
+      const auto candidates = mSearchIndex.findCandidates(text);
+
+      for (auto id : candidates)
+      {
+         if (commitMatches(id, text))
+            rows.append(mRowsById.at(id) + 1);
+      }
+
+      firstNotIndexed = mSearchIndex.count();
+   }
+
+   for (auto id = firstNotIndexed; id < mStore.count(); ++id)
+   {
+      if (commitMatches(id, text))
+         rows.append(mRowsById.at(id) + 1);
+   }
+
+   std::sort(rows.begin(), rows.end());
+
+   BenchmarkEnd();
+
+   return rows;
 }
 
-CommitInfo RevisionsCache::getCommitInfo(const QString &sha)
+QVector<int> RevisionsCache::getRows(const QStringList &shas)
 {
    QMutexLocker lock(&mMutex);
 
-   if (!sha.isEmpty())
+   QVector<int> rows;
+   rows.reserve(shas.count());
+
+   for (const auto &sha : shas)
    {
-      const auto c = mCommitsMap.value(sha, CommitInfo());
+      if (sha == CommitInfo::ZERO_SHA)
+         rows.append(0);
+      else if (const auto id = findCommitId(sha); id != -1)
+         rows.append(mRowsById.at(id) + 1);
+   }
+
+   std::sort(rows.begin(), rows.end());
+   rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
 
-      if (!c.isValid())
+   return rows;
+}
+
+QVector<int> RevisionsCache::filterRows(const QVector<int> &rows, const QString &text)
+{
+   QMutexLocker lock(&mMutex);
+
+   QVector<int> matches;
+
+   for (auto row : rows)
+   {
+      if (row == 0 ? mWipCommit.isValid() && commitMatches(mWipCommit, text)
+                   : row <= mRows.count() && commitMatches(mRows.at(row - 1), text))
       {
-         const auto shas = mCommitsMap.keys();
-         const auto it = std::find_if(shas.cbegin(), shas.cend(),
-                                      [sha](const QString &shaToCompare) { return shaToCompare.startsWith(sha); });
+         matches.append(row);
+      }
+   }
+
+   return matches;
+}
+
+int RevisionsCache::updateSearchIndex(int maxCommits)
+{
+   BenchmarkStart();
 
-         if (it != shas.cend())
-            return mCommitsMap.value(*it);
+   auto pending = 0;
 
-         return CommitInfo();
+   for (auto indexed = 0; indexed < maxCommits;)
+   {
+      QMutexLocker lock(&mMutex);
+
+      const auto first = mSearchIndex.count();
+      const auto last = std::min({ first + SEARCH_INDEX_CHUNK_SIZE, first + maxCommits - indexed, mStore.count() });
+
+      for (auto id = first; id < last; ++id)
+      {
+         mSearchIndex.append({ mStore.getFieldStr(id, CommitInfo::Field::SHORT_LOG),
+                               mStore.getFieldStr(id, CommitInfo::Field::LONG_LOG), mStore.author(id),
+                               mStore.sha(id) });
       }
 
-      return c;
+      indexed += last - first;
+      pending = mStore.count() - last;
+
+      if (pending == 0)
+         break;
    }
 
-   return CommitInfo();
+   BenchmarkEnd();
+
+   return pending;
+}
+
+CommitInfo RevisionsCache::getCommitInfo(const QString &sha)
+{
+   QMutexLocker lock(&mMutex);
+
+   if (sha == CommitInfo::ZERO_SHA)
+      return mWipCommit;
+
+   if (const auto id = findCommitId(sha); id != -1)
+      return buildCommitInfo(id);
+
+   // Blame reports the local changes with an abbreviated WIP SHA.
+   return !sha.isEmpty() && CommitInfo::ZERO_SHA.startsWith(sha) ? mWipCommit : CommitInfo();
 }
 
 RevisionFiles RevisionsCache::getRevisionFile(const QString &sha1, const QString &sha2) const
 {
-   return mRevisionFilesMap.value(qMakePair(sha1, sha2));
+   QMutexLocker lock(&mMutex);
+
+   if (isWipRevisionFile(sha1, sha2))
+      return mWorkTreeStatus.getRevisionFiles();
+
+   return mRevisionFiles.value(qMakePair(sha1, sha2));
 }
 
-void RevisionsCache::insertCommitInfo(CommitInfo rev, int orderIdx)
+void RevisionsCache::insertCommitInfo(CommitInfo rev)
 {
    if (!mConfigured)
    {
-      rev.setLanes(calculateLanes(rev));
+      const auto row = count();
+
+      storeCommitInfo(std::move(rev));
+
+      if (!mLazyGraph)
+      {
+         if (row % LANES_CHECKPOINT_INTERVAL == 0)
+            mLaneCheckpoints.insert(row, mLanes);
+
+         mStore.setLanes(mRows.constLast(), calculateRowLanes(mLanes, row));
+      }
+   }
+}
+
+void RevisionsCache::storeCommitInfo(CommitInfo rev)
+{
+   const auto id = mStore.insert(rev);
+
+   if (mRowsById.count() < mStore.count())
+      mRowsById.resize(mStore.count());
+
+   mRowsById[id] = mRows.count();
+   mRows.append(id);
+}
+
+CommitInfo RevisionsCache::buildCommitInfo(int id) const
+{
+   auto commit = mStore.commit(id);
+
+   // The WIP is not part of the store but it's a child of the commit it's based on.
+   if (!commit.hasChilds() && mWipCommit.parentsCount() > 0 && commit.sha() == mWipCommit.parent(0))
+      commit.setHasChilds(true);
+
+   return commit;
+}
+
+int RevisionsCache::findCommitId(const QString &sha) const
+{
+   if (const auto id = sha.size() == ObjectId::SIZE * 2 ? mStore.indexOf(sha) : -1; id != -1)
+      return id;
+
+   return mStore.indexOfPrefix(sha);
+}
+
+int RevisionsCache::prependCommits(const QList<QByteArray> &commits)
+{
+   auto revisions = parseCommits(commits);
+
+   QMutexLocker lock(&mMutex);
+
+   const auto previousRows = count();
+
+   if (!revisions.isEmpty())
+   {
+      const auto previousIds = mRows;
+
+      mRows.clear();
+      mRows.reserve(previousIds.count() + revisions.count());
+
+      for (auto &revision : revisions)
+      {
+         if (mStore.indexOf(revision.sha()) == -1)
+            storeCommitInfo(std::move(revision));
+      }
+
+      mRows.append(previousIds);
 
-      const auto sha = rev.sha();
+      for (auto row = 0; row < mRows.count(); ++row)
+         mRowsById[mRows.at(row)] = row;
+   }
+
+   const auto insertedRows = count() - previousRows;
+
+   QLog_Debug("Git", QString("Prepending {%1} new revisions.").arg(insertedRows));
+
+   // Even without new commits the WIP could have a new parent, so the top of the graph is always recalculated.
+   recalculateLanes(insertedRows);
 
-      if (sha == mCommitsMap.value(CommitInfo::ZERO_SHA).parent(0))
-         rev.addChildReference(&mCommitsMap[CommitInfo::ZERO_SHA]);
+   markUpdated();
 
-      mCommitsMap[sha] = rev;
+   return insertedRows;
+}
+
+void RevisionsCache::recalculateLanes(int insertedRows)
+{
+   BenchmarkStart();
 
-      mCommits.replace(orderIdx, &mCommitsMap[sha]);
+   QLog_Debug("Git", QString("Recalculating the lanes after inserting {%1} revisions.").arg(insertedRows));
 
-      if (mTmpChildsStorage.contains(sha))
+   const auto previousCheckpoints = mLaneCheckpoints;
+   const auto previousLanes = mLanes;
+   auto lastRow = count();
+
+   // In the lazy graph mode only the rows that were already calculated before are recalculated.
+   if (mLazyGraph)
+   {
+      const auto lastCheckpoint = previousCheckpoints.isEmpty() ? 0 : previousCheckpoints.lastKey();
+
+      lastRow = std::min(lastRow, lastCheckpoint + insertedRows + 1);
+   }
+
+   mLaneCheckpoints.clear();
+   mLanes.clear();
+   mLaneBlocks.clear();
+   mLaneBlocksUsage.clear();
+
+   for (auto row = 0; row < lastRow; ++row)
+   {
+      // The rows after the inserted ones are the previous rows shifted. If the lanes state before one of them is the
+      // same that was stored in the previous calculation, the rest of the graph doesn't change.
+      if (const auto previousRow = row - insertedRows; row > insertedRows && previousCheckpoints.contains(previousRow)
+          && previousCheckpoints.value(previousRow) == mLanes)
       {
-         for (auto child : mTmpChildsStorage.values(sha))
-            mCommitsMap[sha].addChildReference(child);
+         QLog_Debug("Git", QString("The lanes converged at row {%1}.").arg(row));
+
+         for (auto iter = previousCheckpoints.lowerBound(previousRow); iter != previousCheckpoints.constEnd(); ++iter)
+            mLaneCheckpoints.insert(iter.key() + insertedRows, iter.value());
+
+         mLanes = previousLanes;
+         mSnapshotLaneRows = std::max(mSnapshotLaneRows + insertedRows, row);
 
-         mTmpChildsStorage.remove(sha);
+         BenchmarkEnd();
+
+         return;
       }
 
-      for (const auto &parent : mCommitsMap.value(sha).parents())
-         mTmpChildsStorage.insert(parent, &mCommitsMap[sha]);
+      if (row > 0 && row % LANES_CHECKPOINT_INTERVAL == 0)
+         mLaneCheckpoints.insert(row, mLanes);
+
+      const auto lanes = calculateRowLanes(mLanes, row);
+
+      if (row == 0)
+         mWipCommit.setLanes(lanes);
+      else if (!mLazyGraph)
+         mStore.setLanes(mRows.at(row - 1), lanes);
    }
+
+   mSnapshotLaneRows = lastRow;
+
+   BenchmarkEnd();
 }
 
-void RevisionsCache::insertWipRevision(const QString &parentSha, const QString &diffIndex,
-                                       const QString &diffIndexCache)
+QVector<Lane> RevisionsCache::getLazyLanes(int row)
 {
-   QLog_Debug("Git", QString("Updating the WIP commit. The actual parent has SHA {%1}.").arg(parentSha));
+   const auto block = row / LANES_CHECKPOINT_INTERVAL;
+   const auto blockRow = row % LANES_CHECKPOINT_INTERVAL;
+
+   // While the history is loading, the last block can be shorter than the rows available now.
+   if (const auto iter = mLaneBlocks.constFind(block); iter == mLaneBlocks.constEnd() || iter->count() <= blockRow)
+      calculateLanesBlock(block);
+
+   mLaneBlocksUsage.removeOne(block);
+   mLaneBlocksUsage.append(block);
+
+   return mLaneBlocks.value(block).value(blockRow);
+}
+
+void RevisionsCache::calculateLanesBlock(int block)
+{
+   BenchmarkStart();
+
+   const auto firstRow = block * LANES_CHECKPOINT_INTERVAL;
+   const auto lastRow = std::min(firstRow + LANES_CHECKPOINT_INTERVAL, count());
+
+   // The checkpoints are calculated in order, so the calculation starts from the closest one and the checkpoints
+   // between it and the block are stored on the way.
+   auto row = 0;
+   Lanes lanes;
+
+   if (auto iter = mLaneCheckpoints.upperBound(firstRow); iter != mLaneCheckpoints.begin())
+   {
+      --iter;
+      row = iter.key();
+      lanes = iter.value();
+   }
 
-   const auto key = qMakePair(CommitInfo::ZERO_SHA, parentSha);
-   const auto fakeRevFile = fakeWorkDirRevFile(diffIndex, diffIndexCache);
+   QLog_Trace("Git", QString("Calculating the lanes of the rows {%1} to {%2}.").arg(firstRow).arg(lastRow));
+
+   QVector<QVector<Lane>> blockLanes;
+   blockLanes.reserve(lastRow - firstRow);
+
+   for (; row < lastRow; ++row)
+   {
+      if (row > 0 && row % LANES_CHECKPOINT_INTERVAL == 0)
+         mLaneCheckpoints.insert(row, lanes);
+
+      if (const auto rowLanes = calculateRowLanes(lanes, row); row >= firstRow)
+         blockLanes.append(rowLanes);
+   }
+
+   if (lastRow < count())
+      mLaneCheckpoints.insert(lastRow, lanes);
+
+   while (mLaneBlocksUsage.count() >= MAX_LANE_BLOCKS)
+      mLaneBlocks.remove(mLaneBlocksUsage.takeFirst());
+
+   mLaneBlocks.insert(block, blockLanes);
+
+   BenchmarkEnd();
+}
+
+QVector<Lane> RevisionsCache::calculateRowLanes(Lanes &lanes, int row)
+{
+   if (row == 0)
+   {
+      const auto sha = ObjectId::fromSha(mWipCommit.sha());
+      QVector<ObjectId> parents;
 
-   insertRevisionFile(CommitInfo::ZERO_SHA, parentSha, fakeRevFile);
+      for (const auto &parent : mWipCommit.parents())
+         parents.append(ObjectId::fromSha(parent));
 
-   const auto log
-       = fakeRevFile.count() == mUntrackedfiles.count() ? QString("No local changes") : QString("Local changes");
+      if (lanes.isEmpty())
+         lanes.init(sha);
+
+      return calculateLanes(lanes, sha, parents);
+   }
+
+   const auto id = mRows.at(row - 1);
+   const auto sha = mStore.getObjectId(id);
+
+   if (lanes.isEmpty())
+      lanes.init(sha);
+
+   return calculateLanes(lanes, sha, mStore.getParentIds(id));
+}
+
+void RevisionsCache::insertWipRevision(const QString &parentSha)
+{
+   QLog_Debug("Git", QString("Updating the WIP commit. The actual parent has SHA {%1}.").arg(parentSha));
+
+   // The files of the WIP are served directly from the work tree status.
+   const auto &wipFiles = mWorkTreeStatus.getRevisionFiles();
+
+   const auto log = wipFiles.count() == mWorkTreeStatus.getUntrackedCount() ? QString("No local changes")
+                                                                            : QString("Local changes");
 
    QStringList parents;
 
@@ -184,34 +661,30 @@ void RevisionsCache::insertWipRevision(const QString &parentSha, const QString &
 
    CommitInfo c(CommitInfo::ZERO_SHA, parents, QString("-"), QDateTime::currentDateTime().toSecsSinceEpoch(), log);
 
-   if (mLanes.isEmpty())
-      mLanes.init(c.sha());
+   // Once the history is loaded the lanes are only recalculated as a whole, otherwise the state would be corrupted.
+   const auto calculateWipLanes = !mWipCommit.isValid();
 
-   c.setLanes(calculateLanes(c));
+   c.setLanes(mWipCommit.getLanes());
 
-   if (mCommits[0])
-      c.setLanes(mCommits[0]->getLanes());
+   mWipCommit = std::move(c);
 
-   const auto sha = c.sha();
-
-   mCommitsMap.insert(sha, std::move(c));
-   mCommits[0] = &mCommitsMap[sha];
+   if (calculateWipLanes)
+      mWipCommit.setLanes(calculateRowLanes(mLanes, 0));
 }
 
 bool RevisionsCache::insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file)
 {
-   const auto key = qMakePair(sha1, sha2);
+   QMutexLocker lock(&mMutex);
 
-   if (!sha1.isEmpty() && !sha2.isEmpty() && mRevisionFilesMap.value(key) != file)
-   {
-      QLog_Debug("Git", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
+   if (sha1.isEmpty() || sha2.isEmpty() || isWipRevisionFile(sha1, sha2))
+      return false;
 
-      mRevisionFilesMap.insert(key, file);
+   if (!mRevisionFiles.insert(qMakePair(sha1, sha2), file))
+      return false;
 
-      return true;
-   }
+   QLog_Debug("Git", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
 
-   return false;
+   return true;
 }
 
 void RevisionsCache::insertReference(const QString &sha, References::Type type, const QString &reference)
@@ -219,15 +692,77 @@ void RevisionsCache::insertReference(const QString &sha, References::Type type,
    QMutexLocker lock(&mMutex);
    QLog_Debug("Git", QString("Adding a new reference with SHA {%1}.").arg(sha));
 
-   if (mCommitsMap.contains(sha))
+   if (const auto id = mStore.indexOf(sha); id != -1)
+   {
+      mStore.addReference(id, type, reference);
+
+      markUpdated();
+   }
+}
+
+void RevisionsCache::clearReferences()
+{
+   QMutexLocker lock(&mMutex);
+
+   mStore.clearReferences();
+
+   markUpdated();
+}
+
+void RevisionsCache::beginUpdate()
+{
+   QMutexLocker lock(&mMutex);
+
+   ++mUpdateDepth;
+}
+
+void RevisionsCache::endUpdate()
+{
+   QMutexLocker lock(&mMutex);
+
+   if (--mUpdateDepth > 0)
+      return;
+
+   if (mUpdatePending)
+      markUpdated();
+   else if (mWipUpdatePending)
+      markWipUpdated();
+
+   mUpdatePending = false;
+   mWipUpdatePending = false;
+}
+
+void RevisionsCache::markUpdated()
+{
+   if (mUpdateDepth > 0)
    {
-      auto &commit = mCommitsMap[sha];
+      mUpdatePending = true;
+      return;
+   }
+
+   mGeneration.fetchAndAddOrdered(1);
 
-      commit.addReference(type, reference);
+   emit signalCacheUpdated();
+}
 
-      if (!mReferences.contains(&mCommitsMap[sha]))
-         mReferences.append(&mCommitsMap[sha]);
+void RevisionsCache::markWipUpdated()
+{
+   if (mUpdateDepth > 0)
+   {
+      mWipUpdatePending = true;
+      return;
    }
+
+   mWipGeneration.fetchAndAddOrdered(1);
+
+   emit signalCacheUpdated();
+}
+
+void RevisionsCache::setLazyGraph(bool lazyGraph)
+{
+   QMutexLocker lock(&mMutex);
+
+   mLazyGraph = lazyGraph;
 }
 
 void RevisionsCache::insertLocalBranchDistances(const QString &name, const LocalBranchDistances &distances)
@@ -235,47 +770,309 @@ void RevisionsCache::insertLocalBranchDistances(const QString &name, const Local
    mLocalBranchDistances[name] = distances;
 }
 
-void RevisionsCache::updateWipCommit(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache)
+bool RevisionsCache::getDistance(const QString &baseSha, const QString &sha, int &behind, int &ahead)
 {
+   QMutexLocker lock(&mMutex);
+
+   behind = 0;
+   ahead = 0;
+
+   const auto baseId = mStore.indexOf(baseSha);
+   const auto id = mStore.indexOf(sha);
+
+   if (baseId == -1 || id == -1)
+      return false;
+
+   enum Side : quint8
+   {
+      Base = 1,
+      Branch = 2,
+      Both = Base | Branch
+   };
+
+   // The rows are in date order, so when a commit is taken from the queue all its children in the walk have been
+   // visited. The walk ends when all the commits in the queue are reachable from both sides.
+   QHash<int, quint8> sides;
+   std::priority_queue<int, std::vector<int>, std::greater<int>> queue;
+   auto oneSideCommits = 0;
+
+   const auto visit = [&](int commitId, quint8 side) {
+      auto iter = sides.find(commitId);
+
+      if (iter == sides.end())
+      {
+         sides.insert(commitId, side);
+         queue.push(mRowsById.at(commitId));
+
+         if (side != Both)
+            ++oneSideCommits;
+      }
+      else if ((*iter | side) != *iter)
+      {
+         if (*iter != Both)
+            --oneSideCommits;
+
+         *iter |= side;
+
+         if (*iter != Both)
+            ++oneSideCommits;
+      }
+   };
+
+   visit(baseId, Base);
+   visit(id, Branch);
+
+   while (oneSideCommits > 0 && !queue.empty())
+   {
+      const auto commitId = mRows.at(queue.top());
+      queue.pop();
+
+      const auto side = sides.value(commitId);
+
+      if (side == Base)
+         ++behind;
+      else if (side == Branch)
+         ++ahead;
+
+      if (side != Both)
+         --oneSideCommits;
+
+      for (auto i = 0; i < mStore.parentsCount(commitId); ++i)
+      {
+         const auto parentId = mStore.parent(commitId, i);
+
+         // The history is not complete for this commit, so the result wouldn't be accurate.
+         if (parentId == -1)
+         {
+            if (side != Both)
+               return false;
+
+            continue;
+         }
+
+         visit(parentId, side);
+      }
+   }
+
+   return true;
+}
+
+void RevisionsCache::updateWipCommit(const QString &parentSha, const QString &status)
+{
+   QMutexLocker lock(&mMutex);
+
    if (mConfigured)
-      insertWipRevision(parentSha, diffIndex, diffIndexCache);
+   {
+      const auto previousParent = mWipCommit.parent(0);
+
+      mWorkTreeStatus.update(status);
+      insertWipRevision(parentSha);
+
+      // A new parent changes the row of the parent too.
+      if (mWipCommit.parent(0) != previousParent)
+         markUpdated();
+      else
+         markWipUpdated();
+   }
+}
+
+bool RevisionsCache::updateWipChanges(const QString &status, const QSet<QString> &dirs, const QSet<QString> &trees)
+{
+   QMutexLocker lock(&mMutex);
+
+   const auto parentSha = WorkTreeStatus::parseParentSha(status);
+
+   // A new HEAD changes the status of the whole work tree.
+   if (!mConfigured || !mWipCommit.isValid() || parentSha != mWipCommit.parent(0))
+      return false;
+
+   if (mWorkTreeStatus.update(status, dirs, trees))
+   {
+      insertWipRevision(parentSha);
+
+      markWipUpdated();
+   }
+
+   return true;
 }
 
 bool RevisionsCache::containsRevisionFile(const QString &sha1, const QString &sha2) const
 {
-   return mRevisionFilesMap.contains(qMakePair(sha1, sha2));
+   QMutexLocker lock(&mMutex);
+
+   return isWipRevisionFile(sha1, sha2) || mRevisionFiles.contains(qMakePair(sha1, sha2));
+}
+
+void RevisionsCache::setRevisionFilesBudget(qint64 maxBytes)
+{
+   QMutexLocker lock(&mMutex);
+
+   mRevisionFiles.setMaxBytes(maxBytes);
+}
+
+RevisionFilesCache::Stats RevisionsCache::getRevisionFilesStats() const
+{
+   QMutexLocker lock(&mMutex);
+
+   return mRevisionFiles.getStats();
 }
 
-QVector<Lane> RevisionsCache::calculateLanes(const CommitInfo &c)
+QVector<QPair<QString, QString>> RevisionsCache::getUncachedRevisionFiles(int firstRow, int lastRow) const
 {
-   const auto sha = c.sha();
+   QMutexLocker lock(&mMutex);
+   QVector<QPair<QString, QString>> revisions;
+
+   // The row 0 is the WIP, whose files are always available.
+   for (auto row = std::max(firstRow, 1); row <= std::min(lastRow, mRows.count()); ++row)
+   {
+      const auto id = mRows.at(row - 1);
+
+      if (mStore.parentsCount(id) == 0)
+         continue;
+
+      const auto key = qMakePair(mStore.sha(id), mStore.getParentIds(id).constFirst().toSha());
+
+      if (!mRevisionFiles.isStored(key))
+         revisions.append(key);
+   }
+
+   return revisions;
+}
+
+bool RevisionsCache::isWipRevisionFile(const QString &sha1, const QString &sha2) const
+{
+   return sha1 == CommitInfo::ZERO_SHA && mWipCommit.isValid() && mWipCommit.parentsCount() > 0
+       && sha2 == mWipCommit.parent(0);
+}
+
+void RevisionsCache::runLaneBenchmark(int branches, int commitsPerBranch)
+{
+   // The ids are written in the first bytes of the SHA, that are the ones used to hash it. The ids start at 1 since
+   // the all-zero SHA is the one of the WIP.
+   const auto toObjectId = [](int id) {
+      ObjectId sha;
+      memcpy(sha.bytes, &id, sizeof(id));
+      return sha;
+   };
+   const auto rootId = 1;
+   const auto commitId = [branches](int branch, int index) { return 2 + index * branches + branch; };
+
+   // The branches are interleaved so all of them stay active until the root commit. Some commits also merge the next
+   // commit of the neighbour branch, so the graph has forks and merges like a real history.
+   QVector<QPair<ObjectId, QVector<ObjectId>>> commits;
+   commits.reserve(branches * commitsPerBranch + 1);
+
+   for (auto index = 0; index < commitsPerBranch; ++index)
+   {
+      for (auto branch = 0; branch < branches; ++branch)
+      {
+         const auto isLast = index == commitsPerBranch - 1;
+         QVector<ObjectId> parents { toObjectId(isLast ? rootId : commitId(branch, index + 1)) };
 
-   QLog_Trace("Git", QString("Updating the lanes for SHA {%1}.").arg(sha));
+         if (!isLast && index % BENCHMARK_MERGE_INTERVAL == 0)
+            parents.append(toObjectId(commitId((branch + 1) % branches, index + 1)));
+
+         commits.append(qMakePair(toObjectId(commitId(branch, index)), parents));
+      }
+   }
+
+   commits.append(qMakePair(toObjectId(rootId), QVector<ObjectId>()));
+
+   // The SHAs are converted before starting the timer so only the lanes calculation is measured.
+   QVector<QPair<QString, QStringList>> legacyCommits;
+   legacyCommits.reserve(commits.count());
+
+   for (const auto &commit : qAsConst(commits))
+   {
+      QStringList parents;
+
+      for (const auto &parent : commit.second)
+         parents.append(parent.toSha());
+
+      legacyCommits.append(qMakePair(commit.first.toSha(), parents));
+   }
+
+   // The rows are too many to keep them, so both implementations are compared through a checksum of their lanes.
+   const auto addToChecksum = [](quint64 &checksum, const QVector<Lane> &row) {
+      for (const auto &lane : row)
+         checksum = checksum * 31 + static_cast<quint64>(lane.getType());
+
+      checksum = checksum * 31 + static_cast<quint64>(row.count());
+   };
+
+   LegacyLanes legacyLanes;
+   quint64 legacyChecksum = 0;
+   QElapsedTimer timer;
+   timer.start();
+
+   for (const auto &commit : qAsConst(legacyCommits))
+   {
+      if (legacyLanes.isEmpty())
+         legacyLanes.init(commit.first);
+
+      addToChecksum(legacyChecksum, calculateLegacyLanes(legacyLanes, commit.first, commit.second));
+   }
+
+   const auto legacyElapsed = std::max<qint64>(1, timer.elapsed());
+
+   Lanes lanes;
+   quint64 checksum = 0;
+   auto maxWidth = 0;
+   timer.restart();
+
+   for (const auto &commit : qAsConst(commits))
+   {
+      if (lanes.isEmpty())
+         lanes.init(commit.first);
+
+      const auto row = calculateLanes(lanes, commit.first, commit.second);
+      maxWidth = std::max(maxWidth, row.count());
+      addToChecksum(checksum, row);
+   }
+
+   const auto elapsed = std::max<qint64>(1, timer.elapsed());
+
+   QLog_Info("Git",
+             QString("Lane benchmark: {%1} commits with up to {%2} lanes. SHA strings: {%3} ms ({%4} commits/s). "
+                     "Binary SHAs: {%5} ms ({%6} commits/s).")
+                 .arg(commits.count())
+                 .arg(maxWidth)
+                 .arg(legacyElapsed)
+                 .arg(commits.count() * 1000 / legacyElapsed)
+                 .arg(elapsed)
+                 .arg(commits.count() * 1000 / elapsed));
+
+   if (checksum != legacyChecksum)
+      QLog_Error("Git", "Lane benchmark: the lanes differ from the ones calculated with SHA strings.");
+}
 
+QVector<Lane> RevisionsCache::calculateLanes(Lanes &lanes, const ObjectId &sha, const QVector<ObjectId> &parents)
+{
    bool isDiscontinuity;
-   bool isFork = mLanes.isFork(sha, isDiscontinuity);
-   bool isMerge = c.parentsCount() > 1;
+   bool isFork = lanes.isFork(sha, isDiscontinuity);
+   bool isMerge = parents.count() > 1;
 
    if (isDiscontinuity)
-      mLanes.changeActiveLane(sha); // uses previous isBoundary state
+      lanes.changeActiveLane(sha); // uses previous isBoundary state
 
    if (isFork)
-      mLanes.setFork(sha);
+      lanes.setFork(sha);
    if (isMerge)
-      mLanes.setMerge(c.parents());
-   if (c.parentsCount() == 0)
-      mLanes.setInitial();
+      lanes.setMerge(parents);
+   if (parents.isEmpty())
+      lanes.setInitial();
 
-   const auto lanes = mLanes.getLanes();
+   const auto rowLanes = lanes.getLanes();
 
-   resetLanes(c, isFork);
+   resetLanes(lanes, parents, isFork);
 
-   return lanes;
+   return rowLanes;
 }
 
-RevisionFiles RevisionsCache::parseDiffFormat(const QString &buf, FileNamesLoader &fl)
+RevisionFiles RevisionsCache::parseDiffFormat(const QString &buf)
 {
    RevisionFiles rf;
+   QSet<int> pathIds;
    auto parNum = 1;
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
@@ -297,30 +1094,14 @@ RevisionFiles RevisionsCache::parseDiffFormat(const QString &buf, FileNamesLoade
              * be RM or MR). For visualization purposes we could consider
              * the file as modified
              */
-            if (fl.rf != &rf)
-            {
-               flushFileNames(fl);
-               fl.rf = &rf;
-            }
-            appendFileName(line.section('\t', -1), fl);
-            rf.setStatus("M");
-            rf.mergeParent.append(parNum);
+            appendFileName(rf, pathIds, line.section('\t', -1), RevisionFiles::MODIFIED, parNum);
          }
          else
          {
             if (line.at(98) == '\t') // Faster parsing in normal case
-            {
-               if (fl.rf != &rf)
-               {
-                  flushFileNames(fl);
-                  fl.rf = &rf;
-               }
-               appendFileName(line.mid(99), fl);
-               rf.setStatus(line.at(97));
-               rf.mergeParent.append(parNum);
-            }
+               appendFileName(rf, pathIds, line.mid(99), RevisionFiles::toStatus(line.at(97)), parNum);
             else // It's a rename or a copy, we are not in fast path now!
-               setExtStatus(rf, line.mid(97), parNum, fl);
+               setExtStatus(rf, pathIds, line.mid(97), parNum);
          }
       }
       else
@@ -330,89 +1111,54 @@ RevisionFiles RevisionsCache::parseDiffFormat(const QString &buf, FileNamesLoade
    return rf;
 }
 
-void RevisionsCache::appendFileName(const QString &name, FileNamesLoader &fl)
+bool RevisionsCache::appendFileName(RevisionFiles &rf, QSet<int> &pathIds, const QString &name, int status,
+                                    int parNum)
 {
-   int idx = name.lastIndexOf('/') + 1;
-   const QString &dr = name.left(idx);
-   const QString &nm = name.mid(idx);
+   const auto pathId = PathTable::instance().intern(name);
+   const auto isNew = !pathIds.contains(pathId);
 
-   auto it = mDirNames.indexOf(dr);
-   if (it == -1)
+   // A file changed against several parents is shown only once.
+   if (isNew)
    {
-      int idx = mDirNames.count();
-      mDirNames.append(dr);
-      fl.rfDirs.append(idx);
+      pathIds.insert(pathId);
+      rf.appendFile(pathId, status, parNum);
    }
-   else
-      fl.rfDirs.append(it);
-
-   it = mFileNames.indexOf(nm);
-   if (it == -1)
-   {
-      int idx = mFileNames.count();
-      mFileNames.append(nm);
-      fl.rfNames.append(idx);
-   }
-   else
-      fl.rfNames.append(it);
-
-   fl.files.append(name);
-}
-
-void RevisionsCache::flushFileNames(FileNamesLoader &fl)
-{
-   if (!fl.rf)
-      return;
 
-   for (auto i = 0; i < fl.rfNames.count(); ++i)
-   {
-      const auto dirName = mDirNames.at(fl.rfDirs.at(i));
-      const auto fileName = mFileNames.at(fl.rfNames.at(i));
-
-      if (!fl.rf->mFiles.contains(dirName + fileName))
-         fl.rf->mFiles.append(dirName + fileName);
-   }
+   PathTable::instance().release(pathId);
 
-   fl.rfNames.clear();
-   fl.rfDirs.clear();
-   fl.rf = nullptr;
+   return isNew;
 }
 
 bool RevisionsCache::pendingLocalChanges()
 {
    QMutexLocker lock(&mMutex);
-   auto localChanges = false;
 
-   const auto commit = mCommitsMap.value(CommitInfo::ZERO_SHA, CommitInfo());
-
-   if (commit.isValid())
-   {
-      const auto rf = getRevisionFile(CommitInfo::ZERO_SHA, commit.parent(0));
-      localChanges = rf.count() - mUntrackedfiles.count() > 0;
-   }
-
-   return localChanges;
+   return mWipCommit.isValid()
+       && mWorkTreeStatus.getRevisionFiles().count() - mWorkTreeStatus.getUntrackedCount() > 0;
 }
 
 QVector<QPair<QString, QStringList>> RevisionsCache::getBranches(References::Type type)
 {
    QMutexLocker lock(&mMutex);
    QVector<QPair<QString, QStringList>> branches;
+   const auto references = mStore.getReferences();
 
-   for (auto commit : mReferences)
-      branches.append(QPair<QString, QStringList>(commit->sha(), commit->getReferences(type)));
+   for (auto iter = references.constBegin(); iter != references.constEnd(); ++iter)
+      branches.append(QPair<QString, QStringList>(mStore.sha(iter.key()), iter.value().getReferences(type)));
 
    return branches;
 }
 
 QMap<QString, QString> RevisionsCache::getTags() const
 {
+   QMutexLocker lock(&mMutex);
    QMap<QString, QString> tags;
+   const auto references = mStore.getReferences();
 
-   for (auto commit : mReferences)
+   for (auto iter = references.constBegin(); iter != references.constEnd(); ++iter)
    {
-      const auto sha = commit->sha();
-      const auto tagNames = commit->getReferences(References::Type::Tag);
+      const auto sha = mStore.sha(iter.key());
+      const auto tagNames = iter.value().getReferences(References::Type::Tag);
 
       for (const auto &tag : tagNames)
          tags[tag] = sha;
@@ -421,7 +1167,7 @@ QMap<QString, QString> RevisionsCache::getTags() const
    return tags;
 }
 
-void RevisionsCache::setExtStatus(RevisionFiles &rf, const QString &rowSt, int parNum, FileNamesLoader &fl)
+void RevisionsCache::setExtStatus(RevisionFiles &rf, QSet<int> &pathIds, const QString &rowSt, int parNum)
 {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
    const QStringList sl(rowSt.split('\t', Qt::SkipEmptyParts));
@@ -439,116 +1185,52 @@ void RevisionsCache::setExtStatus(RevisionFiles &rf, const QString &rowSt, int p
    const QString &dest = sl[2];
    const QString extStatusInfo(orig + " --> " + dest + " (" + QString::number(type.toInt()) + "%)");
 
-   /*
-    NOTE: we set rf.extStatus size equal to position of latest
-          copied/renamed file. So it can have size lower then
-          rf.count() if after copied/renamed file there are
-          others. Here we have no possibility to know final
-          dimension of this RefFile. We are still in parsing.
- */
-
    // simulate new file
-   if (fl.rf != &rf)
-   {
-      flushFileNames(fl);
-      fl.rf = &rf;
-   }
-   appendFileName(dest, fl);
-   rf.mergeParent.append(parNum);
-   rf.setStatus(RevisionFiles::NEW);
-   rf.appendExtStatus(extStatusInfo);
+   if (appendFileName(rf, pathIds, dest, RevisionFiles::NEW, parNum))
+      rf.setExtStatus(rf.count() - 1, extStatusInfo);
 
    // simulate deleted orig file only in case of rename
-   if (type.at(0) == 'R')
-   { // renamed file
-      if (fl.rf != &rf)
-      {
-         flushFileNames(fl);
-         fl.rf = &rf;
-      }
-      appendFileName(orig, fl);
-      rf.mergeParent.append(parNum);
-      rf.setStatus(RevisionFiles::DELETED);
-      rf.appendExtStatus(extStatusInfo);
-   }
-   rf.setOnlyModified(false);
-}
+   if (type.at(0) == 'R' && appendFileName(rf, pathIds, orig, RevisionFiles::DELETED, parNum))
+      rf.setExtStatus(rf.count() - 1, extStatusInfo);
 
-QVector<CommitInfo *>::const_iterator RevisionsCache::searchCommit(CommitInfo::Field field, const QString &text,
-                                                                   const int startingPoint) const
-{
-   return std::find_if(mCommits.constBegin() + startingPoint, mCommits.constEnd(),
-                       [field, text](CommitInfo *info) { return info->getFieldStr(field).contains(text); });
+   rf.setOnlyModified(false);
 }
 
-void RevisionsCache::resetLanes(const CommitInfo &c, bool isFork)
+bool RevisionsCache::commitMatches(const CommitInfo &commit, const QString &text)
 {
-   const auto nextSha = c.parentsCount() == 0 ? QString() : c.parent(0);
-
-   mLanes.nextParent(nextSha);
-
-   if (c.parentsCount() > 1)
-      mLanes.afterMerge();
-   if (isFork)
-      mLanes.afterFork();
-   if (mLanes.isBranch())
-      mLanes.afterBranch();
+   return commit.shortLog().contains(text, Qt::CaseInsensitive) || commit.longLog().contains(text, Qt::CaseInsensitive)
+       || commit.author().contains(text, Qt::CaseInsensitive) || commit.sha().contains(text, Qt::CaseInsensitive);
 }
 
-int RevisionsCache::count() const
+bool RevisionsCache::commitMatches(int id, const QString &text) const
 {
-   return mCommits.count();
+   return mStore.getFieldStr(id, CommitInfo::Field::SHORT_LOG).contains(text, Qt::CaseInsensitive)
+       || mStore.getFieldStr(id, CommitInfo::Field::LONG_LOG).contains(text, Qt::CaseInsensitive)
+       || mStore.author(id).contains(text, Qt::CaseInsensitive) || mStore.sha(id).contains(text, Qt::CaseInsensitive);
 }
 
-RevisionFiles RevisionsCache::fakeWorkDirRevFile(const QString &diffIndex, const QString &diffIndexCache)
+void RevisionsCache::resetLanes(Lanes &lanes, const QVector<ObjectId> &parents, bool isFork)
 {
-   FileNamesLoader fl;
-   auto rf = parseDiffFormat(diffIndex, fl);
-   fl.rf = &rf;
-   rf.setOnlyModified(false);
+   const auto nextSha = parents.isEmpty() ? ObjectId() : parents.first();
 
-   for (const auto &it : qAsConst(mUntrackedfiles))
-   {
-      if (fl.rf != &rf)
-      {
-         flushFileNames(fl);
-         fl.rf = &rf;
-      }
+   lanes.nextParent(nextSha);
 
-      appendFileName(it, fl);
-      rf.setStatus(RevisionFiles::UNKNOWN);
-      rf.mergeParent.append(1);
-   }
-
-   RevisionFiles cachedFiles = parseDiffFormat(diffIndexCache, fl);
-   flushFileNames(fl);
-
-   for (auto i = 0; i < rf.count(); i++)
-   {
-      if (cachedFiles.mFiles.indexOf(rf.getFile(i)) != -1)
-      {
-         if (cachedFiles.statusCmp(i, RevisionFiles::CONFLICT))
-            rf.appendStatus(i, RevisionFiles::CONFLICT);
-
-         rf.appendStatus(i, RevisionFiles::IN_INDEX);
-      }
-   }
-
-   return rf;
+   if (parents.count() > 1)
+      lanes.afterMerge();
+   if (isFork)
+      lanes.afterFork();
+   if (lanes.isBranch())
+      lanes.afterBranch();
 }
 
-RevisionFiles RevisionsCache::parseDiff(const QString &logDiff)
+int RevisionsCache::count() const
 {
-   FileNamesLoader fl;
-
-   auto rf = parseDiffFormat(logDiff, fl);
-   fl.rf = &rf;
-   flushFileNames(fl);
+   QMutexLocker lock(&mMutex);
 
-   return rf;
+   return mWipCommit.isValid() ? mRows.count() + 1 : 0;
 }
 
-void RevisionsCache::setUntrackedFilesList(const QVector<QString> &untrackedFiles)
+RevisionFiles RevisionsCache::parseDiff(const QString &logDiff)
 {
-   mUntrackedfiles = untrackedFiles;
+   return parseDiffFormat(logDiff);
 }
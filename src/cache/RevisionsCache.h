@@ -24,22 +24,27 @@
  ***************************************************************************************/
 
 #include <RevisionFiles.h>
+#include <RevisionFilesCache.h>
 #include <lanes.h>
 #include <CommitInfo.h>
+#include <CommitStore.h>
+#include <SearchIndex.h>
+#include <WorkTreeStatus.h>
 
 #include <QObject>
+#include <QAtomicInt>
 #include <QHash>
 #include <QMutex>
+#include <QSet>
 
 struct WorkingDirInfo;
 
 struct WipRevisionInfo
 {
    QString parentSha;
-   QString diffIndex;
-   QString diffIndexCached;
+   QString status; // Output of git status --porcelain=v2 -z --branch
 
-   bool isValid() const { return !parentSha.isEmpty() || !diffIndex.isEmpty() || !diffIndexCached.isEmpty(); }
+   bool isValid() const { return !parentSha.isEmpty() || !status.isEmpty(); }
 };
 
 class RevisionsCache : public QObject
@@ -58,30 +63,147 @@ public:
       int behindOrigin = 0;
    };
 
+   /**
+    * @brief The DisplayFields struct contains the fields of a commit that are shown in the history columns.
+    */
+   struct DisplayFields
+   {
+      ObjectId sha;
+      QString author;
+      qint64 date = 0;
+      QByteArray shortLog; // UTF-8
+   };
+
    explicit RevisionsCache(QObject *parent = nullptr);
    ~RevisionsCache();
 
    void setup(const WipRevisionInfo &wipInfo, const QList<QByteArray> &commits);
+   int appendCommits(const QList<QByteArray> &commits);
+   int prependCommits(const QList<QByteArray> &commits);
 
    int count() const;
+   /**
+    * @brief Gets the generation of the cache. It changes when the rows, the references or the parent of the WIP
+    * change, so the views can know without locking the cache if the data they keep is still valid. Appending commits
+    * doesn't change it since the rows that already exist are not modified.
+    *
+    * @return The generation.
+    */
+   int getGeneration() const { return mGeneration.loadAcquire(); }
+   /**
+    * @brief Gets the generation of the WIP. It changes when the local changes are updated but the rest of the rows are
+    * the same.
+    *
+    * @return The generation of the WIP.
+    */
+   int getWipGeneration() const { return mWipGeneration.loadAcquire(); }
+
+   /**
+    * @brief Enables the lazy graph mode. In this mode the lanes are not stored for every commit: only the state of the
+    * lanes every some rows is kept and the lanes of the rows are calculated when they are requested through
+    * getCommitInfoByRow. It must be set before loading the repository.
+    *
+    * @param lazyGraph True to enable the lazy mode.
+    */
+   void setLazyGraph(bool lazyGraph);
+   bool isLazyGraph() const { return mLazyGraph; }
+   /**
+    * @brief Calculates the lanes of a synthetic history with many branches active at the same time, both with the
+    * current implementation and with the original one based on SHA strings, and writes the time they take in the log.
+    *
+    * @param branches The number of branches of the synthetic history, that is the width of the graph.
+    * @param commitsPerBranch The number of commits of every branch.
+    */
+   static void runLaneBenchmark(int branches, int commitsPerBranch);
 
    CommitInfo getCommitInfo(const QString &sha);
    CommitInfo getCommitInfoByRow(int row);
+   /**
+    * @brief Gets the view of the commit in the given row. It's cheaper than getCommitInfoByRow since the texts of the
+    * commit are not decoded.
+    * @param row The row of the commit. The row 0 is the WIP.
+    * @return The view of the commit or an invalid view if the row doesn't exist.
+    */
+   CommitView getCommitViewByRow(int row);
+   /**
+    * @brief Gets a field of the commit in the given row without building the whole commit.
+    *
+    * @param row The row of the commit.
+    * @param field The field to get.
+    * @return The value of the field or an empty string if the row doesn't exist.
+    */
+   QString getCommitField(int row, CommitInfo::Field field);
+   /**
+    * @brief Gets the fields shown in the history columns for the commits in a range of rows locking the cache only
+    * once. It's meant to build the display data in bulk.
+    *
+    * @param firstRow The first row.
+    * @param count The number of rows.
+    * @return The fields of every row in the range that exists.
+    */
+   QVector<DisplayFields> getDisplayFields(int firstRow, int count);
    int getCommitPos(const QString &sha);
-   CommitInfo getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint = 0);
+   /**
+    * @brief Finds all the commits whose subject, body, author or SHA contain the text, ignoring the case. The commits
+    * already indexed are looked up in the search index and the rest are checked one by one.
+    *
+    * @param text The text to search.
+    * @return The rows of the matching commits in ascending order.
+    */
+   QVector<int> searchCommits(const QString &text);
+   /**
+    * @brief Adds to the search index the commits that are not indexed yet. The cache is locked for every chunk of
+    * commits, so it can run in the background while the cache is used.
+    *
+    * @param maxCommits The maximum number of commits to index in this call.
+    * @return The number of commits that are still not indexed.
+    */
+   int updateSearchIndex(int maxCommits);
+   /**
+    * @brief Gets the rows of the commits of the given SHAs. The SHAs that are not in the cache are ignored.
+    *
+    * @param shas The SHAs.
+    * @return The rows in ascending order.
+    */
+   QVector<int> getRows(const QStringList &shas);
+   /**
+    * @brief Keeps the rows whose commits contain the text in their subject, body, author or SHA, ignoring the case.
+    *
+    * @param rows The rows to check in ascending order.
+    * @param text The text to search.
+    * @return The matching rows in ascending order.
+    */
+   QVector<int> filterRows(const QVector<int> &rows, const QString &text);
    RevisionFiles getRevisionFile(const QString &sha1, const QString &sha2) const;
 
    bool insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file);
    void insertReference(const QString &sha, References::Type type, const QString &reference);
+   void clearReferences();
    void insertLocalBranchDistances(const QString &name, const LocalBranchDistances &distances);
    LocalBranchDistances getLocalBranchDistances(const QString &name) { return mLocalBranchDistances.value(name); }
-   void updateWipCommit(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache);
+   bool getDistance(const QString &baseSha, const QString &sha, int &behind, int &ahead);
+   void updateWipCommit(const QString &parentSha, const QString &status);
+   bool updateWipChanges(const QString &status, const QSet<QString> &dirs, const QSet<QString> &trees);
 
    bool containsRevisionFile(const QString &sha1, const QString &sha2) const;
 
+   /**
+    * @brief Sets the memory budget for the files of the revisions. The files of the WIP are not part of it.
+    * @param maxBytes The budget in bytes.
+    */
+   void setRevisionFilesBudget(qint64 maxBytes);
+   RevisionFilesCache::Stats getRevisionFilesStats() const;
+   /**
+    * @brief Gets the commits between two rows of the graph whose files against their first parent are not cached.
+    *
+    * @param firstRow The first row.
+    * @param lastRow The last row, included.
+    * @return The pairs of commit and parent SHAs.
+    */
+   QVector<QPair<QString, QString>> getUncachedRevisionFiles(int firstRow, int lastRow) const;
+
    RevisionFiles parseDiff(const QString &logDiff);
 
-   void setUntrackedFilesList(const QVector<QString> &untrackedFiles);
    bool pendingLocalChanges();
 
    QVector<QPair<QString, QStringList>> getBranches(References::Type type);
@@ -89,43 +211,61 @@ public:
 
 private:
    friend class GitRepoLoader;
+   friend class CacheSnapshot;
 
-   QMutex mMutex;
+   mutable QMutex mMutex;
+   QAtomicInt mGeneration;
+   QAtomicInt mWipGeneration;
+   // The updates are notified once the outermost batch ends.
+   int mUpdateDepth = 0;
+   bool mUpdatePending = false;
+   bool mWipUpdatePending = false;
    bool mConfigured = true;
-   QVector<CommitInfo *> mCommits;
-   QHash<QString, CommitInfo> mCommitsMap;
-   QMultiMap<QString, CommitInfo *> mTmpChildsStorage;
-   QHash<QPair<QString, QString>, RevisionFiles> mRevisionFilesMap;
-   QVector<CommitInfo *> mReferences;
+   bool mLazyGraph = false;
+   CommitStore mStore;
+   CommitInfo mWipCommit;
+   // The ids in the store of the commits as they are shown in the graph. The WIP is always the row 0 and it's not
+   // part of the store.
+   QVector<int> mRows;
+   QVector<int> mRowsById;
+   // The lookups update the recency of the entries.
+   mutable RevisionFilesCache mRevisionFiles;
    QMap<QString, LocalBranchDistances> mLocalBranchDistances;
    Lanes mLanes;
-   QVector<QString> mDirNames;
-   QVector<QString> mFileNames;
-   QVector<QString> mUntrackedfiles;
-
-   struct FileNamesLoader
-   {
-      FileNamesLoader()
-         : rf(nullptr)
-      {
-      }
-
-      RevisionFiles *rf;
-      QVector<int> rfDirs;
-      QVector<int> rfNames;
-      QVector<QString> files;
-   };
+   // Sorted by row: after an incremental update the checkpoints are shifted and they are not aligned to the interval.
+   QMap<int, Lanes> mLaneCheckpoints;
+   QHash<int, QVector<QVector<Lane>>> mLaneBlocks;
+   // The commits of the store already written in the snapshot, -1 if the snapshot must be written from scratch.
+   int mSnapshotCommits = -1;
+   // The rows at the top of the graph whose lanes changed since the snapshot was written.
+   int mSnapshotLaneRows = 0;
+   QList<int> mLaneBlocksUsage;
+   WorkTreeStatus mWorkTreeStatus;
+   SearchIndex mSearchIndex;
 
    void setConfigurationDone() { mConfigured = true; }
-   void insertCommitInfo(CommitInfo rev, int orderIdx);
-   void insertWipRevision(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache);
-   RevisionFiles fakeWorkDirRevFile(const QString &diffIndex, const QString &diffIndexCache);
-   QVector<Lane> calculateLanes(const CommitInfo &c);
-   RevisionFiles parseDiffFormat(const QString &buf, FileNamesLoader &fl);
-   void appendFileName(const QString &name, FileNamesLoader &fl);
-   void flushFileNames(FileNamesLoader &fl);
-   void setExtStatus(RevisionFiles &rf, const QString &rowSt, int parNum, FileNamesLoader &fl);
-   QVector<CommitInfo *>::const_iterator searchCommit(CommitInfo::Field field, const QString &text,
-                                                      int startingPoint = 0) const;
-   void resetLanes(const CommitInfo &c, bool isFork);
+   /**
+    * @brief Starts a batch of changes that is notified as a single update when it ends. The batches can be nested.
+    */
+   void beginUpdate();
+   void endUpdate();
+   void markUpdated();
+   void markWipUpdated();
+   void insertCommitInfo(CommitInfo rev);
+   void storeCommitInfo(CommitInfo rev);
+   CommitInfo buildCommitInfo(int id) const;
+   int findCommitId(const QString &sha) const;
+   void recalculateLanes(int insertedRows);
+   QVector<Lane> getLazyLanes(int row);
+   void calculateLanesBlock(int block);
+   QVector<Lane> calculateRowLanes(Lanes &lanes, int row);
+   void insertWipRevision(const QString &parentSha);
+   bool isWipRevisionFile(const QString &sha1, const QString &sha2) const;
+   static QVector<Lane> calculateLanes(Lanes &lanes, const ObjectId &sha, const QVector<ObjectId> &parents);
+   static RevisionFiles parseDiffFormat(const QString &buf);
+   static bool appendFileName(RevisionFiles &rf, QSet<int> &pathIds, const QString &name, int status, int parNum);
+   static void setExtStatus(RevisionFiles &rf, QSet<int> &pathIds, const QString &rowSt, int parNum);
+   static bool commitMatches(const CommitInfo &commit, const QString &text);
+   bool commitMatches(int id, const QString &text) const;
+   static void resetLanes(Lanes &lanes, const QVector<ObjectId> &parents, bool isFork);
 };
@@ -0,0 +1,132 @@
+#include "SearchIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+quint64 trigramKey(const QChar *chars)
+{
+   return static_cast<quint64>(chars[0].unicode()) << 32 | static_cast<quint64>(chars[1].unicode()) << 16
+       | chars[2].unicode();
+}
+
+void appendVarint(QByteArray &data, quint32 value)
+{
+   while (value >= 0x80)
+   {
+      data.append(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+   }
+
+   data.append(static_cast<char>(value));
+}
+}
+
+void SearchIndex::clear()
+{
+   mPostings.clear();
+   mCount = 0;
+}
+
+void SearchIndex::append(const QStringList &texts)
+{
+   const auto id = mCount++;
+   QVector<quint64> trigrams;
+
+   for (const auto &text : texts)
+      appendTrigrams(text, trigrams);
+
+   std::sort(trigrams.begin(), trigrams.end());
+   trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+   for (const auto trigram : qAsConst(trigrams))
+   {
+      auto &postings = mPostings[trigram];
+      appendVarint(postings.deltas, static_cast<quint32>(id - postings.lastId));
+      postings.lastId = id;
+      ++postings.count;
+   }
+}
+
+QVector<int> SearchIndex::findCandidates(const QString &text) const
+{
+   QVector<quint64> trigrams;
+   appendTrigrams(text, trigrams);
+
+   std::sort(trigrams.begin(), trigrams.end());
+   trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+   QVector<const Postings *> lists;
+   lists.reserve(trigrams.count());
+
+   for (const auto trigram : qAsConst(trigrams))
+   {
+      const auto iter = mPostings.constFind(trigram);
+
+      if (iter == mPostings.constEnd())
+         return QVector<int>();
+
+      lists.append(&iter.value());
+   }
+
+   if (lists.isEmpty())
+      return QVector<int>();
+
+   // Starting by the rarest trigram keeps the intersections small.
+   std::sort(lists.begin(), lists.end(),
+             [](const Postings *first, const Postings *second) { return first->count < second->count; });
+
+   auto candidates = decode(*lists.constFirst());
+
+   for (auto i = 1; i < lists.count() && !candidates.isEmpty(); ++i)
+   {
+      const auto ids = decode(*lists.at(i));
+      QVector<int> intersection;
+      intersection.reserve(candidates.count());
+
+      std::set_intersection(candidates.cbegin(), candidates.cend(), ids.cbegin(), ids.cend(),
+                            std::back_inserter(intersection));
+
+      candidates = std::move(intersection);
+   }
+
+   return candidates;
+}
+
+void SearchIndex::appendTrigrams(const QString &text, QVector<quint64> &trigrams)
+{
+   const auto folded = text.toCaseFolded();
+   const auto chars = folded.constData();
+
+   for (auto i = 0; i + MIN_QUERY_LENGTH <= folded.size(); ++i)
+      trigrams.append(trigramKey(chars + i));
+}
+
+QVector<int> SearchIndex::decode(const Postings &postings)
+{
+   QVector<int> ids;
+   ids.reserve(postings.count);
+
+   const auto data = reinterpret_cast<const uchar *>(postings.deltas.constData());
+   const auto size = postings.deltas.size();
+   auto id = -1;
+
+   for (auto i = 0; i < size;)
+   {
+      quint32 delta = 0;
+      auto shift = 0;
+
+      while (data[i] & 0x80)
+      {
+         delta |= static_cast<quint32>(data[i++] & 0x7F) << shift;
+         shift += 7;
+      }
+
+      delta |= static_cast<quint32>(data[i++]) << shift;
+      id += static_cast<int>(delta);
+      ids.append(id);
+   }
+
+   return ids;
+}
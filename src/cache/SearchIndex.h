@@ -0,0 +1,88 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief The SearchIndex class is a trigram inverted index over the texts of the commits. For every sequence of three
+ * characters it keeps the ids of the commits that contain it, so a search only needs to check the commits that have
+ * all the trigrams of the query instead of every commit of the repository.
+ *
+ * The texts are case folded and the ids are stored as delta-encoded varints to keep the memory low. The ids must be
+ * appended in order, starting from 0.
+ *
+ * The class is not thread-safe: the owner is in charge of the synchronization.
+ */
+class SearchIndex
+{
+public:
+   /**
+    * @brief The minimum length of a query to use the index. Shorter queries must be searched without it.
+    */
+   static constexpr int MIN_QUERY_LENGTH = 3;
+
+   /**
+    * @brief Gets the number of commits indexed. They are the ids from 0 to count() - 1.
+    *
+    * @return The number of commits.
+    */
+   int count() const { return mCount; }
+   /**
+    * @brief Removes all the commits from the index.
+    */
+   void clear();
+   /**
+    * @brief Indexes the texts of the next commit. Its id is the current count().
+    *
+    * @param texts The texts of the commit, such as the subject or the author.
+    */
+   void append(const QStringList &texts);
+   /**
+    * @brief Finds the commits that contain all the trigrams of the text. The texts of the candidates must be checked
+    * since the trigrams could be in different positions or different texts of the commit.
+    *
+    * @param text The text to search. It must have at least MIN_QUERY_LENGTH characters.
+    * @return The ids of the candidates sorted in ascending order.
+    */
+   QVector<int> findCandidates(const QString &text) const;
+
+private:
+   struct Postings
+   {
+      QByteArray deltas;
+      int lastId = -1;
+      int count = 0;
+   };
+
+   QHash<quint64, Postings> mPostings;
+   int mCount = 0;
+
+   static void appendTrigrams(const QString &text, QVector<quint64> &trigrams);
+   static QVector<int> decode(const Postings &postings);
+};
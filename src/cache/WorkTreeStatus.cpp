@@ -0,0 +1,205 @@
+#include "WorkTreeStatus.h"
+
+#include <PathTable.h>
+
+#include <QVector>
+
+#include <algorithm>
+
+namespace
+{
+// Amount of fields before the path in the records of the porcelain v2 format.
+constexpr int ORDINARY_FIELDS = 8;
+constexpr int RENAMED_FIELDS = 9;
+constexpr int UNMERGED_FIELDS = 10;
+
+const QString BRANCH_OID_HEADER = "# branch.oid ";
+
+QString recordPath(const QString &record, int fields)
+{
+   auto pos = -1;
+
+   for (auto i = 0; i < fields; ++i)
+   {
+      pos = record.indexOf(' ', pos + 1);
+
+      if (pos == -1)
+         return QString();
+   }
+
+   return record.mid(pos + 1);
+}
+
+// The WIP shows the status of the work tree against HEAD, flagging the files with staged changes.
+int statusFlags(QChar indexStatus, QChar workTreeStatus)
+{
+   auto flags = 0;
+
+   if (indexStatus == 'A')
+      flags = RevisionFiles::NEW;
+   else if (indexStatus == 'D' || workTreeStatus == 'D')
+      flags = RevisionFiles::DELETED;
+   else
+      flags = RevisionFiles::MODIFIED;
+
+   if (indexStatus != '.')
+      flags |= RevisionFiles::IN_INDEX;
+
+   return flags;
+}
+
+bool isAffected(const QString &path, const QSet<QString> &dirs, const QSet<QString> &trees)
+{
+   const auto separator = path.lastIndexOf('/');
+
+   if (dirs.contains(separator == -1 ? QString() : path.left(separator)))
+      return true;
+
+   for (const auto &tree : trees)
+   {
+      if (path.length() > tree.length() && path.startsWith(tree) && path.at(tree.length()) == '/')
+         return true;
+   }
+
+   return false;
+}
+}
+
+WorkTreeStatus::WorkTreeStatus()
+{
+   mFiles.setOnlyModified(false);
+}
+
+void WorkTreeStatus::clear()
+{
+   mPositions.clear();
+   mFiles = RevisionFiles();
+   mFiles.setOnlyModified(false);
+   mUntrackedCount = 0;
+}
+
+bool WorkTreeStatus::update(const QString &status)
+{
+   return applyDelta(parse(status), nullptr, nullptr);
+}
+
+bool WorkTreeStatus::update(const QString &status, const QSet<QString> &dirs, const QSet<QString> &trees)
+{
+   return applyDelta(parse(status), &dirs, &trees);
+}
+
+QString WorkTreeStatus::parseParentSha(const QString &status)
+{
+   if (!status.startsWith(BRANCH_OID_HEADER))
+      return QString();
+
+   const auto end = status.indexOf(QChar('\0'));
+   const auto sha = status.mid(BRANCH_OID_HEADER.length(), end - BRANCH_OID_HEADER.length());
+
+   // A repository without commits reports "(initial)".
+   return sha.startsWith('(') ? QString() : sha;
+}
+
+QVector<QPair<QString, int>> WorkTreeStatus::parse(const QString &status)
+{
+   QVector<QPair<QString, int>> entries;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   const auto records = status.split(QChar('\0'), Qt::SkipEmptyParts);
+#else
+   const auto records = status.split(QChar('\0'), QString::SkipEmptyParts);
+#endif
+
+   for (auto i = 0; i < records.count(); ++i)
+   {
+      const auto &record = records.at(i);
+
+      switch (record.at(0).toLatin1())
+      {
+         case '1':
+            entries.append({ recordPath(record, ORDINARY_FIELDS), statusFlags(record.at(2), record.at(3)) });
+            break;
+         case '2':
+            entries.append({ recordPath(record, RENAMED_FIELDS), RevisionFiles::NEW | RevisionFiles::IN_INDEX });
+
+            // The original path comes as the next record. It's gone from the index if the file was renamed.
+            if (++i < records.count() && record.at(2) == 'R')
+               entries.append({ records.at(i), RevisionFiles::DELETED | RevisionFiles::IN_INDEX });
+            break;
+         case 'u':
+            entries.append({ recordPath(record, UNMERGED_FIELDS),
+                             RevisionFiles::MODIFIED | RevisionFiles::CONFLICT | RevisionFiles::IN_INDEX });
+            break;
+         case '?':
+            entries.append({ record.mid(2), RevisionFiles::UNKNOWN });
+            break;
+         default: // Headers and ignored files
+            break;
+      }
+   }
+
+   return entries;
+}
+
+bool WorkTreeStatus::applyDelta(const QVector<QPair<QString, int>> &entries, const QSet<QString> *dirs,
+                                const QSet<QString> *trees)
+{
+   auto changed = false;
+   QSet<int> reported;
+   reported.reserve(entries.count());
+
+   for (const auto &entry : entries)
+   {
+      const auto pathId = PathTable::instance().intern(entry.first);
+
+      reported.insert(pathId);
+
+      const auto isUntracked = entry.second == RevisionFiles::UNKNOWN;
+
+      if (const auto pos = mPositions.value(pathId, -1); pos == -1)
+      {
+         mPositions.insert(pathId, mFiles.count());
+         mFiles.appendFile(pathId, entry.second);
+         mUntrackedCount += isUntracked ? 1 : 0;
+         changed = true;
+      }
+      else if (const auto previous = mFiles.getStatus(pos); previous != entry.second)
+      {
+         mUntrackedCount += (isUntracked ? 1 : 0) - (previous == RevisionFiles::UNKNOWN ? 1 : 0);
+         mFiles.setFileStatus(pos, entry.second);
+         changed = true;
+      }
+
+      // Every reported file is stored and keeps its own reference.
+      PathTable::instance().release(pathId);
+   }
+
+   // The files that are not reported anymore have no changes.
+   QVector<int> removed;
+
+   for (auto it = mPositions.cbegin(); it != mPositions.cend(); ++it)
+   {
+      if (!reported.contains(it.key())
+          && (!dirs || isAffected(PathTable::instance().path(it.key()), *dirs, *trees)))
+         removed.append(it.value());
+   }
+
+   if (!removed.isEmpty())
+   {
+      std::sort(removed.begin(), removed.end());
+
+      for (const auto pos : qAsConst(removed))
+         mUntrackedCount -= mFiles.getStatus(pos) == RevisionFiles::UNKNOWN ? 1 : 0;
+
+      mFiles.removeFiles(removed);
+
+      mPositions.clear();
+
+      for (auto i = 0; i < mFiles.count(); ++i)
+         mPositions.insert(mFiles.getPathId(i), i);
+
+      changed = true;
+   }
+
+   return changed;
+}
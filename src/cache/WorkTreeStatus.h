@@ -0,0 +1,88 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <RevisionFiles.h>
+
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The WorkTreeStatus class keeps the status of the work tree as reported by
+ * "git status --porcelain=v2 -z --branch" and the RevisionFiles of the WIP built from it.
+ *
+ * Every update is compared against the previous snapshot and only the files whose status changed are modified in the
+ * RevisionFiles. A partial update only replaces the files under the given directories.
+ */
+class WorkTreeStatus
+{
+public:
+   WorkTreeStatus();
+
+   /**
+    * @brief clear Removes all the files of the snapshot.
+    */
+   void clear();
+
+   /**
+    * @brief update Replaces the snapshot with a full status output.
+    *
+    * @param status The output of git status.
+    * @return True if any file changed, otherwise false.
+    */
+   bool update(const QString &status);
+
+   /**
+    * @brief update Replaces the files under the given directories with the output of a git status limited to them.
+    *
+    * @param status The output of git status.
+    * @param dirs The directories, relative to the work tree, whose direct files were queried.
+    * @param trees The directories, relative to the work tree, whose whole content was queried.
+    * @return True if any file changed, otherwise false.
+    */
+   bool update(const QString &status, const QSet<QString> &dirs, const QSet<QString> &trees);
+
+   /**
+    * @brief parseParentSha Gets the SHA of HEAD from a status output.
+    *
+    * @param status The output of git status.
+    * @return The SHA or an empty string if HEAD doesn't point to a commit yet.
+    */
+   static QString parseParentSha(const QString &status);
+
+   const RevisionFiles &getRevisionFiles() const { return mFiles; }
+   int getUntrackedCount() const { return mUntrackedCount; }
+
+private:
+   // Position in the RevisionFiles of every path id.
+   QHash<int, int> mPositions;
+   RevisionFiles mFiles;
+   int mUntrackedCount = 0;
+
+   static QVector<QPair<QString, int>> parse(const QString &status);
+   bool applyDelta(const QVector<QPair<QString, int>> &entries, const QSet<QString> *dirs, const QSet<QString> *trees);
+};
@@ -8,30 +8,50 @@
 */
 #include "lanes.h"
 
-#include <QStringList>
-
-void Lanes::init(const QString &expectedSha)
+void Lanes::init(const ObjectId &expectedSha)
 {
    clear();
    activeLane = 0;
    add(LaneType::BRANCH, expectedSha, activeLane);
 }
 
+bool Lanes::operator==(const Lanes &lanes) const
+{
+   return activeLane == lanes.activeLane && typeVec == lanes.typeVec && nextShaVec == lanes.nextShaVec;
+}
+
+void Lanes::restore(int active, const QVector<Lane> &lanes, const QVector<ObjectId> &nextShas)
+{
+   clear();
+   activeLane = active;
+   typeVec = lanes;
+   nextShaVec = nextShas;
+
+   for (auto pos = 0; pos < nextShaVec.count(); ++pos)
+   {
+      auto &shaLane = shaLanes[nextShaVec.at(pos)];
+
+      if (shaLane.count++ == 0)
+         shaLane.first = pos;
+   }
+}
+
 void Lanes::clear()
 {
    typeVec.clear();
    nextShaVec.clear();
+   shaLanes.clear();
 }
 
-bool Lanes::isFork(const QString &sha, bool &isDiscontinuity)
+bool Lanes::isFork(const ObjectId &sha, bool &isDiscontinuity)
 {
-   int pos = findNextSha(sha, 0);
-   isDiscontinuity = activeLane != pos;
+   const auto lanes = shaLanes.value(sha);
+   isDiscontinuity = activeLane != lanes.first;
 
-   return pos == -1 ? false : findNextSha(sha, pos + 1) != -1;
+   return lanes.count > 1;
 }
 
-void Lanes::setFork(const QString &sha)
+void Lanes::setFork(const ObjectId &sha)
 {
    auto rangeEnd = 0;
    auto idx = 0;
@@ -77,7 +97,7 @@ void Lanes::setFork(const QString &sha)
    }
 }
 
-void Lanes::setMerge(const QStringList &parents)
+void Lanes::setMerge(const QVector<ObjectId> &parents)
 {
    auto &t = typeVec[activeLane];
    auto wasFork = t.equals(NODE);
@@ -90,7 +110,7 @@ void Lanes::setMerge(const QStringList &parents)
 
    auto rangeStart = activeLane;
    auto rangeEnd = activeLane;
-   QStringList::const_iterator it(parents.constBegin());
+   auto it = parents.constBegin();
 
    for (++it; it != parents.constEnd(); ++it)
    { // skip first parent
@@ -158,7 +178,7 @@ void Lanes::setInitial()
       t.setType(LaneType::INITIAL);
 }
 
-void Lanes::changeActiveLane(const QString &sha)
+void Lanes::changeActiveLane(const ObjectId &sha)
 {
    auto &t = typeVec[activeLane];
 
@@ -208,6 +228,7 @@ void Lanes::afterFork()
 
    while (typeVec.last().equals(LaneType::EMPTY))
    {
+      removeNextSha(nextShaVec.count() - 1);
       typeVec.pop_back();
       nextShaVec.pop_back();
    }
@@ -223,13 +244,25 @@ void Lanes::afterBranch()
    typeVec[activeLane].setType(LaneType::ACTIVE); // TODO test with boundaries
 }
 
-void Lanes::nextParent(const QString &sha)
+void Lanes::nextParent(const ObjectId &sha)
 {
-   nextShaVec[activeLane] = sha;
+   setNextSha(activeLane, sha);
 }
 
-int Lanes::findNextSha(const QString &next, int pos)
+int Lanes::findNextSha(const ObjectId &next, int pos)
 {
+   const auto lanes = shaLanes.value(next);
+
+   if (lanes.count == 0)
+      return -1;
+
+   if (pos <= lanes.first)
+      return lanes.first;
+
+   if (lanes.count == 1)
+      return -1;
+
+   // Only forks have the same sha1 in several lanes.
    for (int i = pos; i < nextShaVec.count(); i++)
    {
       if (nextShaVec[i] == next)
@@ -252,7 +285,7 @@ int Lanes::findType(const LaneType type, int pos)
    return -1;
 }
 
-int Lanes::add(const LaneType type, const QString &next, int pos)
+int Lanes::add(const LaneType type, const ObjectId &next, int pos)
 {
    // first check empty lanes starting from pos
    if (pos < typeVec.count())
@@ -261,7 +294,7 @@ int Lanes::add(const LaneType type, const QString &next, int pos)
       if (pos != -1)
       {
          typeVec[pos].setType(type);
-         nextShaVec[pos] = next;
+         setNextSha(pos, next);
          return pos;
       }
    }
@@ -269,9 +302,51 @@ int Lanes::add(const LaneType type, const QString &next, int pos)
    // if all lanes are occupied add a new lane
    typeVec.append(type);
    nextShaVec.append(next);
+
+   auto &lanes = shaLanes[next];
+
+   if (lanes.count++ == 0)
+      lanes.first = nextShaVec.count() - 1;
+
    return typeVec.count() - 1;
 }
 
+void Lanes::setNextSha(int pos, const ObjectId &next)
+{
+   if (nextShaVec[pos] == next)
+      return;
+
+   removeNextSha(pos);
+
+   nextShaVec[pos] = next;
+
+   auto &lanes = shaLanes[next];
+
+   if (lanes.count++ == 0 || pos < lanes.first)
+      lanes.first = pos;
+}
+
+void Lanes::removeNextSha(int pos)
+{
+   const auto sha = nextShaVec[pos];
+   auto iter = shaLanes.find(sha);
+
+   if (iter == shaLanes.end())
+      return;
+
+   if (--iter->count == 0)
+      shaLanes.erase(iter);
+   else if (iter->first == pos)
+   {
+      auto next = pos + 1;
+
+      while (nextShaVec[next] != sha)
+         ++next;
+
+      iter->first = next;
+   }
+}
+
 bool Lanes::isNode(Lane lane) const
 {
    return lane.equals(NODE) || lane.equals(NODE_R) || lane.equals(NODE_L);
@@ -7,15 +7,17 @@
 #ifndef LANES_H
 #define LANES_H
 
-#include <QString>
+#include <QHash>
 #include <QVector>
 
 #include <LaneType.h>
 #include <Lane.h>
+#include <ObjectId.h>
 
 //
 //  At any given time, the Lanes class represents a single revision (row) of the history graph.
-//  The Lanes class contains a vector of the sha1 hashes of the next commit to appear in each lane (column).
+//  The Lanes class contains a vector of the sha1 hashes of the next commit to appear in each lane (column), and an
+//  index of the lanes that expect each hash so the lookups don't depend on the number of lanes.
 //  The Lanes class also contains a vector used to decide which glyph to draw on the history graph.
 //
 //  For each revision (row) (from recent (top) to ancient past (bottom)), the Lanes class is updated, and the
@@ -28,31 +30,44 @@ class Lanes
 {
 public:
    Lanes() { } // init() will setup us later, when data is available
+   bool operator==(const Lanes &lanes) const;
    bool isEmpty() { return typeVec.empty(); }
-   void init(const QString &expectedSha);
+   void init(const ObjectId &expectedSha);
    void clear();
-   bool isFork(const QString &sha, bool &isDiscontinuity);
-   void setFork(const QString &sha);
-   void setMerge(const QStringList &parents);
+   bool isFork(const ObjectId &sha, bool &isDiscontinuity);
+   void setFork(const ObjectId &sha);
+   void setMerge(const QVector<ObjectId> &parents);
    void setInitial();
-   void changeActiveLane(const QString &sha);
+   void changeActiveLane(const ObjectId &sha);
    void afterMerge();
    void afterFork();
    bool isBranch();
    void afterBranch();
-   void nextParent(const QString &sha);
+   void nextParent(const ObjectId &sha);
    void setLanes(QVector<Lane> &ln) { ln = typeVec; } // O(1) vector is implicitly shared
    QVector<Lane> getLanes() const { return typeVec; }
+   int getActiveLane() const { return activeLane; }
+   QVector<ObjectId> getNextShas() const { return nextShaVec; }
+   void restore(int active, const QVector<Lane> &lanes, const QVector<ObjectId> &nextShas);
 
 private:
-   int findNextSha(const QString &next, int pos);
+   struct ShaLanes
+   {
+      int first = -1; // The first lane that expects the sha1.
+      int count = 0; // The number of lanes that expect the sha1.
+   };
+
+   int findNextSha(const ObjectId &next, int pos);
    int findType(LaneType type, int pos);
-   int add(LaneType type, const QString &next, int pos);
+   int add(LaneType type, const ObjectId &next, int pos);
+   void setNextSha(int pos, const ObjectId &next);
+   void removeNextSha(int pos);
    bool isNode(Lane lane) const;
 
-   int activeLane;
+   int activeLane = 0;
    QVector<Lane> typeVec; // Describes which glyphs should be drawn.
-   QVector<QString> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
+   QVector<ObjectId> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
+   QHash<ObjectId, ShaLanes> shaLanes; // The lanes where each sha1 of nextShaVec is.
    LaneType NODE = LaneType::MERGE_FORK;
    LaneType NODE_R = LaneType::MERGE_FORK_R;
    LaneType NODE_L = LaneType::MERGE_FORK_L;
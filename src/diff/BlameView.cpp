@@ -0,0 +1,362 @@
+#include "BlameView.h"
+
+#include <GitQlientStyles.h>
+
+#include <QFontMetrics>
+#include <QHelpEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QToolTip>
+
+#include <algorithm>
+
+namespace
+{
+constexpr int CELL_PADDING = 5;
+constexpr int ROW_PADDING = 3;
+constexpr int AUTHOR_PADDING = 15;
+constexpr int AGE_GUIDE_WIDTH = 5;
+constexpr int TAB_SIZE = 3;
+
+QColor separatorColor()
+{
+   return QColor("#606162");
+}
+
+int textWidth(const QFontMetrics &metrics, const QString &text)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+   return metrics.horizontalAdvance(text);
+#else
+   return metrics.boundingRect(text).width();
+#endif
+}
+}
+
+BlameView::BlameView(QWidget *parent)
+   : QAbstractScrollArea(parent)
+   , mCodeBackground(GitQlientStyles::getBackgroundColor())
+   , mTextColor(GitQlientStyles::getTextColor())
+   , mHoverColor(GitQlientStyles::getGraphHoverColor())
+{
+   viewport()->setObjectName("AnnotationFrame");
+   viewport()->setMouseTracking(true);
+
+   updateGeometries();
+}
+
+void BlameView::setBlame(const QVector<Commit> &commits, const QVector<int> &lineCommits, const QStringList &lines)
+{
+   mCommits = commits;
+   mLineCommits = lineCommits;
+   mLines = lines;
+   mHoverFirstRow = -1;
+   mHoverLastRow = -1;
+   mMaxLineLength = 0;
+
+   // Only the length is needed to know the width of the code, the lines are measured with a monospace font.
+   for (const auto &line : qAsConst(mLines))
+      mMaxLineLength = std::max(mMaxLineLength, line.length() + line.count('\t') * (TAB_SIZE - 1));
+
+   verticalScrollBar()->setValue(0);
+   horizontalScrollBar()->setValue(0);
+
+   updateGeometries();
+}
+
+void BlameView::setCommits(const QVector<Commit> &commits)
+{
+   mCommits = commits;
+
+   updateGeometries();
+}
+
+void BlameView::setLineCommits(int firstLine, int count, int commit)
+{
+   const auto lastLine = std::min(firstLine + count, mLineCommits.count());
+
+   if (firstLine < 0 || firstLine >= lastLine || commit < 0 || commit >= mCommits.count())
+      return;
+
+   std::fill(mLineCommits.begin() + firstLine, mLineCommits.begin() + lastLine, commit);
+
+   // The blocks of lines might have changed under the cursor.
+   mHoverFirstRow = -1;
+   mHoverLastRow = -1;
+
+   const auto firstRow = verticalScrollBar()->value();
+   const auto lastRow = firstRow + viewport()->height() / mRowHeight + 1;
+
+   if (firstLine <= lastRow && lastLine > firstRow)
+      viewport()->update();
+}
+
+void BlameView::clear()
+{
+   setBlame({}, {}, {});
+}
+
+void BlameView::setPlaceholderText(const QString &text)
+{
+   mPlaceholderText = text;
+
+   viewport()->update();
+}
+
+void BlameView::setFonts(const QFont &infoFont, const QFont &codeFont)
+{
+   mInfoFont = infoFont;
+   mCodeFont = codeFont;
+
+   updateGeometries();
+}
+
+void BlameView::paintEvent(QPaintEvent *)
+{
+   QPainter painter(viewport());
+   const auto rect = viewport()->rect();
+
+   if (mLines.isEmpty())
+   {
+      painter.setFont(mInfoFont);
+      painter.setPen(mTextColor);
+      painter.drawText(rect, Qt::AlignCenter, mPlaceholderText);
+      return;
+   }
+
+   const auto numberX = codeStart() - mNumberWidth;
+   const auto titleX = mDateWidth + mAuthorWidth;
+   const auto firstRow = verticalScrollBar()->value();
+   const auto lastRow = std::min(firstRow + rect.height() / mRowHeight + 1, mLines.count() - 1);
+
+   painter.fillRect(QRect(numberX, 0, rect.width() - numberX, rect.height()), mCodeBackground);
+
+   for (auto row = firstRow; row <= lastRow; ++row)
+   {
+      const auto y = (row - firstRow) * mRowHeight;
+      const auto &commit = mCommits.at(mLineCommits.at(row));
+      const auto isBlockStart = row == 0 || mLineCommits.at(row - 1) != mLineCommits.at(row);
+
+      if (row >= mHoverFirstRow && row <= mHoverLastRow)
+         painter.fillRect(QRect(titleX, y, mTitleWidth, mRowHeight), mHoverColor);
+
+      if (isBlockStart && row > 0)
+      {
+         painter.setPen(separatorColor());
+         painter.drawLine(0, y, numberX - 1, y);
+      }
+
+      // The first visible row repeats the commit information so it's never out of sight.
+      if (isBlockStart || row == firstRow)
+      {
+         painter.setFont(mInfoFont);
+         painter.setPen(mTextColor);
+         painter.drawText(QRect(CELL_PADDING, y, mDateWidth - CELL_PADDING, mRowHeight),
+                          Qt::AlignLeft | Qt::AlignVCenter, commit.when);
+         painter.drawText(QRect(mDateWidth, y, mAuthorWidth - AUTHOR_PADDING, mRowHeight),
+                          Qt::AlignLeft | Qt::AlignVCenter, commit.author);
+         painter.drawText(QRect(titleX + CELL_PADDING, y, mTitleWidth - CELL_PADDING, mRowHeight),
+                          Qt::AlignLeft | Qt::AlignVCenter, commit.title);
+      }
+
+      painter.fillRect(QRect(numberX, y, AGE_GUIDE_WIDTH, mRowHeight), commit.color);
+      painter.setFont(mCodeFont);
+      painter.setPen(mTextColor);
+      painter.drawText(QRect(numberX, y, mNumberWidth - CELL_PADDING, mRowHeight), Qt::AlignRight | Qt::AlignVCenter,
+                       QString::number(row + 1));
+   }
+
+   painter.setPen(separatorColor());
+   painter.drawLine(codeStart() - 1, 0, codeStart() - 1, rect.height());
+
+   // The code is the only part that scrolls horizontally.
+   const auto codeX = codeStart() + CELL_PADDING - horizontalScrollBar()->value();
+
+   painter.setClipRect(QRect(codeStart(), 0, rect.width() - codeStart(), rect.height()));
+   painter.setFont(mCodeFont);
+   painter.setPen(mTextColor);
+
+   for (auto row = firstRow; row <= lastRow; ++row)
+   {
+      const auto y = (row - firstRow) * mRowHeight;
+      const auto line = QString(mLines.at(row)).replace('\t', QString(TAB_SIZE, ' '));
+
+      painter.drawText(QRect(codeX, y, rect.width() - codeX, mRowHeight), Qt::AlignLeft | Qt::AlignVCenter, line);
+   }
+}
+
+void BlameView::resizeEvent(QResizeEvent *event)
+{
+   QAbstractScrollArea::resizeEvent(event);
+
+   updateScrollBars();
+}
+
+void BlameView::mouseMoveEvent(QMouseEvent *event)
+{
+   const auto row = rowAt(event->pos().y());
+   const auto overTitle = row != -1 && columnAt(event->pos().x()) == Column::Title;
+
+   viewport()->setCursor(overTitle ? Qt::PointingHandCursor : Qt::ArrowCursor);
+   setHoverRow(overTitle ? row : -1);
+
+   QAbstractScrollArea::mouseMoveEvent(event);
+}
+
+void BlameView::mouseReleaseEvent(QMouseEvent *event)
+{
+   const auto row = rowAt(event->pos().y());
+
+   if (event->button() == Qt::LeftButton && row != -1 && columnAt(event->pos().x()) == Column::Title)
+   {
+      // The lines that are still being blamed don't have a commit yet.
+      if (const auto &sha = mCommits.at(mLineCommits.at(row)).sha; !sha.isEmpty())
+         emit signalCommitSelected(sha);
+   }
+
+   QAbstractScrollArea::mouseReleaseEvent(event);
+}
+
+bool BlameView::viewportEvent(QEvent *event)
+{
+   if (event->type() == QEvent::ToolTip)
+   {
+      const auto helpEvent = static_cast<QHelpEvent *>(event);
+      const auto row = rowAt(helpEvent->pos().y());
+      QString toolTip;
+
+      if (row != -1 && !mCommits.at(mLineCommits.at(row)).sha.isEmpty())
+      {
+         const auto &commit = mCommits.at(mLineCommits.at(row));
+
+         if (const auto column = columnAt(helpEvent->pos().x()); column == Column::Date)
+            toolTip = commit.dateTime.toString("dd/MM/yyyy hh:mm");
+         else if (column == Column::Title)
+            toolTip = QString("<p>%1</p><p>%2</p>").arg(commit.sha, commit.title);
+      }
+
+      if (toolTip.isEmpty())
+         QToolTip::hideText();
+      else
+         QToolTip::showText(helpEvent->globalPos(), toolTip, viewport());
+
+      return true;
+   }
+
+   if (event->type() == QEvent::Leave)
+      setHoverRow(-1);
+
+   return QAbstractScrollArea::viewportEvent(event);
+}
+
+void BlameView::scrollContentsBy(int, int)
+{
+   setHoverRow(-1);
+
+   viewport()->update();
+}
+
+void BlameView::updateGeometries()
+{
+   const QFontMetrics infoMetrics(mInfoFont);
+   const QFontMetrics codeMetrics(mCodeFont);
+
+   mRowHeight = std::max(infoMetrics.height(), codeMetrics.height()) + 2 * ROW_PADDING;
+   mDateWidth = 0;
+   mAuthorWidth = 0;
+   mTitleWidth = 0;
+
+   // The columns of the commits only depend on the amount of commits, not on the size of the file.
+   for (const auto &commit : qAsConst(mCommits))
+   {
+      mDateWidth = std::max(mDateWidth, textWidth(infoMetrics, commit.when));
+      mAuthorWidth = std::max(mAuthorWidth, textWidth(infoMetrics, commit.author));
+      mTitleWidth = std::max(mTitleWidth, textWidth(infoMetrics, commit.title));
+   }
+
+   mDateWidth += 2 * CELL_PADDING;
+   mAuthorWidth += AUTHOR_PADDING;
+   mTitleWidth += 2 * CELL_PADDING;
+
+   const auto digits = QString::number(std::max(1, mLines.count())).length();
+
+   mNumberWidth = AGE_GUIDE_WIDTH + 2 * CELL_PADDING + digits * textWidth(codeMetrics, QString("9"));
+
+   updateScrollBars();
+
+   viewport()->update();
+}
+
+void BlameView::updateScrollBars()
+{
+   const auto visibleRows = std::max(1, viewport()->height() / mRowHeight);
+
+   verticalScrollBar()->setSingleStep(1);
+   verticalScrollBar()->setPageStep(visibleRows);
+   verticalScrollBar()->setRange(0, std::max(0, mLines.count() - visibleRows));
+
+   const QFontMetrics codeMetrics(mCodeFont);
+   const auto codeWidth = mMaxLineLength * textWidth(codeMetrics, QString("9")) + 2 * CELL_PADDING;
+   const auto visibleWidth = std::max(0, viewport()->width() - codeStart());
+
+   horizontalScrollBar()->setSingleStep(textWidth(codeMetrics, QString("9")));
+   horizontalScrollBar()->setPageStep(visibleWidth);
+   horizontalScrollBar()->setRange(0, std::max(0, codeWidth - visibleWidth));
+}
+
+int BlameView::rowAt(int y) const
+{
+   if (y < 0)
+      return -1;
+
+   const auto row = verticalScrollBar()->value() + y / mRowHeight;
+
+   return row < mLines.count() ? row : -1;
+}
+
+BlameView::Column BlameView::columnAt(int x) const
+{
+   if (x < mDateWidth)
+      return Column::Date;
+
+   if (x < mDateWidth + mAuthorWidth)
+      return Column::Author;
+
+   if (x < mDateWidth + mAuthorWidth + mTitleWidth)
+      return Column::Title;
+
+   return x < codeStart() ? Column::Number : Column::Code;
+}
+
+void BlameView::setHoverRow(int row)
+{
+   if (row != -1 && row >= mHoverFirstRow && row <= mHoverLastRow)
+      return;
+
+   auto first = -1;
+   auto last = -1;
+
+   // The whole block of lines of the commit is highlighted.
+   if (row != -1)
+   {
+      const auto commit = mLineCommits.at(row);
+
+      first = row;
+      last = row;
+
+      while (first > 0 && mLineCommits.at(first - 1) == commit)
+         --first;
+
+      while (last < mLineCommits.count() - 1 && mLineCommits.at(last + 1) == commit)
+         ++last;
+   }
+
+   if (first != mHoverFirstRow || last != mHoverLastRow)
+   {
+      mHoverFirstRow = first;
+      mHoverLastRow = last;
+
+      viewport()->update();
+   }
+}
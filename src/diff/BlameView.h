@@ -0,0 +1,158 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QAbstractScrollArea>
+#include <QColor>
+#include <QDateTime>
+#include <QFont>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ \brief The BlameView class paints the blame of a file. Only the lines that are visible are painted, so the cost of
+ showing a file doesn't depend on its size.
+
+ Every line is represented by the index of the commit that last modified it in a table of commits, and consecutive
+ lines of the same commit are shown as a block with the date, the author and the title of the commit. The line numbers
+ have a colour guide that goes from the brightest colour for the newest changes to the darkest for the oldest.
+
+*/
+class BlameView : public QAbstractScrollArea
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the user clicks the title of a commit.
+
+    \param sha The SHA of the commit.
+   */
+   void signalCommitSelected(const QString &sha);
+
+public:
+   /*!
+    \brief The information of a commit shown in the blame.
+   */
+   struct Commit
+   {
+      QString sha;
+      QString author;
+      QDateTime dateTime;
+      QString when; /*!< Text with the time passed since the commit. */
+      QString title;
+      QColor color; /*!< Colour of the age guide. */
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent widget if needed.
+   */
+   explicit BlameView(QWidget *parent = nullptr);
+
+   /*!
+    \brief Sets the blame to show.
+
+    \param commits The commits that appear in the blame.
+    \param lineCommits The index in @p commits of the commit of every line.
+    \param lines The content of every line.
+   */
+   void setBlame(const QVector<Commit> &commits, const QVector<int> &lineCommits, const QStringList &lines);
+   /*!
+    \brief Replaces the table of commits keeping the lines as they are. It's used to add the commits of a blame that
+    is still being loaded, so the indexes of the commits already in the table must not change.
+
+    \param commits The commits that appear in the blame.
+   */
+   void setCommits(const QVector<Commit> &commits);
+   /*!
+    \brief Assigns a range of lines to a commit of the table.
+
+    \param firstLine The first line, starting at 0.
+    \param count The amount of lines.
+    \param commit The index of the commit in the table.
+   */
+   void setLineCommits(int firstLine, int count, int commit);
+   /*!
+    \brief Removes the blame shown.
+   */
+   void clear();
+   /*!
+    \brief Sets the text shown when there is no blame.
+
+    \param text The text.
+   */
+   void setPlaceholderText(const QString &text);
+   /*!
+    \brief Sets the fonts used to paint the blame.
+
+    \param infoFont The font of the commits information.
+    \param codeFont The font of the line numbers and the code.
+   */
+   void setFonts(const QFont &infoFont, const QFont &codeFont);
+
+protected:
+   void paintEvent(QPaintEvent *event) override;
+   void resizeEvent(QResizeEvent *event) override;
+   void mouseMoveEvent(QMouseEvent *event) override;
+   void mouseReleaseEvent(QMouseEvent *event) override;
+   bool viewportEvent(QEvent *event) override;
+   void scrollContentsBy(int dx, int dy) override;
+
+private:
+   enum class Column
+   {
+      Date,
+      Author,
+      Title,
+      Number,
+      Code
+   };
+
+   QVector<Commit> mCommits;
+   QVector<int> mLineCommits;
+   QStringList mLines;
+   QString mPlaceholderText;
+   QFont mInfoFont;
+   QFont mCodeFont;
+   int mRowHeight = 22;
+   int mDateWidth = 0;
+   int mAuthorWidth = 0;
+   int mTitleWidth = 0;
+   int mNumberWidth = 0;
+   int mMaxLineLength = 0;
+   int mHoverFirstRow = -1;
+   int mHoverLastRow = -1;
+   QColor mCodeBackground;
+   QColor mTextColor;
+   QColor mHoverColor;
+
+   void updateGeometries();
+   void updateScrollBars();
+   int rowAt(int y) const;
+   Column columnAt(int x) const;
+   int codeStart() const { return mDateWidth + mAuthorWidth + mTitleWidth + mNumberWidth; }
+   void setHoverRow(int row);
+};
@@ -1,7 +1,10 @@
 INCLUDEPATH += $$PWD
 
 HEADERS += \
+    $$PWD/BlameView.h \
     $$PWD/CommitDiffWidget.h \
+    $$PWD/DiffBuffer.h \
+    $$PWD/DiffBufferView.h \
     $$PWD/DiffButton.h \
     $$PWD/DiffInfo.h \
     $$PWD/DiffInfoPanel.h \
@@ -14,7 +17,10 @@ HEADERS += \
     $$PWD/FullDiffWidget.h
 
 SOURCES += \
+    $$PWD/BlameView.cpp \
     $$PWD/CommitDiffWidget.cpp \
+    $$PWD/DiffBuffer.cpp \
+    $$PWD/DiffBufferView.cpp \
     $$PWD/DiffButton.cpp \
     $$PWD/DiffInfoPanel.cpp \
     $$PWD/FileBlameWidget.cpp \
@@ -0,0 +1,88 @@
+#include "DiffBuffer.h"
+
+#include <algorithm>
+
+namespace
+{
+int readNumber(const QByteArray &line, int pos)
+{
+   auto number = 0;
+
+   while (pos < line.size() && line.at(pos) >= '0' && line.at(pos) <= '9')
+      number = number * 10 + (line.at(pos++) - '0');
+
+   return number;
+}
+}
+
+void DiffBuffer::clear()
+{
+   mData.clear();
+   mLines.clear();
+   mMaxLength = 0;
+   mOldNumber = 0;
+   mNewNumber = 0;
+   mInHunk = false;
+}
+
+int DiffBuffer::append(const QByteArray &line)
+{
+   Line diffLine;
+   auto prefix = 1;
+
+   if (line.startsWith("@@"))
+   {
+      parseHunkHeader(line);
+
+      mInHunk = true;
+      diffLine.type = LineType::Hunk;
+      prefix = 0;
+   }
+   else if (!mInHunk || line.startsWith('\\'))
+   {
+      // The headers of the diff and the "\ No newline at end of file" marks are not shown.
+      return -1;
+   }
+   else if (line.startsWith('+'))
+   {
+      diffLine.type = LineType::Addition;
+      diffLine.newNumber = mNewNumber++;
+   }
+   else if (line.startsWith('-'))
+   {
+      diffLine.type = LineType::Deletion;
+      diffLine.oldNumber = mOldNumber++;
+   }
+   else
+   {
+      diffLine.oldNumber = mOldNumber++;
+      diffLine.newNumber = mNewNumber++;
+      prefix = line.isEmpty() ? 0 : 1;
+   }
+
+   diffLine.offset = mData.size();
+   diffLine.length = line.size() - prefix;
+
+   mData.append(line.constData() + prefix, diffLine.length);
+   mLines.append(diffLine);
+   mMaxLength = std::max(mMaxLength, diffLine.length);
+
+   return mLines.count() - 1;
+}
+
+QString DiffBuffer::text(int index) const
+{
+   const auto &line = mLines.at(index);
+
+   return QString::fromUtf8(mData.constData() + line.offset, line.length);
+}
+
+void DiffBuffer::parseHunkHeader(const QByteArray &line)
+{
+   // Format: @@ -<old start>[,<old count>] +<new start>[,<new count>] @@ [section]
+   const auto oldStart = line.indexOf('-');
+   const auto newStart = line.indexOf('+', oldStart);
+
+   mOldNumber = oldStart != -1 ? readNumber(line, oldStart + 1) : 0;
+   mNewNumber = newStart != -1 ? readNumber(line, newStart + 1) : 0;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/*!
+ \brief The DiffBuffer class keeps the lines of the diff of a file in a compact way: the text of all the lines is stored
+ in a single UTF-8 buffer and every line only keeps where its text starts, its type and its line numbers. The text of a
+ line is only converted to QString when it's requested, so a diff of several MB costs little more than its size.
+
+ The lines are appended as Git produces them, so the buffer can be filled while the diff is still being read. The
+ headers of the diff are skipped and the hunk headers are kept since they mark where the context can be expanded.
+
+*/
+class DiffBuffer
+{
+public:
+   /*!
+    \brief The type of a line of the diff.
+   */
+   enum class LineType : quint8
+   {
+      Context,
+      Addition,
+      Deletion,
+      Hunk
+   };
+
+   /*!
+    \brief Removes all the lines.
+   */
+   void clear();
+   /*!
+    \brief Appends a line of the output of git diff.
+
+    \param line The line without the line break.
+    \return The index of the line if it was stored, -1 if it's part of the headers of the diff.
+   */
+   int append(const QByteArray &line);
+   /*!
+    \brief Gets the amount of lines stored.
+
+    \return The amount of lines.
+   */
+   int count() const { return mLines.count(); }
+   /*!
+    \brief Gets the type of a line.
+
+    \param index The index of the line.
+    \return The type.
+   */
+   LineType type(int index) const { return mLines.at(index).type; }
+   /*!
+    \brief Gets the number of a line in the old file.
+
+    \param index The index of the line.
+    \return The number, starting at 1, or -1 if the line is not in the old file.
+   */
+   int oldNumber(int index) const { return mLines.at(index).oldNumber; }
+   /*!
+    \brief Gets the number of a line in the new file.
+
+    \param index The index of the line.
+    \return The number, starting at 1, or -1 if the line is not in the new file.
+   */
+   int newNumber(int index) const { return mLines.at(index).newNumber; }
+   /*!
+    \brief Gets the text of a line without the diff prefix.
+
+    \param index The index of the line.
+    \return The text.
+   */
+   QString text(int index) const;
+   /*!
+    \brief Gets the length in bytes of the longest line, used to estimate the width of the text.
+
+    \return The length.
+   */
+   int maxLength() const { return mMaxLength; }
+
+private:
+   struct Line
+   {
+      int offset = 0;
+      int length = 0;
+      int oldNumber = -1;
+      int newNumber = -1;
+      LineType type = LineType::Context;
+   };
+
+   QByteArray mData;
+   QVector<Line> mLines;
+   int mMaxLength = 0;
+   int mOldNumber = 0;
+   int mNewNumber = 0;
+   bool mInHunk = false;
+
+   void parseHunkHeader(const QByteArray &line);
+};
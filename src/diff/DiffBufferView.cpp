@@ -0,0 +1,395 @@
+#include "DiffBufferView.h"
+
+#include <DiffBuffer.h>
+#include <GitQlientStyles.h>
+
+#include <QApplication>
+#include <QClipboard>
+#include <QContextMenuEvent>
+#include <QFontMetrics>
+#include <QHelpEvent>
+#include <QKeyEvent>
+#include <QMenu>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QToolTip>
+
+#include <algorithm>
+
+namespace
+{
+constexpr int CELL_PADDING = 5;
+constexpr int TAB_SIZE = 3;
+
+bool isChange(DiffBuffer::LineType type)
+{
+   return type == DiffBuffer::LineType::Addition || type == DiffBuffer::LineType::Deletion;
+}
+}
+
+DiffBufferView::DiffBufferView(QWidget *parent)
+   : QAbstractScrollArea(parent)
+   , mBackground(GitQlientStyles::getBackgroundColor())
+   , mTextColor(GitQlientStyles::getTextColor())
+   , mSelectionColor(GitQlientStyles::getGraphSelectionColor())
+{
+   setFocusPolicy(Qt::StrongFocus);
+   viewport()->setMouseTracking(true);
+
+   connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &DiffBufferView::signalScrollChanged);
+}
+
+void DiffBufferView::setBuffer(const QSharedPointer<DiffBuffer> &buffer)
+{
+   mBuffer = buffer;
+
+   setMode(mMode);
+}
+
+void DiffBufferView::setMode(Mode mode)
+{
+   mMode = mode;
+   mRows.clear();
+   mProcessedLines = 0;
+   mMaxNumber = 0;
+   mSelectionStart = -1;
+   mSelectionEnd = -1;
+
+   linesAppended();
+
+   viewport()->update();
+}
+
+void DiffBufferView::setCanExpand(bool canExpand)
+{
+   mCanExpand = canExpand;
+
+   viewport()->update();
+}
+
+void DiffBufferView::linesAppended()
+{
+   if (!mBuffer)
+      return;
+
+   const auto previousRows = rowCount();
+
+   for (; mProcessedLines < mBuffer->count(); ++mProcessedLines)
+   {
+      const auto type = mBuffer->type(mProcessedLines);
+
+      mMaxNumber = std::max({ mMaxNumber, mBuffer->oldNumber(mProcessedLines), mBuffer->newNumber(mProcessedLines) });
+
+      if ((mMode == Mode::OldFile && type != DiffBuffer::LineType::Addition)
+          || (mMode == Mode::NewFile && type != DiffBuffer::LineType::Deletion))
+      {
+         mRows.append(mProcessedLines);
+      }
+   }
+
+   if (rowCount() == previousRows)
+      return;
+
+   updateScrollBars();
+
+   // Only the rows that appear in the visible area need a repaint.
+   if (previousRows <= verticalScrollBar()->value() + viewport()->height() / rowHeight() + 1)
+      viewport()->update();
+}
+
+QVector<int> DiffBufferView::getChunkRows() const
+{
+   QVector<int> chunkRows;
+
+   for (auto row = 0; row < rowCount(); ++row)
+   {
+      if (isChange(mBuffer->type(lineAt(row))) && (row == 0 || !isChange(mBuffer->type(lineAt(row - 1)))))
+         chunkRows.append(row);
+   }
+
+   return chunkRows;
+}
+
+int DiffBufferView::findRow(int number) const
+{
+   for (auto row = 0; row < rowCount(); ++row)
+   {
+      if (numberAt(row) >= number)
+         return row;
+   }
+
+   return -1;
+}
+
+int DiffBufferView::firstVisibleNumber() const
+{
+   for (auto row = verticalScrollBar()->value(); row < rowCount(); ++row)
+   {
+      if (const auto number = numberAt(row); number != -1)
+         return number;
+   }
+
+   return -1;
+}
+
+void DiffBufferView::moveScrollBarToPos(int value)
+{
+   blockSignals(true);
+   verticalScrollBar()->setValue(value);
+   blockSignals(false);
+}
+
+void DiffBufferView::paintEvent(QPaintEvent *)
+{
+   QPainter painter(viewport());
+   const auto rect = viewport()->rect();
+
+   painter.fillRect(rect, mBackground);
+
+   if (rowCount() == 0)
+      return;
+
+   const auto height = rowHeight();
+   const auto numberWidth = numbersWidth();
+   const auto columns = mMode == Mode::Unified ? 2 : 1;
+   const auto textX = columns * numberWidth + CELL_PADDING - horizontalScrollBar()->value();
+   const auto firstRow = verticalScrollBar()->value();
+   const auto lastRow = std::min(firstRow + rect.height() / height + 1, rowCount() - 1);
+   const auto selectionFirst = std::min(mSelectionStart, mSelectionEnd);
+   const auto selectionLast = std::max(mSelectionStart, mSelectionEnd);
+
+   auto boldFont = font();
+   boldFont.setBold(true);
+
+   for (auto row = firstRow; row <= lastRow; ++row)
+   {
+      const auto y = (row - firstRow) * height;
+      const auto line = lineAt(row);
+      const auto type = mBuffer->type(line);
+
+      if (selectionFirst != -1 && row >= selectionFirst && row <= selectionLast)
+         painter.fillRect(QRect(0, y, rect.width(), height), mSelectionColor);
+
+      painter.setFont(font());
+      painter.setPen(mTextColor);
+
+      const auto drawNumber = [&painter, y, height, numberWidth](int column, int number) {
+         if (number != -1)
+            painter.drawText(QRect(column * numberWidth, y, numberWidth - CELL_PADDING, height),
+                             Qt::AlignRight | Qt::AlignVCenter, QString::number(number));
+      };
+
+      // The unified mode shows the number in both files, the sides only the number in their file.
+      if (mMode == Mode::Unified)
+      {
+         drawNumber(0, mBuffer->oldNumber(line));
+         drawNumber(1, mBuffer->newNumber(line));
+      }
+      else
+         drawNumber(0, mMode == Mode::OldFile ? mBuffer->oldNumber(line) : mBuffer->newNumber(line));
+
+      switch (type)
+      {
+         case DiffBuffer::LineType::Hunk:
+            painter.setPen(GitQlientStyles::getOrange());
+            painter.setFont(boldFont);
+            break;
+         case DiffBuffer::LineType::Addition:
+            painter.setPen(GitQlientStyles::getGreen());
+            break;
+         case DiffBuffer::LineType::Deletion:
+            painter.setPen(GitQlientStyles::getRed());
+            break;
+         default:
+            break;
+      }
+
+      painter.setClipRect(QRect(columns * numberWidth, 0, rect.width(), rect.height()));
+      painter.drawText(QRect(textX, y, rect.width() - textX, height), Qt::AlignLeft | Qt::AlignVCenter,
+                       rowText(row).replace('\t', QString(TAB_SIZE, ' ')));
+      painter.setClipping(false);
+   }
+}
+
+void DiffBufferView::resizeEvent(QResizeEvent *event)
+{
+   QAbstractScrollArea::resizeEvent(event);
+
+   updateScrollBars();
+}
+
+void DiffBufferView::mousePressEvent(QMouseEvent *event)
+{
+   const auto row = rowAt(event->pos().y());
+
+   if (event->button() == Qt::LeftButton)
+   {
+      if (isExpandable(row))
+         emit signalExpandContext(lineAt(row));
+      else
+      {
+         mSelectionStart = row;
+         mSelectionEnd = row;
+
+         viewport()->update();
+      }
+   }
+
+   QAbstractScrollArea::mousePressEvent(event);
+}
+
+void DiffBufferView::mouseMoveEvent(QMouseEvent *event)
+{
+   const auto row = rowAt(event->pos().y());
+
+   viewport()->setCursor(isExpandable(row) ? Qt::PointingHandCursor : Qt::IBeamCursor);
+
+   if ((event->buttons() & Qt::LeftButton) && mSelectionStart != -1 && row != -1 && row != mSelectionEnd)
+   {
+      mSelectionEnd = row;
+
+      viewport()->update();
+   }
+
+   QAbstractScrollArea::mouseMoveEvent(event);
+}
+
+void DiffBufferView::keyPressEvent(QKeyEvent *event)
+{
+   if (event->matches(QKeySequence::Copy))
+      copySelection();
+   else if (event->matches(QKeySequence::SelectAll) && rowCount() > 0)
+   {
+      mSelectionStart = 0;
+      mSelectionEnd = rowCount() - 1;
+
+      viewport()->update();
+   }
+   else
+      QAbstractScrollArea::keyPressEvent(event);
+}
+
+void DiffBufferView::contextMenuEvent(QContextMenuEvent *event)
+{
+   if (mSelectionStart != -1)
+   {
+      QMenu menu(this);
+      connect(menu.addAction(tr("Copy")), &QAction::triggered, this, &DiffBufferView::copySelection);
+      menu.exec(event->globalPos());
+   }
+}
+
+bool DiffBufferView::viewportEvent(QEvent *event)
+{
+   if (event->type() == QEvent::ToolTip)
+   {
+      const auto helpEvent = static_cast<QHelpEvent *>(event);
+
+      if (isExpandable(rowAt(helpEvent->pos().y())))
+         QToolTip::showText(helpEvent->globalPos(), tr("Click to show more context"), viewport());
+      else
+         QToolTip::hideText();
+
+      return true;
+   }
+
+   return QAbstractScrollArea::viewportEvent(event);
+}
+
+void DiffBufferView::scrollContentsBy(int, int)
+{
+   viewport()->update();
+}
+
+int DiffBufferView::rowAt(int y) const
+{
+   if (y < 0)
+      return -1;
+
+   const auto row = verticalScrollBar()->value() + y / rowHeight();
+
+   return row < rowCount() ? row : -1;
+}
+
+int DiffBufferView::numberAt(int row) const
+{
+   const auto line = lineAt(row);
+
+   return mMode == Mode::OldFile ? mBuffer->oldNumber(line) : mBuffer->newNumber(line);
+}
+
+int DiffBufferView::rowHeight() const
+{
+   return std::max(1, fontMetrics().lineSpacing());
+}
+
+int DiffBufferView::charWidth() const
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+   return fontMetrics().horizontalAdvance(QLatin1Char('9'));
+#else
+   return fontMetrics().boundingRect(QLatin1Char('9')).width();
+#endif
+}
+
+int DiffBufferView::numbersWidth() const
+{
+   return QString::number(std::max(1, mMaxNumber)).length() * charWidth() + 2 * CELL_PADDING;
+}
+
+QString DiffBufferView::rowText(int row) const
+{
+   const auto line = lineAt(row);
+
+   if (mMode != Mode::Unified)
+      return mBuffer->text(line);
+
+   // The unified mode keeps the prefix of the diff so the text can be copied as a patch.
+   switch (mBuffer->type(line))
+   {
+      case DiffBuffer::LineType::Addition:
+         return QString("+") + mBuffer->text(line);
+      case DiffBuffer::LineType::Deletion:
+         return QString("-") + mBuffer->text(line);
+      case DiffBuffer::LineType::Context:
+         return QString(" ") + mBuffer->text(line);
+      default:
+         return mBuffer->text(line);
+   }
+}
+
+bool DiffBufferView::isExpandable(int row) const
+{
+   return mCanExpand && row != -1 && mBuffer->type(lineAt(row)) == DiffBuffer::LineType::Hunk;
+}
+
+void DiffBufferView::copySelection() const
+{
+   if (mSelectionStart == -1)
+      return;
+
+   QStringList lines;
+
+   for (auto row = std::min(mSelectionStart, mSelectionEnd); row <= std::max(mSelectionStart, mSelectionEnd); ++row)
+      lines.append(rowText(row));
+
+   QApplication::clipboard()->setText(lines.join('\n'));
+}
+
+void DiffBufferView::updateScrollBars()
+{
+   const auto visibleRows = std::max(1, viewport()->height() / rowHeight());
+
+   verticalScrollBar()->setSingleStep(1);
+   verticalScrollBar()->setPageStep(visibleRows);
+   verticalScrollBar()->setRange(0, std::max(0, rowCount() - visibleRows));
+
+   const auto textStart = (mMode == Mode::Unified ? 2 : 1) * numbersWidth();
+   const auto textWidth = ((mBuffer ? mBuffer->maxLength() : 0) + 1) * charWidth() + 2 * CELL_PADDING;
+   const auto visibleWidth = std::max(0, viewport()->width() - textStart);
+
+   horizontalScrollBar()->setSingleStep(charWidth());
+   horizontalScrollBar()->setPageStep(visibleWidth);
+   horizontalScrollBar()->setRange(0, std::max(0, textWidth - visibleWidth));
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+#include <QAbstractScrollArea>
+#include <QColor>
+#include <QSharedPointer>
+#include <QVector>
+
+class DiffBuffer;
+
+/*!
+ \brief The DiffBufferView class paints the lines of a DiffBuffer. Only the lines that are visible are painted, so the
+ cost of showing a diff doesn't depend on its size, and the lines can be appended while the diff is still being read.
+
+ The view shows the whole diff or only one of its sides: the old file (context and deletions) or the new file (context
+ and additions). The hunk headers are shown in all the modes and, when the context can be expanded, clicking them
+ requests more context lines.
+
+*/
+class DiffBufferView : public QAbstractScrollArea
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the vertical scroll bar changes its position.
+
+    \param value The new scroll bar position.
+   */
+   void signalScrollChanged(int value);
+   /*!
+    \brief Signal triggered when the user clicks a hunk header to see more context.
+
+    \param line The index of the hunk header in the buffer.
+   */
+   void signalExpandContext(int line);
+
+public:
+   /*!
+    \brief The lines of the diff that are shown.
+   */
+   enum class Mode
+   {
+      Unified,
+      OldFile,
+      NewFile
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent widget if needed.
+   */
+   explicit DiffBufferView(QWidget *parent = nullptr);
+
+   /*!
+    \brief Sets the buffer to show. The lines already in the buffer are shown right away.
+
+    \param buffer The buffer.
+   */
+   void setBuffer(const QSharedPointer<DiffBuffer> &buffer);
+   /*!
+    \brief Sets the lines of the diff that are shown.
+
+    \param mode The mode.
+   */
+   void setMode(Mode mode);
+   /*!
+    \brief Enables or disables the expansion of the context from the hunk headers.
+
+    \param canExpand True to enable it, otherwise false.
+   */
+   void setCanExpand(bool canExpand);
+   /*!
+    \brief Updates the view with the lines appended to the buffer since the last call.
+   */
+   void linesAppended();
+   /*!
+    \brief Gets the amount of rows of the view.
+
+    \return The amount of rows.
+   */
+   int rowCount() const { return mMode == Mode::Unified ? mProcessedLines : mRows.count(); }
+   /*!
+    \brief Gets the rows where a block of changes starts.
+
+    \return The rows, starting at 0.
+   */
+   QVector<int> getChunkRows() const;
+   /*!
+    \brief Finds the first row of a line number of the file shown, the new file in the unified mode.
+
+    \param number The line number, starting at 1.
+    \return The row or -1 if there is no row for that line.
+   */
+   int findRow(int number) const;
+   /*!
+    \brief Gets the line number of the first visible row that belongs to the file shown.
+
+    \return The line number, starting at 1, or -1 if there is none.
+   */
+   int firstVisibleNumber() const;
+   /*!
+    \brief Moves the vertical scroll bar to the value defined in @p value without notifying it.
+
+    \param value The new scroll bar value.
+   */
+   void moveScrollBarToPos(int value);
+
+protected:
+   void paintEvent(QPaintEvent *event) override;
+   void resizeEvent(QResizeEvent *event) override;
+   void mousePressEvent(QMouseEvent *event) override;
+   void mouseMoveEvent(QMouseEvent *event) override;
+   void keyPressEvent(QKeyEvent *event) override;
+   void contextMenuEvent(QContextMenuEvent *event) override;
+   bool viewportEvent(QEvent *event) override;
+   void scrollContentsBy(int dx, int dy) override;
+
+private:
+   QSharedPointer<DiffBuffer> mBuffer;
+   Mode mMode = Mode::Unified;
+   QVector<int> mRows;
+   int mProcessedLines = 0;
+   int mMaxNumber = 0;
+   int mSelectionStart = -1;
+   int mSelectionEnd = -1;
+   bool mCanExpand = false;
+   QColor mBackground;
+   QColor mTextColor;
+   QColor mSelectionColor;
+
+   int lineAt(int row) const { return mMode == Mode::Unified ? row : mRows.at(row); }
+   int rowAt(int y) const;
+   int numberAt(int row) const;
+   int rowHeight() const;
+   int charWidth() const;
+   int numbersWidth() const;
+   QString rowText(int row) const;
+   bool isExpandable(int row) const;
+   void copySelection() const;
+   void updateScrollBars();
+};
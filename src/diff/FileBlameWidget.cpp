@@ -1,57 +1,87 @@
 ﻿#include "FileBlameWidget.h"
 
 #include <RevisionsCache.h>
-#include <FileDiffView.h>
-#include <GitHistory.h>
+#include <GitBase.h>
+#include <GitStreamProcess.h>
 #include <CommitInfo.h>
-#include <ClickableFrame.h>
 
+#include <QLogger.h>
+#include <BenchmarkTool.h>
+
+#include <QDir>
+#include <QFile>
 #include <QGridLayout>
 #include <QLabel>
-#include <QScrollArea>
-#include <QtMath>
 #include <QMessageBox>
 
+#include <algorithm>
 #include <array>
 
+using namespace QLogger;
+using namespace GitQlientTools;
+
 namespace
 {
+// The blame is read line by line: the first batch is small so the first hunks are shown right away.
+constexpr int FIRST_BLAME_BATCH = 100;
+constexpr int BLAME_BATCH = 5000;
+constexpr int MAX_TITLE_LENGTH = 47;
+
 const int kTotalColors = 8;
-const std::array<QString, kTotalColors> kBorderColors { { "z25, 65, 99", "36, 95, 146", "44, 116, 177", "56, 136, 205",
-                                                          "87, 155, 213", "118, 174, 221", "150, 192, 221",
-                                                          "197, 220, 240" } };
-qint64 kSecondsNewest = 0;
-qint64 kSecondsOldest = QDateTime::currentDateTime().toSecsSinceEpoch();
-qint64 kIncrementSecs = 0;
+const std::array<QColor, kTotalColors> kAgeColors { { QColor(25, 65, 99), QColor(36, 95, 146), QColor(44, 116, 177),
+                                                      QColor(56, 136, 205), QColor(87, 155, 213), QColor(118, 174, 221),
+                                                      QColor(150, 192, 221), QColor(197, 220, 240) } };
+
+QString getWhen(const QDateTime &dateTime)
+{
+   QString when;
+   const auto days = dateTime.daysTo(QDateTime::currentDateTime());
+   const auto secs = dateTime.secsTo(QDateTime::currentDateTime());
+
+   if (days > 365)
+      when.append("more than 1 year ago");
+   else if (days > 1)
+      when.append(QString::number(days)).append(" days ago");
+   else if (days == 1)
+      when.append("yesterday");
+   else if (secs > 3600)
+      when.append(QString::number(secs / 3600)).append(" hours ago");
+   else if (secs == 3600)
+      when.append("1 hour ago");
+   else if (secs > 60)
+      when.append(QString::number(secs / 60)).append(" minutes ago");
+   else if (secs == 60)
+      when.append("1 minute ago");
+   else
+      when.append(QString::number(secs)).append(" secs ago");
+
+   return when;
+}
 }
 
 FileBlameWidget::FileBlameWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
-                                 QWidget *parent)
+                                 const QSharedPointer<BlameCache> &blameCache, QWidget *parent)
    : QFrame(parent)
    , mCache(cache)
    , mGit(git)
-   , mAnotation(new QFrame())
+   , mBlameCache(blameCache)
+   , mView(new BlameView())
    , mCurrentSha(new QLabel())
    , mPreviousSha(new QLabel())
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
-   mAnotation->setObjectName("AnnotationFrame");
-
-   auto initialLayout = new QGridLayout(mAnotation);
-   initialLayout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), 0, 0);
-   initialLayout->addWidget(new QLabel("Select a file to blame"), 1, 1);
-   initialLayout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), 2, 2);
+   QFont infoFont;
+   infoFont.setPointSize(9);
 
-   mInfoFont.setPointSize(9);
+   auto codeFont = QFont(infoFont);
+   codeFont.setFamily("Ubuntu Mono");
+   codeFont.setPointSize(10);
 
-   mCodeFont = QFont(mInfoFont);
-   mCodeFont.setFamily("Ubuntu Mono");
-   mCodeFont.setPointSize(10);
+   mView->setFonts(infoFont, codeFont);
+   mView->setPlaceholderText(tr("Select a file to blame"));
 
-   mScrollArea = new QScrollArea();
-   mScrollArea->setWidget(mAnotation);
-   mScrollArea->setWidgetResizable(true);
+   connect(mView, &BlameView::signalCommitSelected, this, &FileBlameWidget::signalCommitSelected);
 
    const auto lSha = new QLabel(tr("Current SHA:"));
    const auto lSha2 = new QLabel(tr("Previous SHA:"));
@@ -73,30 +103,102 @@ FileBlameWidget::FileBlameWidget(const QSharedPointer<RevisionsCache> &cache, co
    layout->setContentsMargins(10, 10, 10, 0);
    layout->setSpacing(10);
    layout->addLayout(shasLayout);
-   layout->addWidget(mScrollArea);
+   layout->addWidget(mView);
+}
+
+FileBlameWidget::~FileBlameWidget()
+{
+   cancelBlame();
 }
 
 void FileBlameWidget::setup(const QString &fileName, const QString &currentSha, const QString &previousSha)
 {
+   BenchmarkStart();
+
+   cancelBlame();
+
    mCurrentFile = fileName;
-   QScopedPointer<GitHistory> git(new GitHistory(mGit));
-   const auto ret = git->blame(mCurrentFile, currentSha);
+   mBlobId.clear();
+   mBlobSha.clear();
 
-   if (ret.success && !ret.output.toString().startsWith("fatal:"))
+   // The blame of the local changes depends on the work tree, so it's never cached. Otherwise the blame only changes
+   // with the commits that modify the file, so it's cached for the last of them and found again from any later commit.
+   if (currentSha != CommitInfo::ZERO_SHA)
    {
-      delete mAnotation;
-      mAnotation = nullptr;
-
-      mCurrentSha->setText(currentSha);
-      mPreviousSha->setText(previousSha);
+      const auto blob = mGit->resolveRevision(QString("%1:%2").arg(currentSha, getRepoFilePath()));
+      const auto lastChange = mGit->run(QString("git rev-list -1 %1 -- \"%2\"").arg(currentSha, getRepoFilePath()));
+      const auto lastChangeSha = lastChange.output.toString().trimmed();
 
-      const auto annotations = processBlame(ret.output.toString());
-      formatAnnotatedFile(annotations);
+      if (blob.success && lastChange.success && !lastChangeSha.isEmpty())
+      {
+         mBlobId = blob.output.toString();
+         mBlobSha = lastChangeSha;
+      }
    }
-   else
+
+   QStringList content;
+
+   if (!readContent(currentSha, content))
+   {
       QMessageBox::warning(
           this, tr("File not in Git"),
           tr("The file {%1} is not under Git control version. You cannot blame it.").arg(mCurrentFile));
+
+      BenchmarkEnd();
+      return;
+   }
+
+   mCurrentSha->setText(currentSha);
+   mPreviousSha->setText(previousSha);
+
+   BlameCache::Blame cachedBlame;
+
+   if (!mBlobId.isEmpty() && mBlameCache && mBlameCache->find(getRepoFilePath(), mBlobSha, mBlobId, cachedBlame)
+       && cachedBlame.lineCommits.count() == content.count())
+   {
+      showCachedBlame(cachedBlame, content);
+
+      BenchmarkEnd();
+      return;
+   }
+
+   // All the lines belong to a placeholder commit until Git finds the commit that last modified them.
+   BlameView::Commit loading;
+   loading.title = tr("Loading...");
+   loading.color = QColor(Qt::transparent);
+
+   mCommits = { loading };
+   mCommitIndexes.clear();
+   mLineCommits = QVector<int>(content.count(), 0);
+   mHunkCommit = -1;
+
+   mView->setBlame(mCommits, mLineCommits, content);
+
+   // Without a revision Git blames the file in the work tree, so the local changes are included.
+   auto cmd = QString("git blame --incremental --porcelain");
+
+   if (currentSha != CommitInfo::ZERO_SHA)
+      cmd.append(QString(" %1").arg(currentSha));
+
+   cmd.append(QString(" -- \"%1\"").arg(getRepoFilePath()));
+
+   mBlameProcess = new GitStreamProcess(mGit->getWorkingDir(), '\n');
+   mBlameProcess->setBatchSizes(FIRST_BLAME_BATCH, BLAME_BATCH);
+
+   connect(mBlameProcess, &GitStreamProcess::signalRecordsReady, this, &FileBlameWidget::processBlameRecords);
+   connect(mBlameProcess, &GitStreamProcess::signalStreamFinished, this, &FileBlameWidget::onBlameFinished);
+
+   if (!mBlameProcess->run(cmd).success)
+   {
+      QLog_Error("UI", QString("Unable to start the blame of the file {%1}.").arg(mCurrentFile));
+
+      mBlameProcess->deleteLater();
+      mBlameProcess = nullptr;
+
+      onBlameFinished(false);
+   }
+
+   BenchmarkEnd();
 }
 
 void FileBlameWidget::reload(const QString &currentSha, const QString &previousSha)
@@ -109,216 +211,242 @@ QString FileBlameWidget::getCurrentSha() const
    return mCurrentSha->text();
 }
 
-QVector<FileBlameWidget::Annotation> FileBlameWidget::processBlame(const QString &blame)
+bool FileBlameWidget::readContent(const QString &sha, QStringList &content) const
 {
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-   const auto lines = blame.split("\n", Qt::SkipEmptyParts);
-#else
-   const auto lines = blame.split("\n", QString::SkipEmptyParts);
-#endif
-   QVector<Annotation> annotations;
-
-   for (const auto &line : lines)
-   {
-      auto start = 0;
-      auto indexOfTab = line.indexOf('\t');
-      const auto shortSha = line.mid(start, indexOfTab);
-      const auto revision = mCache->getCommitInfo(shortSha);
-
-      start = indexOfTab + 1;
-      indexOfTab = line.indexOf('\t', start);
-      const auto name = line.mid(start, indexOfTab - start).remove("(");
+   QString text;
 
-      start = indexOfTab + 1;
-      indexOfTab = line.indexOf('\t', start);
-      const auto dtValue = line.mid(start, indexOfTab - start);
-      const auto dt = QDateTime::fromString(dtValue, Qt::ISODate);
+   if (sha == CommitInfo::ZERO_SHA)
+   {
+      QFile file(QDir(mGit->getWorkingDir()).filePath(mCurrentFile));
 
-      start = indexOfTab + 1;
+      if (!file.open(QIODevice::ReadOnly))
+         return false;
 
-      const auto lineNumAndContent = line.mid(start);
-      const auto divisorChar = lineNumAndContent.indexOf(")");
-      const auto lineText = lineNumAndContent.mid(0, divisorChar);
-      const auto content = lineNumAndContent.mid(divisorChar + 1, lineNumAndContent.count() - lineText.count() - 1);
+      text = QString::fromUtf8(file.readAll());
+   }
+   else
+   {
+      const auto ret = mGit->readObject(QString("%1:%2").arg(sha, getRepoFilePath()));
 
-      annotations.append({ revision.sha(), name, dt, lineText.toInt(), content });
+      if (!ret.success)
+         return false;
 
-      if (revision.sha() != CommitInfo::ZERO_SHA)
-      {
-         const auto dtSinceEpoch = dt.toSecsSinceEpoch();
+      text = ret.output.toString();
+   }
 
-         if (kSecondsNewest < dtSinceEpoch)
-            kSecondsNewest = dtSinceEpoch;
+   content = text.split('\n');
 
-         if (kSecondsOldest > dtSinceEpoch)
-            kSecondsOldest = dtSinceEpoch;
-      }
-   }
+   // Git doesn't count the end of the last line as a new line.
+   if (!content.isEmpty() && content.constLast().isEmpty())
+      content.removeLast();
 
-   kIncrementSecs = kSecondsNewest != kSecondsOldest ? (kSecondsNewest - kSecondsOldest) / (kTotalColors - 1) : 1;
+   return true;
+}
 
-   return annotations;
+QString FileBlameWidget::getRepoFilePath() const
+{
+   // Git only accepts paths relative to the root of the repository in the revisions of the objects.
+   return QDir(mGit->getWorkingDir()).relativeFilePath(mCurrentFile);
 }
 
-void FileBlameWidget::formatAnnotatedFile(const QVector<Annotation> &annotations)
+void FileBlameWidget::processBlameRecords(const QList<QByteArray> &records)
 {
-   auto labelRow = 0;
-   auto labelRowSpan = 1;
-   QLabel *dateLabel = nullptr;
-   QLabel *authorLabel = nullptr;
-   ClickableFrame *messageLabel = nullptr;
-
-   const auto annotationLayout = new QGridLayout();
-   annotationLayout->setContentsMargins(QMargins());
-   annotationLayout->setSpacing(0);
-
-   const auto totalAnnot = annotations.count();
-   for (auto row = 0; row < totalAnnot; ++row)
+   BenchmarkStart();
+
+   struct Hunk
    {
-      const auto &lastAnnotation = row == 0 ? Annotation() : annotations.at(row - 1);
+      int commit;
+      int firstLine;
+      int lines;
+   };
 
-      if (lastAnnotation.sha != annotations.at(row).sha)
+   QVector<Hunk> hunks;
+   auto commitsChanged = false;
+
+   for (const auto &record : records)
+   {
+      if (mHunkCommit == -1)
       {
-         if (dateLabel)
-            annotationLayout->addWidget(dateLabel, labelRow, 0);
+         // Header of the hunk: <sha> <line in the original file> <line in the final file> <number of lines>
+         const auto fields = record.split(' ');
+
+         if (fields.count() != 4)
+            continue;
 
-         if (authorLabel)
-            annotationLayout->addWidget(authorLabel, labelRow, 1);
+         const auto sha = QString::fromLatin1(fields.constFirst());
+         auto commitIter = mCommitIndexes.constFind(sha);
 
-         if (messageLabel)
-            annotationLayout->addWidget(messageLabel, labelRow, 2);
+         if (commitIter == mCommitIndexes.constEnd())
+         {
+            BlameView::Commit commit;
+            commit.sha = sha;
 
-         dateLabel = createDateLabel(annotations.at(row), row == 0);
-         authorLabel = createAuthorLabel(annotations.at(row).author, row == 0);
-         messageLabel = createMessageLabel(annotations.at(row).sha, row == 0);
+            if (sha == CommitInfo::ZERO_SHA)
+               commit.title = QString("Local changes");
 
-         labelRow = row;
-         labelRowSpan = 1;
+            commitIter = mCommitIndexes.insert(sha, mCommits.count());
+            mCommits.append(commit);
+         }
+
+         mHunkCommit = commitIter.value();
+         mHunkFirstLine = fields.at(2).toInt() - 1;
+         mHunkLines = fields.at(3).toInt();
+      }
+      else if (record.startsWith("filename "))
+      {
+         // The file name closes the hunk.
+         hunks.append({ mHunkCommit, mHunkFirstLine, mHunkLines });
+         mHunkCommit = -1;
       }
       else
-         ++labelRowSpan;
+      {
+         // The information of the commit is only sent the first time the commit appears.
+         auto &commit = mCommits[mHunkCommit];
+
+         if (record.startsWith("author "))
+            commit.author = QString::fromUtf8(record.mid(7));
+         else if (record.startsWith("author-time "))
+         {
+            commit.dateTime = QDateTime::fromSecsSinceEpoch(record.mid(12).toLongLong());
+
+            if (commit.sha != CommitInfo::ZERO_SHA)
+               commit.when = getWhen(commit.dateTime);
+         }
+         else if (record.startsWith("summary ") && commit.sha != CommitInfo::ZERO_SHA)
+         {
+            commit.title = QString::fromUtf8(record.mid(8));
+
+            if (commit.title.count() > MAX_TITLE_LENGTH)
+               commit.title = commit.title.left(MAX_TITLE_LENGTH) + QString("...");
+         }
+         else
+            continue;
+
+         commitsChanged = true;
+      }
+   }
 
-      annotationLayout->addWidget(createNumLabel(annotations.at(row), row), row, 3);
-      annotationLayout->addWidget(createCodeLabel(annotations.at(row).content), row, 4);
+   // The commits go first so the view knows them when the lines are assigned.
+   if (commitsChanged)
+   {
+      updateCommitColors();
+      mView->setCommits(mCommits);
    }
 
-   // Adding the last row
-   if (dateLabel)
-      annotationLayout->addWidget(dateLabel, labelRow, 0);
+   for (const auto &hunk : qAsConst(hunks))
+   {
+      const auto lastLine = std::min(hunk.firstLine + hunk.lines, mLineCommits.count());
+
+      if (hunk.firstLine >= 0 && hunk.firstLine < lastLine)
+         std::fill(mLineCommits.begin() + hunk.firstLine, mLineCommits.begin() + lastLine, hunk.commit);
 
-   if (authorLabel)
-      annotationLayout->addWidget(authorLabel, labelRow, 1);
+      mView->setLineCommits(hunk.firstLine, hunk.lines, hunk.commit);
+   }
 
-   if (messageLabel)
-      annotationLayout->addWidget(messageLabel, labelRow, 2);
+   BenchmarkEnd();
+}
 
-   annotationLayout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), totalAnnot, 4);
+void FileBlameWidget::onBlameFinished(bool success)
+{
+   mBlameProcess = nullptr;
 
-   mAnotation = new QFrame();
-   mAnotation->setObjectName("AnnotationFrame");
-   mAnotation->setLayout(annotationLayout);
+   // Git doesn't flag as an error blaming a file that is not in the revision, it just doesn't return any hunk.
+   if (!success || (mCommitIndexes.isEmpty() && !mLineCommits.isEmpty()))
+   {
+      mView->clear();
 
-   mScrollArea->setWidget(mAnotation);
-   mScrollArea->setWidgetResizable(true);
+      QMessageBox::warning(
+          this, tr("File not in Git"),
+          tr("The file {%1} is not under Git control version. You cannot blame it.").arg(mCurrentFile));
+   }
+   else if (!mBlobId.isEmpty() && mBlameCache)
+      storeBlame();
 }
 
-QLabel *FileBlameWidget::createDateLabel(const Annotation &annotation, bool isFirst)
+void FileBlameWidget::showCachedBlame(const BlameCache::Blame &blame, const QStringList &content)
 {
-   auto isWip = annotation.sha == CommitInfo::ZERO_SHA;
-   QString when;
+   mCommits.clear();
+   mCommitIndexes.clear();
+   mLineCommits = blame.lineCommits;
+   mHunkCommit = -1;
 
-   if (!isWip)
+   for (const auto &cachedCommit : blame.commits)
    {
-      const auto days = annotation.dateTime.daysTo(QDateTime::currentDateTime());
-      const auto secs = annotation.dateTime.secsTo(QDateTime::currentDateTime());
-      if (days > 365)
-         when.append("more than 1 year ago");
-      else if (days > 1)
-         when.append(QString::number(days)).append(" days ago");
-      else if (days == 1)
-         when.append("yesterday");
-      else if (secs > 3600)
-         when.append(QString::number(secs / 3600)).append(" hours ago");
-      else if (secs == 3600)
-         when.append("1 hour ago");
-      else if (secs > 60)
-         when.append(QString::number(secs / 60)).append(" minutes ago");
-      else if (secs == 60)
-         when.append("1 minute ago");
-      else
-         when.append(QString::number(secs)).append(" secs ago");
+      BlameView::Commit commit;
+      commit.sha = cachedCommit.sha;
+      commit.author = cachedCommit.author;
+      commit.dateTime = cachedCommit.dateTime;
+      commit.when = getWhen(commit.dateTime);
+      commit.title = cachedCommit.title;
+
+      mCommitIndexes.insert(commit.sha, mCommits.count());
+      mCommits.append(commit);
    }
 
-   const auto dateLabel = new QLabel(when);
-   dateLabel->setObjectName(isFirst ? QString("authorPrimusInterPares") : QString("authorFirstOfItsName"));
-   dateLabel->setToolTip(annotation.dateTime.toString("dd/MM/yyyy hh:mm"));
-   dateLabel->setFont(mInfoFont);
-   dateLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
+   updateCommitColors();
 
-   return dateLabel;
+   mView->setBlame(mCommits, mLineCommits, content);
 }
 
-QLabel *FileBlameWidget::createAuthorLabel(const QString &author, bool isFirst)
+void FileBlameWidget::storeBlame()
 {
-   const auto authorLabel = new QLabel(author);
-   authorLabel->setObjectName(isFirst ? QString("authorPrimusInterPares") : QString("authorFirstOfItsName"));
-   authorLabel->setFont(mInfoFont);
-   authorLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
-
-   return authorLabel;
-}
+   // The first commit is the placeholder of the lines that are not blamed yet.
+   if (std::find(mLineCommits.cbegin(), mLineCommits.cend(), 0) != mLineCommits.cend())
+      return;
 
-ClickableFrame *FileBlameWidget::createMessageLabel(const QString &sha, bool isFirst)
-{
-   const auto revision = mCache->getCommitInfo(sha);
-   auto commitMsg = QString("Local changes");
+   BlameCache::Blame blame;
+   blame.commits.reserve(mCommits.count() - 1);
+   blame.lineCommits.reserve(mLineCommits.count());
 
-   if (!revision.sha().isEmpty())
+   for (auto i = 1; i < mCommits.count(); ++i)
    {
-      auto log = revision.shortLog();
-
-      if (log.count() > 47)
-         log = log.left(47) + QString("...");
-
-      commitMsg = log;
+      const auto &commit = mCommits.at(i);
+      blame.commits.append({ commit.sha, commit.author, commit.dateTime, commit.title });
    }
 
-   const auto messageLabel = new ClickableFrame(commitMsg, Qt::AlignTop | Qt::AlignLeft);
-   messageLabel->setObjectName(isFirst ? QString("primusInterPares") : QString("firstOfItsName"));
-   messageLabel->setToolTip(QString("<p>%1</p><p>%2</p>").arg(sha, commitMsg));
-   messageLabel->setFont(mInfoFont);
+   for (auto commit : qAsConst(mLineCommits))
+      blame.lineCommits.append(commit - 1);
 
-   connect(messageLabel, &ClickableFrame::clicked, this, [this, sha]() { emit signalCommitSelected(sha); });
-
-   return messageLabel;
+   mBlameCache->insert(getRepoFilePath(), mBlobSha, mBlobId, blame);
 }
 
-QLabel *FileBlameWidget::createNumLabel(const Annotation &annotation, int row)
+void FileBlameWidget::cancelBlame()
 {
-   const auto numberLabel = new QLabel(QString::number(row + 1));
-   numberLabel->setFont(mCodeFont);
-   numberLabel->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::MinimumExpanding);
-   numberLabel->setObjectName("numberLabel");
-   numberLabel->setAlignment(Qt::AlignVCenter | Qt::AlignRight);
-
-   if (annotation.sha != CommitInfo::ZERO_SHA)
+   if (mBlameProcess)
    {
-      const auto dtSinceEpoch = annotation.dateTime.toSecsSinceEpoch();
-      const auto colorIndex = qCeil((kSecondsNewest - dtSinceEpoch) / kIncrementSecs);
-      numberLabel->setStyleSheet(
-          QString("QLabel { border-left: 5px solid rgb(%1) }").arg(kBorderColors.at(colorIndex)));
+      // The process is not waited: it finishes and deletes itself in background.
+      disconnect(mBlameProcess, nullptr, this, nullptr);
+      mBlameProcess->onKill();
+      mBlameProcess = nullptr;
    }
-   else
-      numberLabel->setStyleSheet("QLabel { border-left: 5px solid #D89000 }");
-
-   return numberLabel;
 }
 
-QLabel *FileBlameWidget::createCodeLabel(const QString &content)
+void FileBlameWidget::updateCommitColors()
 {
-   const auto contentLabel = new QLabel(content);
-   contentLabel->setFont(mCodeFont);
-   contentLabel->setObjectName("normalLabel");
+   qint64 secondsNewest = 0;
+   qint64 secondsOldest = QDateTime::currentDateTime().toSecsSinceEpoch();
+
+   for (const auto &commit : qAsConst(mCommits))
+   {
+      if (commit.dateTime.isValid() && commit.sha != CommitInfo::ZERO_SHA)
+      {
+         const auto dtSinceEpoch = commit.dateTime.toSecsSinceEpoch();
+
+         secondsNewest = std::max(secondsNewest, dtSinceEpoch);
+         secondsOldest = std::min(secondsOldest, dtSinceEpoch);
+      }
+   }
+
+   const auto incrementSecs = std::max<qint64>(1, (secondsNewest - secondsOldest) / (kTotalColors - 1));
 
-   return contentLabel;
+   for (auto &commit : mCommits)
+   {
+      if (commit.sha == CommitInfo::ZERO_SHA)
+         commit.color = QColor("#D89000");
+      else if (commit.dateTime.isValid())
+      {
+         const auto colorIndex = static_cast<int>((secondsNewest - commit.dateTime.toSecsSinceEpoch()) / incrementSecs);
+         commit.color = kAgeColors.at(static_cast<size_t>(std::clamp(colorIndex, 0, kTotalColors - 1)));
+      }
+   }
 }
@@ -23,12 +23,16 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <BlameView.h>
+#include <BlameCache.h>
+
 #include <QFrame>
 #include <QDateTime>
+#include <QHash>
+#include <QPointer>
 
 class GitBase;
-class QScrollArea;
-class ClickableFrame;
+class GitStreamProcess;
 class QLabel;
 class RevisionsCache;
 
@@ -57,15 +61,24 @@ public:
 
     \param cache The internal repository cache.
     \param git The git object to perform Git operations.
+    \param blameCache The cache of the blames of the repository.
     \param parent The parent widget if needed.
    */
    explicit FileBlameWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
-                            QWidget *parent = nullptr);
+                            const QSharedPointer<BlameCache> &blameCache, QWidget *parent = nullptr);
+   /*!
+    \brief Destructor that cancels the blame if it's still running.
+   */
+   ~FileBlameWidget() override;
 
    /*!
     \brief Sets up the widget by providing the file to blame and the last commit SHA where the file was modified. The
     previous sha is passed for general information.
 
+    The content of the file is shown right away and the blame is loaded in background, assigning the lines to their
+    commits as Git finds them. A blame that is still running is canceled. If the file was already blamed with the same
+    content, the blame is taken from the cache instead.
+
     \param fileName The file name to blame.
     \param currentSha The last commit SHA where the file was modified.
     \param previousSha The previous commit SHA where the file was modified.
@@ -95,79 +108,65 @@ public:
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
-   QFrame *mAnotation = nullptr;
+   QSharedPointer<BlameCache> mBlameCache;
+   BlameView *mView = nullptr;
    QLabel *mCurrentSha = nullptr;
    QLabel *mPreviousSha = nullptr;
-   QScrollArea *mScrollArea = nullptr;
-   QFont mInfoFont;
-   QFont mCodeFont;
    QString mCurrentFile;
+   QString mBlobId;
+   QString mBlobSha;
+   QPointer<GitStreamProcess> mBlameProcess;
+   QVector<BlameView::Commit> mCommits;
+   QHash<QString, int> mCommitIndexes;
+   QVector<int> mLineCommits;
+   int mHunkCommit = -1;
+   int mHunkFirstLine = 0;
+   int mHunkLines = 0;
 
    /*!
-    \brief Private class that stores data of a annotation. An annotation is the informatio regarding when a line was
-    last modified.
+    \brief Reads the content of the file in the given commit, or from the work tree for the local changes.
 
+    \param sha The commit SHA.
+    \param content The content of the file split in lines.
+    \return True if the file could be read, otherwise false.
    */
-   struct Annotation
-   {
-      QString sha;
-      QString author;
-      QDateTime dateTime;
-      int line = 0;
-      QString content;
-   };
-
+   bool readContent(const QString &sha, QStringList &content) const;
    /*!
-    \brief Processes a blame converting the git output into a vector of annotations per each line.
+    \brief Shows a blame taken from the cache.
 
-    \param blame The git blame output.
-    \return QVector<Annotation> Vector of the annotations for every line.
+    \param blame The cached blame.
+    \param content The content of the file split in lines.
    */
-   QVector<Annotation> processBlame(const QString &blame);
+   void showCachedBlame(const BlameCache::Blame &blame, const QStringList &content);
    /*!
-    \brief Process all the \p annotations and creates the view of the file with that information.
-
-    \param annotations The annotations to process.
+    \brief Stores the blame that just finished in the cache.
    */
-   void formatAnnotatedFile(const QVector<Annotation> &annotations);
+   void storeBlame();
    /*!
-    \brief Factory method that creates a label with the date and time based on an annotation.
+    \brief Gets the path of the file relative to the root of the repository.
 
-    \param annotation The annotation to process.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return QLabel Returns a newly created QLabel.
+    \return The relative path.
    */
-   QLabel *createDateLabel(const Annotation &annotation, bool isFirst);
+   QString getRepoFilePath() const;
    /*!
-    \brief Factory method that creates a label with the author information based on an annotation.
+    \brief Processes the records of the incremental blame. Every hunk is formed by a header with the SHA of the commit
+    and the lines it covers, the information of the commit the first time it appears and the file name at the end.
 
-    \param author The author to be shown.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return QLabel Returns a newly created QLabel.
+    \param records The lines of the git blame output.
    */
-   QLabel *createAuthorLabel(const QString &author, bool isFirst);
+   void processBlameRecords(const QList<QByteArray> &records);
    /*!
-    \brief Factory method that creates a Clickable frame with the informatio of the commit (SHA and title).
+    \brief Called when the blame process finishes.
 
-    \param sha The sha to show.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return ClickableFrame Returns a newly created ClickableFrame.
+    \param success True if the blame finished correctly, otherwise false.
    */
-   ClickableFrame *createMessageLabel(const QString &sha, bool isFirst);
+   void onBlameFinished(bool success);
    /*!
-    \brief Factory method that creates a label with the number of line. Uses the \p annotation parameter to display a
-    visual help about when the change was done.
-
-    \param annotation The annotation to process.
-    \param row The row to display.
-    \return QLabel Returns a newly created QLabel.
+    \brief Cancels the blame process if it's running.
    */
-   QLabel *createNumLabel(const Annotation &annotation, int row);
+   void cancelBlame();
    /*!
-    \brief Factory method that creates a label with the code line to be displayed.
-
-    \param content The code line to display.
-    \return QLabel Returns a newly created QLable.
+    \brief Updates the colour guide of the commits based on the dates of the commits found so far.
    */
-   QLabel *createCodeLabel(const QString &content);
+   void updateCommitColors();
 };
@@ -1,7 +1,10 @@
 #include "FileDiffWidget.h"
 
 #include <GitHistory.h>
-#include <FileDiffView.h>
+#include <GitBase.h>
+#include <GitStreamProcess.h>
+#include <DiffBuffer.h>
+#include <DiffBufferView.h>
 #include <CommitInfo.h>
 #include <RevisionsCache.h>
 #include <DiffInfoPanel.h>
@@ -14,13 +17,31 @@
 #include <QDateTime>
 #include <QCheckBox>
 
+#include <QLogger.h>
+#include <BenchmarkTool.h>
+
+#include <algorithm>
+
+using namespace QLogger;
+using namespace GitQlientTools;
+
+namespace
+{
+// Every time the user expands the context, it's multiplied until it reaches the maximum.
+constexpr int DEFAULT_CONTEXT_LINES = 10;
+constexpr int CONTEXT_LINES_FACTOR = 4;
+constexpr int MAX_CONTEXT_LINES = 15000;
+}
+
 FileDiffWidget::FileDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointer<RevisionsCache> cache,
                                QWidget *parent)
    : QFrame(parent)
    , mGit(git)
    , mCache(cache)
-   , mNewFile(new FileDiffView())
-   , mOldFile(new FileDiffView())
+   , mNewFile(new DiffBufferView())
+   , mOldFile(new DiffBufferView())
+   , mBuffer(new DiffBuffer())
+   , mContextLines(DEFAULT_CONTEXT_LINES)
    , mGoPrevious(new QPushButton())
    , mGoNext(new QPushButton())
    , mDiffInfoPanel(new DiffInfoPanel(cache))
@@ -39,6 +60,16 @@ FileDiffWidget::FileDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointe
    mNewFile->setObjectName("newFile");
    mOldFile->setObjectName("oldFile");
 
+   QFont font;
+   font.setFamily(QString::fromUtf8("Ubuntu Mono"));
+   mNewFile->setFont(font);
+   mOldFile->setFont(font);
+
+   mNewFile->setMode(mFileVsFile ? DiffBufferView::Mode::NewFile : DiffBufferView::Mode::Unified);
+   mNewFile->setBuffer(mBuffer);
+   mOldFile->setMode(DiffBufferView::Mode::OldFile);
+   mOldFile->setBuffer(mBuffer);
+
    setAttribute(Qt::WA_DeleteOnClose);
 
    mGoPrevious->setIcon(QIcon(":/icons/go_up"));
@@ -85,16 +116,27 @@ FileDiffWidget::FileDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointe
    vLayout->addLayout(optionsLayout);
    vLayout->addLayout(diffLayout);
 
-   connect(mNewFile, &FileDiffView::signalScrollChanged, mOldFile, &FileDiffView::moveScrollBarToPos);
-   connect(mOldFile, &FileDiffView::signalScrollChanged, mNewFile, &FileDiffView::moveScrollBarToPos);
+   connect(mNewFile, &DiffBufferView::signalScrollChanged, mOldFile, &DiffBufferView::moveScrollBarToPos);
+   connect(mOldFile, &DiffBufferView::signalScrollChanged, mNewFile, &DiffBufferView::moveScrollBarToPos);
+   connect(mNewFile, &DiffBufferView::signalExpandContext, this, &FileDiffWidget::expandContext);
+   connect(mOldFile, &DiffBufferView::signalExpandContext, this, &FileDiffWidget::expandContext);
    connect(mFileVsFileCheck, &QCheckBox::toggled, this, &FileDiffWidget::setFileVsFileEnable);
 
    mOldFile->setVisible(mFileVsFile);
 }
 
+FileDiffWidget::~FileDiffWidget()
+{
+   cancelDiff();
+}
+
 void FileDiffWidget::clear()
 {
-   mNewFile->clear();
+   cancelDiff();
+
+   mBuffer.reset(new DiffBuffer());
+   mNewFile->setBuffer(mBuffer);
+   mOldFile->setBuffer(mBuffer);
 }
 
 bool FileDiffWidget::reload()
@@ -107,45 +149,38 @@ bool FileDiffWidget::reload()
 
 bool FileDiffWidget::configure(const QString &currentSha, const QString &previousSha, const QString &file)
 {
+   const auto isNewDiff = file != mCurrentFile || currentSha != mCurrentSha || previousSha != mPreviousSha;
+
    mCurrentFile = file;
    mCurrentSha = currentSha;
    mPreviousSha = previousSha;
 
    mDiffInfoPanel->configure(currentSha, previousSha);
 
-   auto destFile = file;
+   mDestFile = file;
 
-   if (destFile.contains("-->"))
-      destFile = destFile.split("--> ").last().split("(").first().trimmed();
+   if (mDestFile.contains("-->"))
+      mDestFile = mDestFile.split("--> ").last().split("(").first().trimmed();
 
    QScopedPointer<GitHistory> git(new GitHistory(mGit));
-   auto text = git->getFileDiff(currentSha == CommitInfo::ZERO_SHA ? QString() : currentSha, previousSha, destFile);
 
-   auto pos = 0;
-   for (auto i = 0; i < 5; ++i)
-      pos = text.indexOf("\n", pos + 1);
+   if (!git->isFileModified(currentSha == CommitInfo::ZERO_SHA ? QString() : currentSha, previousSha, mDestFile))
+      return false;
 
-   text = text.mid(pos + 1);
-
-   if (!text.isEmpty())
+   // A reload keeps the context and the position of the diff shown.
+   if (isNewDiff)
    {
-      QPair<QStringList, QVector<DiffInfo::ChunkInfo>> oldData;
-      QPair<QStringList, QVector<DiffInfo::ChunkInfo>> newData;
-
-      processDiff(text, newData, oldData);
-
-      mOldFile->blockSignals(true);
-      mOldFile->loadDiff(oldData.first.join('\n'), oldData.second);
-      mOldFile->blockSignals(false);
+      mContextLines = DEFAULT_CONTEXT_LINES;
+      mAnchorNumber = -1;
+   }
+   else
+      mAnchorNumber = mNewFile->firstVisibleNumber();
 
-      mNewFile->blockSignals(true);
-      mNewFile->loadDiff(newData.first.join('\n'), newData.second);
-      mNewFile->blockSignals(false);
+   mAnchorOffset = 0;
 
-      return true;
-   }
+   loadDiff(isNewDiff);
 
-   return false;
+   return true;
 }
 
 void FileDiffWidget::setFileVsFileEnable(bool enable)
@@ -158,109 +193,164 @@ void FileDiffWidget::setFileVsFileEnable(bool enable)
    GitQlientSettings settings;
    settings.setValue("FileVsFile", mFileVsFile);
 
-   configure(mCurrentSha, mPreviousSha, mCurrentFile);
+   mNewFile->setMode(mFileVsFile ? DiffBufferView::Mode::NewFile : DiffBufferView::Mode::Unified);
+
+   updateChunks();
 }
 
 void FileDiffWidget::editMode(const QString &) { }
 
-void FileDiffWidget::processDiff(const QString &text, QPair<QStringList, QVector<DiffInfo::ChunkInfo>> &newFileData,
-                                 QPair<QStringList, QVector<DiffInfo::ChunkInfo>> &oldFileData)
+void FileDiffWidget::loadDiff(bool progressive)
 {
-   DiffInfo diff;
-   // int newFileVariation = 0;
-   int oldFileRow = 1;
-   int newFileRow = 1;
-   mChunks.clear();
+   BenchmarkStart();
 
-   for (auto line : text.split("\n"))
+   cancelDiff();
+
+   mLoadingBuffer.reset(new DiffBuffer());
+
+   if (progressive)
    {
-      if (mFileVsFile)
-      {
-         if (line.startsWith('-'))
-         {
-            line.remove(0, 1);
-
-            if (diff.oldFile.startLine == -1)
-               diff.oldFile.startLine = oldFileRow;
-
-            oldFileData.first.append(line);
-
-            ++oldFileRow;
-         }
-         else if (line.startsWith('+'))
-         {
-            line.remove(0, 1);
-
-            if (diff.newFile.startLine == -1)
-            {
-               diff.newFile.startLine = newFileRow;
-               diff.newFile.addition = true;
-            }
-
-            newFileData.first.append(line);
-
-            ++newFileRow;
-         }
-         else
-         {
-            line.remove(0, 1);
-
-            if (diff.oldFile.startLine != -1)
-               diff.oldFile.endLine = oldFileRow - 1;
-
-            if (diff.newFile.startLine != -1)
-               diff.newFile.endLine = newFileRow - 1;
-
-            if (diff.isValid())
-            {
-               if (diff.newFile.isValid())
-               {
-                  newFileData.second.append(diff.newFile);
-                  mChunks.append(diff.newFile);
-               }
-
-               if (diff.oldFile.isValid())
-               {
-                  oldFileData.second.append(diff.oldFile);
-                  mChunks.append(diff.oldFile);
-               }
-            }
-
-            oldFileData.first.append(line);
-            newFileData.first.append(line);
-
-            diff = DiffInfo();
-
-            ++oldFileRow;
-            ++newFileRow;
-         }
-      }
-      else
+      mBuffer = mLoadingBuffer;
+      mNewFile->setBuffer(mBuffer);
+      mOldFile->setBuffer(mBuffer);
+   }
+
+   auto cmd = QString("git diff --no-color -U%1 %2").arg(mContextLines).arg(mPreviousSha);
+
+   if (mCurrentSha != CommitInfo::ZERO_SHA)
+      cmd.append(QString(" %1").arg(mCurrentSha));
+
+   cmd.append(QString(" -- \"%1\"").arg(mDestFile));
+
+   mDiffProcess = new GitStreamProcess(mGit->getWorkingDir(), '\n');
+
+   connect(mDiffProcess, &GitStreamProcess::signalRecordsReady, this, &FileDiffWidget::processDiffRecords);
+   connect(mDiffProcess, &GitStreamProcess::signalStreamFinished, this, &FileDiffWidget::onDiffFinished);
+
+   if (!mDiffProcess->run(cmd).success)
+   {
+      QLog_Error("UI", QString("Unable to start the diff of the file {%1}.").arg(mDestFile));
+
+      mDiffProcess->deleteLater();
+      mDiffProcess = nullptr;
+
+      onDiffFinished(false);
+   }
+
+   BenchmarkEnd();
+}
+
+void FileDiffWidget::processDiffRecords(const QList<QByteArray> &records)
+{
+   for (const auto &record : records)
+      mLoadingBuffer->append(record);
+
+   if (mLoadingBuffer == mBuffer)
+   {
+      mNewFile->linesAppended();
+      mOldFile->linesAppended();
+   }
+}
+
+void FileDiffWidget::onDiffFinished(bool success)
+{
+   mDiffProcess = nullptr;
+
+   if (!success)
+   {
+      QLog_Warning("UI", QString("The diff of the file {%1} couldn't be read.").arg(mDestFile));
+      return;
+   }
+
+   if (mLoadingBuffer != mBuffer)
+   {
+      mBuffer = mLoadingBuffer;
+      mNewFile->setBuffer(mBuffer);
+      mOldFile->setBuffer(mBuffer);
+   }
+
+   const auto canExpand = mContextLines < MAX_CONTEXT_LINES;
+   mNewFile->setCanExpand(canExpand);
+   mOldFile->setCanExpand(canExpand);
+
+   updateChunks();
+
+   if (mAnchorNumber != -1)
+   {
+      if (const auto row = mNewFile->findRow(mAnchorNumber); row != -1)
       {
-         oldFileData.first.append(line);
-         newFileData.first.append(line);
+         const auto pos = std::max(0, row - mAnchorOffset);
+
+         mNewFile->moveScrollBarToPos(pos);
+         mOldFile->moveScrollBarToPos(pos);
       }
    }
 }
 
+void FileDiffWidget::cancelDiff()
+{
+   if (mDiffProcess)
+   {
+      // The process is not waited: it finishes and deletes itself in background.
+      disconnect(mDiffProcess, nullptr, this, nullptr);
+      mDiffProcess->onKill();
+      mDiffProcess = nullptr;
+   }
+}
+
+void FileDiffWidget::expandContext(int line)
+{
+   if (mDiffProcess || mContextLines >= MAX_CONTEXT_LINES)
+      return;
+
+   // The first line of the new file after the hunk header keeps its position on the screen.
+   mAnchorNumber = -1;
+
+   for (auto next = line + 1; next < mBuffer->count() && mAnchorNumber == -1; ++next)
+      mAnchorNumber = mBuffer->newNumber(next);
+
+   if (mAnchorNumber != -1)
+   {
+      const auto row = mNewFile->findRow(mAnchorNumber);
+      mAnchorOffset = row != -1 ? row - mNewFile->verticalScrollBar()->value() : 0;
+   }
+
+   mContextLines = std::min(mContextLines * CONTEXT_LINES_FACTOR, MAX_CONTEXT_LINES);
+
+   loadDiff(false);
+}
+
+void FileDiffWidget::updateChunks()
+{
+   mChunkRows = mNewFile->getChunkRows();
+
+   if (mFileVsFile)
+      mChunkRows.append(mOldFile->getChunkRows());
+
+   std::sort(mChunkRows.begin(), mChunkRows.end());
+   mChunkRows.erase(std::unique(mChunkRows.begin(), mChunkRows.end()), mChunkRows.end());
+
+   mCurrentChunkLine = -1;
+}
+
 void FileDiffWidget::moveTop()
 {
-   mCurrentChunkLine = 0;
+   mCurrentChunkLine = -1;
 
-   mNewFile->moveScrollBarToPos(mCurrentChunkLine);
-   mOldFile->moveScrollBarToPos(mCurrentChunkLine);
+   mNewFile->moveScrollBarToPos(0);
+   mOldFile->moveScrollBarToPos(0);
 }
 
 void FileDiffWidget::moveChunkUp()
 {
-   for (auto i = mChunks.count() - 1; i >= 0; --i)
+   for (auto i = mChunkRows.count() - 1; i >= 0; --i)
    {
-      if (auto chunkStart = mChunks.at(i).startLine; chunkStart < mCurrentChunkLine)
+      if (auto chunkStart = mChunkRows.at(i); chunkStart < mCurrentChunkLine)
       {
          mCurrentChunkLine = chunkStart;
 
-         mNewFile->moveScrollBarToPos(mCurrentChunkLine - 1);
-         mOldFile->moveScrollBarToPos(mCurrentChunkLine - 1);
+         mNewFile->moveScrollBarToPos(mCurrentChunkLine);
+         mOldFile->moveScrollBarToPos(mCurrentChunkLine);
 
          break;
       }
@@ -269,26 +359,26 @@ void FileDiffWidget::moveChunkUp()
 
 void FileDiffWidget::moveChunkDown()
 {
-   const auto endIter = mChunks.constEnd();
-   auto iter = mChunks.constBegin();
+   const auto endIter = mChunkRows.constEnd();
+   auto iter = mChunkRows.constBegin();
 
    for (; iter != endIter; ++iter)
-      if (iter->startLine > mCurrentChunkLine)
+      if (*iter > mCurrentChunkLine)
          break;
 
    if (iter != endIter)
    {
-      mCurrentChunkLine = iter->startLine;
+      mCurrentChunkLine = *iter;
 
-      mNewFile->moveScrollBarToPos(mCurrentChunkLine - 1);
-      mOldFile->moveScrollBarToPos(mCurrentChunkLine - 1);
+      mNewFile->moveScrollBarToPos(mCurrentChunkLine);
+      mOldFile->moveScrollBarToPos(mCurrentChunkLine);
    }
 }
 
 void FileDiffWidget::moveBottomChunk()
 {
-   mCurrentChunkLine = mNewFile->blockCount();
+   mCurrentChunkLine = mNewFile->rowCount();
 
-   mNewFile->moveScrollBarToPos(mNewFile->blockCount());
-   mOldFile->moveScrollBarToPos(mOldFile->blockCount());
+   mNewFile->moveScrollBarToPos(mNewFile->rowCount());
+   mOldFile->moveScrollBarToPos(mOldFile->rowCount());
 }
@@ -24,9 +24,12 @@
  ***************************************************************************************/
 
 #include <QFrame>
-#include <DiffInfo.h>
+#include <QPointer>
+#include <QVector>
 
-class FileDiffView;
+class DiffBuffer;
+class DiffBufferView;
+class GitStreamProcess;
 class QPushButton;
 class GitBase;
 class DiffInfoPanel;
@@ -51,6 +54,10 @@ public:
    */
    explicit FileDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointer<RevisionsCache> cache,
                            QWidget *parent = nullptr);
+   /*!
+    \brief Destructor that cancels the diff if it's still being read.
+   */
+   ~FileDiffWidget() override;
 
    /*!
     \brief Clears the current information on the diff view.
@@ -64,6 +71,7 @@ public:
    bool reload();
    /*!
     \brief Configures the diff view with the two commits that will be compared and the file that will be applied.
+    The diff is read in background and shown while it's being read.
 
     \param currentSha The base SHA.
     \param previousSha The SHA to compare to.
@@ -94,12 +102,19 @@ public:
 
 private:
    QString mCurrentFile;
+   QString mDestFile;
    QString mCurrentSha;
    QString mPreviousSha;
    QSharedPointer<GitBase> mGit;
    QSharedPointer<RevisionsCache> mCache;
-   FileDiffView *mNewFile = nullptr;
-   FileDiffView *mOldFile = nullptr;
+   DiffBufferView *mNewFile = nullptr;
+   DiffBufferView *mOldFile = nullptr;
+   QSharedPointer<DiffBuffer> mBuffer;
+   QSharedPointer<DiffBuffer> mLoadingBuffer;
+   QPointer<GitStreamProcess> mDiffProcess;
+   int mContextLines = 0;
+   int mAnchorNumber = -1;
+   int mAnchorOffset = 0;
    QPushButton *mGoPrevious = nullptr;
    QPushButton *mGoNext = nullptr;
    DiffInfoPanel *mDiffInfoPanel = nullptr;
@@ -111,11 +126,42 @@ private:
    QPushButton *mGoDown = nullptr;
    QPushButton *mGoBottom = nullptr;
    QFrame *mNavFrame = nullptr;
-   QVector<DiffInfo::ChunkInfo> mChunks;
-   int mCurrentChunkLine = 0;
+   QVector<int> mChunkRows;
+   int mCurrentChunkLine = -1;
+
+   /*!
+    \brief Starts reading the diff with the current amount of context lines.
+
+    \param progressive If true the lines are shown while they are read, otherwise the diff shown is replaced when
+    the new one is completely read. The latter avoids the flickering when the diff is reloaded.
+   */
+   void loadDiff(bool progressive);
+   /*!
+    \brief Appends the lines of the diff read so far.
+
+    \param records The lines of the git diff output.
+   */
+   void processDiffRecords(const QList<QByteArray> &records);
+   /*!
+    \brief Called when the diff process finishes.
 
-   void processDiff(const QString &text, QPair<QStringList, QVector<DiffInfo::ChunkInfo>> &newFileData,
-                    QPair<QStringList, QVector<DiffInfo::ChunkInfo>> &oldFileData);
+    \param success True if the diff finished correctly, otherwise false.
+   */
+   void onDiffFinished(bool success);
+   /*!
+    \brief Cancels the diff process if it's running.
+   */
+   void cancelDiff();
+   /*!
+    \brief Reloads the diff with more context lines, keeping the hunk that was clicked in the same position.
+
+    \param line The index of the hunk header in the buffer.
+   */
+   void expandContext(int line);
+   /*!
+    \brief Updates the rows where the blocks of changes start, used to navigate between them.
+   */
+   void updateChunks();
 
    void moveTop();
    void moveChunkUp();
@@ -113,6 +113,15 @@ AGitProcess::AGitProcess(const QString &workingDir)
            &AGitProcess::onFinished, Qt::DirectConnection);
 }
 
+const QStringList &AGitProcess::gitEnvironment()
+{
+   // The system environment doesn't change during the session, so it's only copied once.
+   static const auto env = QProcess::systemEnvironment() << "GIT_TRACE=0" // avoid choking on debug traces
+                                                         << "GIT_FLUSH=0"; // skip the fflush() in 'git log'
+
+   return env;
+}
+
 void AGitProcess::onCancel()
 {
    BenchmarkStart();
@@ -124,6 +133,14 @@ void AGitProcess::onCancel()
    BenchmarkEnd();
 }
 
+void AGitProcess::onKill()
+{
+   // Unlike onCancel, it doesn't wait for Git to finish: the process is marked as canceled and finishes asynchronously.
+   mCanceling = true;
+
+   kill();
+}
+
 void AGitProcess::onReadyStandardOutput()
 {
    if (!mCanceling)
@@ -145,11 +162,7 @@ bool AGitProcess::execute(const QString &command)
 
    if (!arguments.isEmpty())
    {
-      QStringList env = QProcess::systemEnvironment();
-      env << "GIT_TRACE=0"; // avoid choking on debug traces
-      env << "GIT_FLUSH=0"; // skip the fflush() in 'git log'
-
-      setEnvironment(env);
+      setEnvironment(gitEnvironment());
       setProgram(arguments.takeFirst());
       setArguments(arguments);
       start();
@@ -39,6 +39,9 @@ public:
 
    virtual GitExecResult run(const QString &command) = 0;
    void onCancel();
+   void onKill();
+
+   static const QStringList &gitEnvironment();
 
 protected:
    QString mRunOutput;
@@ -49,7 +52,5 @@ protected:
    bool mCanceling = false;
    bool execute(const QString &command);
    virtual void onFinished(int, QProcess::ExitStatus exitStatus);
-
-private:
-   void onReadyStandardOutput();
+   virtual void onReadyStandardOutput();
 };
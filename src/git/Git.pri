@@ -5,17 +5,22 @@ HEADERS += \
     $$PWD/GitAsyncProcess.h \
     $$PWD/GitBase.h \
     $$PWD/GitBranches.h \
+    $$PWD/GitCatFileProcess.h \
     $$PWD/GitCloneProcess.h \
     $$PWD/GitConfig.h \
+    $$PWD/GitDiffPrefetcher.h \
     $$PWD/GitExecResult.h \
     $$PWD/GitHistory.h \
+    $$PWD/GitJobScheduler.h \
     $$PWD/GitLocal.h \
     $$PWD/GitMerge.h \
     $$PWD/GitPatches.h \
     $$PWD/GitRemote.h \
     $$PWD/GitRepoLoader.h \
+    $$PWD/GitRepoWatcher.h \
     $$PWD/GitRequestorProcess.h \
     $$PWD/GitStashes.h \
+    $$PWD/GitStreamProcess.h \
     $$PWD/GitSubmodules.h \
     $$PWD/GitSyncProcess.h \
     $$PWD/GitTags.h
@@ -25,17 +30,22 @@ SOURCES += \
     $$PWD/GitAsyncProcess.cpp \
     $$PWD/GitBase.cpp \
     $$PWD/GitBranches.cpp \
+    $$PWD/GitCatFileProcess.cpp \
     $$PWD/GitCloneProcess.cpp \
     $$PWD/GitConfig.cpp \
+    $$PWD/GitDiffPrefetcher.cpp \
     $$PWD/GitExecResult.cpp \
     $$PWD/GitHistory.cpp \
+    $$PWD/GitJobScheduler.cpp \
     $$PWD/GitLocal.cpp \
     $$PWD/GitMerge.cpp \
     $$PWD/GitPatches.cpp \
     $$PWD/GitRemote.cpp \
     $$PWD/GitRepoLoader.cpp \
+    $$PWD/GitRepoWatcher.cpp \
     $$PWD/GitRequestorProcess.cpp \
     $$PWD/GitStashes.cpp \
+    $$PWD/GitStreamProcess.cpp \
     $$PWD/GitSubmodules.cpp \
     $$PWD/GitSyncProcess.cpp \
     $$PWD/GitTags.cpp
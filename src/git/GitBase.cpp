@@ -2,6 +2,8 @@
 
 #include <GitSyncProcess.h>
 #include <GitAsyncProcess.h>
+#include <GitCatFileProcess.h>
+#include <GitJobScheduler.h>
 
 #include <QLogger.h>
 #include <BenchmarkTool.h>
@@ -9,7 +11,49 @@
 using namespace QLogger;
 using namespace GitQlientTools;
 
+#include <QCoreApplication>
 #include <QDir>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadStorage>
+
+namespace
+{
+// Every thread keeps its own cat-file processes since QProcess can't be shared between threads.
+constexpr int MAX_CAT_FILE_REPOS = 4;
+QThreadStorage<QList<QSharedPointer<GitCatFileProcess>>> catFileProcesses;
+
+GitCatFileProcess &catFileProcess(const QString &workingDir)
+{
+   auto &processes = catFileProcesses.localData();
+
+   for (auto i = 0; i < processes.count(); ++i)
+   {
+      if (processes.at(i)->getWorkingDir() == workingDir)
+      {
+         processes.move(i, 0);
+         return *processes.constFirst();
+      }
+   }
+
+   processes.prepend(QSharedPointer<GitCatFileProcess>::create(workingDir));
+
+   if (processes.count() > MAX_CAT_FILE_REPOS)
+      processes.removeLast();
+
+   return *processes.constFirst();
+}
+
+// Bounds the amount of git processes that the background threads run at the same time. The GUI thread is never
+// throttled: it would freeze while the jobs hold all the slots.
+QSemaphore &processPool()
+{
+   static QSemaphore pool(qMax(2, QThread::idealThreadCount()));
+
+   return pool;
+}
+}
 
 GitBase::GitBase(const QString &workingDirectory, QObject *parent)
    : QObject(parent)
@@ -27,14 +71,30 @@ void GitBase::setWorkingDir(const QString &workingDir)
    mWorkingDirectory = workingDir;
 }
 
-GitExecResult GitBase::run(const QString &cmd) const
+GitExecResult GitBase::run(const QString &cmd, const QByteArray &input) const
 {
    BenchmarkStart();
 
+   const auto app = QCoreApplication::instance();
+   const auto throttled = !app || QThread::currentThread() != app->thread();
+
+   if (throttled)
+      processPool().acquire();
+
+   // The process belongs to this thread, so it's not killed from the others: it checks by itself if it's canceled,
+   // either through cancelAll or because the job that runs it is canceled.
+   const auto cancelEpoch = mCancelEpoch.loadAcquire();
    GitSyncProcess p(mWorkingDirectory);
-   connect(this, &GitBase::cancelAllProcesses, &p, &AGitProcess::onCancel);
+   p.setCancelCheck([this, cancelEpoch]() {
+      return mCancelEpoch.loadAcquire() != cancelEpoch || GitJobScheduler::isCurrentJobCanceled();
+   });
+   p.setStandardInput(input);
 
    const auto ret = p.run(cmd);
+
+   if (throttled)
+      processPool().release();
+
    const auto runOutput = ret.output.toString();
 
    if (ret.success)
@@ -53,6 +113,34 @@ GitExecResult GitBase::run(const QString &cmd) const
    return ret;
 }
 
+GitExecResult GitBase::resolveRevision(const QString &revision) const
+{
+   BenchmarkStart();
+
+   const auto ret = catFileProcess(mWorkingDirectory).resolveRevision(revision);
+
+   if (!ret.success)
+      QLog_Trace("Git", QString("Unable to resolve the revision {%1}: %2").arg(revision, ret.output.toString()));
+
+   BenchmarkEnd();
+
+   return ret;
+}
+
+GitExecResult GitBase::readObject(const QString &revision) const
+{
+   BenchmarkStart();
+
+   const auto ret = catFileProcess(mWorkingDirectory).readObject(revision);
+
+   if (!ret.success)
+      QLog_Warning("Git", QString("Unable to read the object {%1}: %2").arg(revision, ret.output.toString()));
+
+   BenchmarkEnd();
+
+   return ret;
+}
+
 bool GitBase::runAsync(const QString &cmd) const
 {
    BenchmarkStart();
@@ -68,6 +156,15 @@ bool GitBase::runAsync(const QString &cmd) const
    return ret.success;
 }
 
+void GitBase::cancelAll()
+{
+   QLog_Info("Git", QString("Canceling the git processes in {%1}.").arg(mWorkingDirectory));
+
+   mCancelEpoch.fetchAndAddRelease(1);
+
+   emit cancelAllProcesses(QPrivateSignal());
+}
+
 void GitBase::updateCurrentBranch()
 {
    BenchmarkStart();
@@ -75,8 +172,10 @@ void GitBase::updateCurrentBranch()
    QLog_Trace("Git", "Updating the current branch");
 
    const auto ret = run("git rev-parse --abbrev-ref HEAD");
+   const auto currentBranch = ret.success ? ret.output.toString().trimmed().remove("heads/") : QString();
 
-   mCurrentBranch = ret.success ? ret.output.toString().trimmed().remove("heads/") : QString();
+   QMutexLocker lock(&mCurrentBranchMutex);
+   mCurrentBranch = currentBranch;
 
    BenchmarkEnd();
 }
@@ -85,8 +184,14 @@ QString GitBase::getCurrentBranch()
 {
    QLog_Trace("Git", "Executing getCurrentBranch");
 
+   QMutexLocker lock(&mCurrentBranchMutex);
+
    if (mCurrentBranch.isEmpty())
+   {
+      lock.unlock();
       updateCurrentBranch();
+      lock.relock();
+   }
 
    return mCurrentBranch;
 }
@@ -97,7 +202,7 @@ GitExecResult GitBase::getLastCommit() const
 
    QLog_Trace("Git", "Executing getLastCommit");
 
-   const auto ret = run("git rev-parse HEAD");
+   const auto ret = resolveRevision("HEAD");
 
    BenchmarkEnd();
 
@@ -26,6 +26,8 @@
 #include <GitExecResult.h>
 #include <RevisionsCache.h>
 
+#include <QAtomicInt>
+#include <QMutex>
 #include <QObject>
 #include <QSharedPointer>
 
@@ -40,10 +42,16 @@ signals:
 public:
    explicit GitBase(const QString &workingDirectory, QObject *parent = nullptr);
 
-   GitExecResult run(const QString &cmd) const;
+   GitExecResult run(const QString &cmd, const QByteArray &input = QByteArray()) const;
+
+   GitExecResult resolveRevision(const QString &revision) const;
+
+   GitExecResult readObject(const QString &revision) const;
 
    bool runAsync(const QString &cmd) const;
 
+   void cancelAll();
+
    QString getWorkingDir() const;
 
    void setWorkingDir(const QString &workingDir);
@@ -57,4 +65,10 @@ public:
 protected:
    QString mWorkingDirectory;
    QString mCurrentBranch;
+
+private:
+   // The current branch is read from the GUI thread, the loader thread and the jobs.
+   QMutex mCurrentBranchMutex;
+   // Increased by cancelAll: the synchronous processes started before are killed.
+   QAtomicInt mCancelEpoch;
 };
@@ -203,10 +203,7 @@ GitExecResult GitBranches::getLastCommitOfBranch(const QString &branch)
 
    QLog_Debug("Git", QString("Executing getLastCommitOfBranch: {%1}").arg(branch));
 
-   auto ret = mGitBase->run(QString("git rev-parse %1").arg(branch));
-
-   if (ret.success)
-      ret.output = ret.output.toString().trimmed();
+   const auto ret = mGitBase->resolveRevision(branch);
 
    BenchmarkEnd();
 
@@ -0,0 +1,127 @@
+#include "GitCatFileProcess.h"
+
+#include <AGitProcess.h>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+namespace
+{
+constexpr int CAT_FILE_TIMEOUT = 10000;
+}
+
+GitCatFileProcess::GitCatFileProcess(const QString &workingDir)
+   : mWorkingDir(workingDir)
+{
+}
+
+GitCatFileProcess::~GitCatFileProcess()
+{
+   stop(mCheckProcess);
+   stop(mBatchProcess);
+}
+
+GitExecResult GitCatFileProcess::resolveRevision(const QString &revision)
+{
+   QByteArray header;
+
+   if (!request(mCheckProcess, "--batch-check", revision, header))
+      return { false, QString::fromUtf8(header) };
+
+   return { true, QString::fromLatin1(header.left(header.indexOf(' '))) };
+}
+
+GitExecResult GitCatFileProcess::readObject(const QString &revision)
+{
+   QByteArray header;
+
+   if (!request(mBatchProcess, "--batch", revision, header))
+      return { false, QString::fromUtf8(header) };
+
+   // The header has the format: <sha> <type> <size>
+   const auto size = header.mid(header.lastIndexOf(' ') + 1).toLongLong();
+   QByteArray data;
+
+   if (!readBytes(mBatchProcess, size, data))
+      return { false, QString("Unable to read the object %1").arg(revision) };
+
+   return { true, data };
+}
+
+bool GitCatFileProcess::request(QProcess &process, const QString &mode, const QString &revision, QByteArray &header)
+{
+   // A new line would be taken as a second request and the pipe would get out of sync.
+   if (revision.isEmpty() || revision.contains('\n'))
+   {
+      header = QString("Invalid revision: %1").arg(revision).toUtf8();
+      return false;
+   }
+
+   if (process.state() != QProcess::Running)
+   {
+      process.setWorkingDirectory(mWorkingDir);
+      process.setEnvironment(AGitProcess::gitEnvironment());
+      process.start("git", { "cat-file", mode });
+
+      if (!process.waitForStarted())
+      {
+         QLog_Warning("Git", QString("Unable to start git cat-file %1:\n%2").arg(mode, process.errorString()));
+         header = process.errorString().toUtf8();
+         return false;
+      }
+
+      QLog_Debug("Git", QString("Process started: git cat-file %1").arg(mode));
+   }
+
+   process.write(revision.toUtf8().append('\n'));
+
+   while (!process.canReadLine())
+   {
+      if (!process.waitForReadyRead(CAT_FILE_TIMEOUT))
+      {
+         QLog_Warning("Git", QString("git cat-file %1 didn't answer for {%2}").arg(mode, revision));
+         header = QString("Timeout resolving %1").arg(revision).toUtf8();
+         stop(process);
+         return false;
+      }
+   }
+
+   header = process.readLine();
+   header.chop(1);
+
+   // Unknown revisions are reported as "<revision> missing" or "<revision> ambiguous".
+   return !header.endsWith(" missing") && !header.endsWith(" ambiguous");
+}
+
+bool GitCatFileProcess::readBytes(QProcess &process, qint64 size, QByteArray &data)
+{
+   // The content is followed by a line feed.
+   while (process.bytesAvailable() < size + 1)
+   {
+      if (!process.waitForReadyRead(CAT_FILE_TIMEOUT))
+      {
+         stop(process);
+         return false;
+      }
+   }
+
+   data = process.read(size);
+   process.read(1);
+
+   return true;
+}
+
+void GitCatFileProcess::stop(QProcess &process)
+{
+   if (process.state() == QProcess::NotRunning)
+      return;
+
+   process.closeWriteChannel();
+
+   if (!process.waitForFinished(1000))
+   {
+      process.kill();
+      process.waitForFinished();
+   }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitExecResult.h>
+
+#include <QProcess>
+
+/**
+ * @brief The GitCatFileProcess class keeps a git cat-file process alive for a repository so object and metadata
+ * queries are answered through its pipes instead of forking a new git process each time.
+ *
+ * The --batch-check process is used to resolve revisions and the --batch one to read the content of objects. Both are
+ * started lazily the first time they are needed and restarted if they die or get out of sync.
+ *
+ * The class is not thread-safe: the processes must be used from the thread that created them.
+ */
+class GitCatFileProcess
+{
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param workingDir The working directory of the repository.
+    */
+   explicit GitCatFileProcess(const QString &workingDir);
+   /**
+    * @brief Destructor that closes the pipes and lets the processes finish.
+    */
+   ~GitCatFileProcess();
+
+   /**
+    * @brief getWorkingDir Returns the working directory of the repository.
+    * @return The working directory.
+    */
+   QString getWorkingDir() const { return mWorkingDir; }
+
+   /**
+    * @brief resolveRevision Resolves a revision (SHA, branch, tag, HEAD, rev^{commit}...) to its full SHA.
+    *
+    * @param revision The revision to resolve.
+    * @return Returns the SHA of the object or the error reported by git.
+    */
+   GitExecResult resolveRevision(const QString &revision);
+
+   /**
+    * @brief readObject Reads the raw content of an object.
+    *
+    * @param revision The revision of the object (for example <sha>:<file>).
+    * @return Returns the content as a QByteArray or the error reported by git.
+    */
+   GitExecResult readObject(const QString &revision);
+
+private:
+   QString mWorkingDir;
+   QProcess mCheckProcess;
+   QProcess mBatchProcess;
+
+   bool request(QProcess &process, const QString &mode, const QString &revision, QByteArray &header);
+   bool readBytes(QProcess &process, qint64 size, QByteArray &data);
+   void stop(QProcess &process);
+};
@@ -0,0 +1,115 @@
+#include "GitDiffPrefetcher.h"
+
+#include <GitBase.h>
+#include <GitHistory.h>
+#include <RevisionsCache.h>
+
+#include <QLogger.h>
+#include <BenchmarkTool.h>
+
+#include <QHash>
+#include <QScopedPointer>
+
+using namespace QLogger;
+using namespace GitQlientTools;
+
+namespace
+{
+// Rows loaded before and after the selected one. Moving down in the history is more common than moving up.
+constexpr int ROWS_BEFORE = 8;
+constexpr int ROWS_AFTER = 24;
+}
+
+GitDiffPrefetcher::GitDiffPrefetcher(const QSharedPointer<GitBase> &git, const QSharedPointer<RevisionsCache> &cache)
+   : mGit(git)
+   , mCache(cache)
+{
+}
+
+void GitDiffPrefetcher::setSelectedCommit(const QString &sha)
+{
+   QMutexLocker lock(&mMutex);
+
+   mSelectedSha = sha;
+}
+
+GitExecResult GitDiffPrefetcher::prefetch()
+{
+   BenchmarkStart();
+
+   QMutexLocker lock(&mMutex);
+   const auto sha = mSelectedSha;
+   lock.unlock();
+
+   const auto row = mCache->getCommitPos(sha);
+
+   if (row == -1)
+   {
+      BenchmarkEnd();
+      return { false, QString() };
+   }
+
+   const auto revisions = mCache->getUncachedRevisionFiles(row - ROWS_BEFORE, row + ROWS_AFTER);
+
+   if (revisions.isEmpty())
+   {
+      BenchmarkEnd();
+      return { true, QString::number(0) };
+   }
+
+   QLog_Debug("Git", QString("Prefetching the files of {%1} commits around {%2}.").arg(revisions.count()).arg(row));
+
+   QScopedPointer<GitHistory> git(new GitHistory(mGit));
+   const auto ret = git->getDiffFiles(revisions);
+
+   if (!ret.success)
+   {
+      BenchmarkEnd();
+      return ret;
+   }
+
+   QHash<QString, QString> parents;
+   parents.reserve(revisions.count());
+
+   for (const auto &revision : revisions)
+      parents.insert(revision.first, revision.second);
+
+   const auto output = ret.output.toString();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   const auto lines = output.split('\n', Qt::SkipEmptyParts);
+#else
+   const auto lines = output.split('\n', QString::SkipEmptyParts);
+#endif
+
+   // The files of every commit come after a line with its SHA.
+   QString commitSha;
+   QString commitDiff;
+   auto loaded = 0;
+
+   const auto storeFiles = [this, &parents, &commitSha, &commitDiff, &loaded]() {
+      if (const auto parent = parents.value(commitSha); !parent.isEmpty())
+      {
+         mCache->insertRevisionFile(commitSha, parent, mCache->parseDiff(commitDiff));
+         ++loaded;
+      }
+   };
+
+   for (const auto &line : lines)
+   {
+      if (line.startsWith(':'))
+         commitDiff.append(line).append('\n');
+      else
+      {
+         storeFiles();
+
+         commitSha = line.trimmed();
+         commitDiff.clear();
+      }
+   }
+
+   storeFiles();
+
+   BenchmarkEnd();
+
+   return { true, QString::number(loaded) };
+}
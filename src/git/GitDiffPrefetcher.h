@@ -0,0 +1,72 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitExecResult.h>
+
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+class GitBase;
+class RevisionsCache;
+
+/**
+ * @brief The GitDiffPrefetcher class loads in advance the files changed by the commits around the selected one, so
+ * moving through the history with the keyboard finds them already in the cache.
+ *
+ * The files of all the commits of the window are requested to a single git diff-tree process. The prefetch is meant
+ * to be run as a background job: only the last selected commit is taken into account when it runs.
+ */
+class GitDiffPrefetcher
+{
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param git The git object to perform Git operations.
+    * @param cache The cache where the files are stored.
+    */
+   explicit GitDiffPrefetcher(const QSharedPointer<GitBase> &git, const QSharedPointer<RevisionsCache> &cache);
+
+   /**
+    * @brief setSelectedCommit Sets the commit around which the next prefetch loads the files.
+    *
+    * @param sha The SHA of the selected commit.
+    */
+   void setSelectedCommit(const QString &sha);
+
+   /**
+    * @brief prefetch Loads the files of the commits around the selected one that are not cached yet.
+    *
+    * @return The result of the git command. The output only contains the amount of commits loaded.
+    */
+   GitExecResult prefetch();
+
+private:
+   QSharedPointer<GitBase> mGit;
+   QSharedPointer<RevisionsCache> mCache;
+   QMutex mMutex;
+   QString mSelectedSha;
+};
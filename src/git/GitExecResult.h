@@ -33,6 +33,8 @@ struct GitExecResult
    GitExecResult(const QPair<bool, QVariant> &result);
    GitExecResult(const QPair<bool, QString> &result);
    GitExecResult &operator=(const QPair<bool, QString> &result);
-   bool success;
+   bool success = false;
    QVariant output;
 };
+
+Q_DECLARE_METATYPE(GitExecResult)
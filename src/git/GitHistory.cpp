@@ -13,19 +13,6 @@ GitHistory::GitHistory(const QSharedPointer<GitBase> &gitBase)
 {
 }
 
-GitExecResult GitHistory::blame(const QString &file, const QString &commitFrom)
-{
-   BenchmarkStart();
-
-   QLog_Debug("Git", QString("Executing blame: {%1} from {%2}").arg(file, commitFrom));
-
-   const auto ret = mGitBase->run(QString("git annotate %1 %2").arg(file, commitFrom));
-
-   BenchmarkEnd();
-
-   return ret;
-}
-
 GitExecResult GitHistory::history(const QString &file)
 {
    BenchmarkStart();
@@ -76,22 +63,21 @@ GitExecResult GitHistory::getCommitDiff(const QString &sha, const QString &diffT
    return qMakePair(false, QString());
 }
 
-QString GitHistory::getFileDiff(const QString &currentSha, const QString &previousSha, const QString &file)
+bool GitHistory::isFileModified(const QString &currentSha, const QString &previousSha, const QString &file)
 {
    BenchmarkStart();
 
-   QLog_Debug("Git", QString("Executing getFileDiff: {%1} between {%2} and {%3}").arg(file, currentSha, previousSha));
+   QLog_Debug("Git",
+              QString("Executing isFileModified: {%1} between {%2} and {%3}").arg(file, currentSha, previousSha));
 
-   const auto ret = mGitBase->run(QString("git diff -U15000 %1 %2 %3").arg(previousSha, currentSha, file));
+   // Only the objects are compared, so the cost doesn't depend on the size of the file.
+   const auto ret = mGitBase->run(QString("git diff --name-only %1 %2 -- %3").arg(previousSha, currentSha, file));
 
-   if (ret.success)
-   {
-      BenchmarkEnd();
-      return ret.output.toString();
-   }
+   const auto output = ret.output.toString().trimmed();
 
    BenchmarkEnd();
-   return QString();
+
+   return ret.success && !output.isEmpty() && !output.startsWith("fatal:");
 }
 
 GitExecResult GitHistory::getDiffFiles(const QString &sha, const QString &diffToSha)
@@ -109,3 +95,22 @@ GitExecResult GitHistory::getDiffFiles(const QString &sha, const QString &diffTo
 
    return mGitBase->run(runCmd);
 }
+
+GitExecResult GitHistory::getDiffFiles(const QVector<QPair<QString, QString>> &revisions)
+{
+   BenchmarkStart();
+
+   QLog_Debug("Git", QString("Executing getDiffFiles for {%1} commits").arg(revisions.count()));
+
+   // Every line is a commit followed by the one to compare with. Git prints the SHA of the commit before its files.
+   QByteArray input;
+
+   for (const auto &revision : revisions)
+      input.append(QString("%1 %2\n").arg(revision.first, revision.second).toLatin1());
+
+   const auto ret = mGitBase->run("git diff-tree -C --no-color -r -m --always --stdin", input);
+
+   BenchmarkEnd();
+
+   return ret;
+}
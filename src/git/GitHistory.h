@@ -25,7 +25,9 @@
 
 #include <GitExecResult.h>
 
+#include <QPair>
 #include <QSharedPointer>
+#include <QVector>
 
 class GitBase;
 
@@ -34,11 +36,11 @@ class GitHistory
 public:
    explicit GitHistory(const QSharedPointer<GitBase> &gitBase);
 
-   GitExecResult blame(const QString &file, const QString &commitFrom);
    GitExecResult history(const QString &file);
    GitExecResult getCommitDiff(const QString &sha, const QString &diffToSha);
-   QString getFileDiff(const QString &currentSha, const QString &previousSha, const QString &file);
+   bool isFileModified(const QString &currentSha, const QString &previousSha, const QString &file);
    GitExecResult getDiffFiles(const QString &sha, const QString &diffToSha);
+   GitExecResult getDiffFiles(const QVector<QPair<QString, QString>> &revisions);
 
 private:
    QSharedPointer<GitBase> mGitBase;
@@ -0,0 +1,196 @@
+#include "GitJobScheduler.h"
+
+#include <QLogger.h>
+
+#include <QThreadPool>
+#include <QThreadStorage>
+#include <QtConcurrent/QtConcurrentRun>
+
+using namespace QLogger;
+
+namespace
+{
+// Every scheduler runs one job at a time. The pool is shared so a destroyed scheduler doesn't wait for its last job.
+QThreadPool &jobsPool()
+{
+   static QThreadPool pool;
+
+   return pool;
+}
+
+// The cancel flag of the job that runs in every thread of the pool.
+QThreadStorage<QSharedPointer<QAtomicInt>> currentJobCanceled;
+}
+
+GitJobScheduler::GitJobScheduler(QObject *parent)
+   : QObject(parent)
+   , mState(new State())
+{
+   qRegisterMetaType<GitExecResult>("GitExecResult");
+
+   mState->scheduler = this;
+}
+
+GitJobScheduler::~GitJobScheduler()
+{
+   cancelAll();
+
+   QMutexLocker lock(&mState->mutex);
+   mState->scheduler = nullptr;
+}
+
+int GitJobScheduler::schedule(const QString &key, GitJobPriority priority, const std::function<GitExecResult()> &job)
+{
+   QMutexLocker lock(&mState->mutex);
+
+   for (auto i = 0; i < mState->userJobs.count(); ++i)
+   {
+      if (mState->userJobs.at(i).key == key)
+         return mState->userJobs.at(i).id;
+   }
+
+   for (auto i = 0; i < mState->backgroundJobs.count(); ++i)
+   {
+      if (mState->backgroundJobs.at(i).key == key)
+      {
+         const auto id = mState->backgroundJobs.at(i).id;
+
+         // The user is waiting for it now, so the pending job jumps to the user queue.
+         if (priority == GitJobPriority::User)
+            mState->userJobs.append(mState->backgroundJobs.takeAt(i));
+
+         QLog_Trace("Git", QString("Job {%1} merged with the pending one.").arg(key));
+
+         return id;
+      }
+   }
+
+   const auto id = ++mState->lastId;
+
+   const auto canceled = QSharedPointer<QAtomicInt>::create(0);
+
+   (priority == GitJobPriority::User ? mState->userJobs : mState->backgroundJobs).append({ id, key, job, canceled });
+
+   if (!mState->processing)
+   {
+      mState->processing = true;
+      QtConcurrent::run(&jobsPool(), [state = mState]() { processJobs(state); });
+   }
+
+   return id;
+}
+
+bool GitJobScheduler::cancel(int jobId)
+{
+   QMutexLocker lock(&mState->mutex);
+
+   // The running job's processes check the flag from the job's thread and kill themselves.
+   if (mState->runningJob.id == jobId)
+   {
+      mState->runningJob.canceled->storeRelease(1);
+      return true;
+   }
+
+   for (auto jobs : { &mState->userJobs, &mState->backgroundJobs })
+   {
+      for (auto i = 0; i < jobs->count(); ++i)
+      {
+         if (jobs->at(i).id == jobId)
+         {
+            const auto job = jobs->takeAt(i);
+
+            lock.unlock();
+
+            emit signalJobCanceled(job.id, job.key);
+
+            return true;
+         }
+      }
+   }
+
+   return false;
+}
+
+void GitJobScheduler::cancelAll()
+{
+   QMutexLocker lock(&mState->mutex);
+
+   const auto jobs = mState->userJobs + mState->backgroundJobs;
+
+   mState->userJobs.clear();
+   mState->backgroundJobs.clear();
+
+   if (mState->runningJob.id != -1)
+      mState->runningJob.canceled->storeRelease(1);
+
+   lock.unlock();
+
+   for (const auto &job : jobs)
+      emit signalJobCanceled(job.id, job.key);
+}
+
+bool GitJobScheduler::isPending(const QString &key) const
+{
+   QMutexLocker lock(&mState->mutex);
+
+   if (mState->runningJob.id != -1 && mState->runningJob.key == key)
+      return true;
+
+   for (const auto &job : mState->userJobs + mState->backgroundJobs)
+   {
+      if (job.key == key)
+         return true;
+   }
+
+   return false;
+}
+
+bool GitJobScheduler::isCurrentJobCanceled()
+{
+   const auto canceled = currentJobCanceled.localData();
+
+   return canceled && canceled->loadAcquire() != 0;
+}
+
+void GitJobScheduler::processJobs(const QSharedPointer<State> &state)
+{
+   forever
+   {
+      QMutexLocker lock(&state->mutex);
+
+      if (state->userJobs.isEmpty() && state->backgroundJobs.isEmpty())
+      {
+         state->processing = false;
+         return;
+      }
+
+      state->runningJob = !state->userJobs.isEmpty() ? state->userJobs.takeFirst() : state->backgroundJobs.takeFirst();
+
+      const auto job = state->runningJob;
+
+      lock.unlock();
+
+      QLog_Debug("Git", QString("Running job {%1}.").arg(job.key));
+
+      currentJobCanceled.setLocalData(job.canceled);
+
+      const auto result = job.run();
+
+      currentJobCanceled.setLocalData(QSharedPointer<QAtomicInt>());
+
+      lock.relock();
+
+      const auto canceled = job.canceled->loadAcquire() != 0;
+
+      state->runningJob = Job();
+
+      // The signals are emitted with the lock held, so the scheduler can't be destroyed meanwhile.
+      if (const auto scheduler = state->scheduler)
+      {
+         if (canceled)
+            emit scheduler->signalJobCanceled(job.id, job.key);
+         else
+            emit scheduler->signalJobFinished(job.id, job.key, result);
+      }
+   }
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitExecResult.h>
+
+#include <QAtomicInt>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+
+#include <functional>
+
+/**
+ * @brief The GitJobPriority enum defines the queues of the GitJobScheduler. Jobs triggered by the user are always run
+ * before the background refresh jobs.
+ */
+enum class GitJobPriority
+{
+   User,
+   Background
+};
+
+/**
+ * @brief The GitJobScheduler class runs the git operations of a repository in a background thread so the GUI thread
+ * never waits for a git process.
+ *
+ * The jobs are run one after another, user jobs first, so two operations never fight for the repository locks. A job
+ * scheduled with the same key than a job that is still waiting in the queue is merged with it. The result of every job
+ * is delivered through the signalJobFinished signal.
+ *
+ * The queues are shared with the background thread, so the scheduler can be destroyed while a job is running: the job
+ * finishes on its own and its result is discarded.
+ */
+class GitJobScheduler : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief signalJobFinished Signal triggered when a job has been executed.
+    *
+    * @param jobId The id of the job.
+    * @param key The key the job was scheduled with.
+    * @param result The result returned by the job.
+    */
+   void signalJobFinished(int jobId, const QString &key, const GitExecResult &result);
+   /**
+    * @brief signalJobCanceled Signal triggered when a job is canceled. If the job was already running, its result is
+    * discarded.
+    *
+    * @param jobId The id of the job.
+    * @param key The key the job was scheduled with.
+    */
+   void signalJobCanceled(int jobId, const QString &key);
+
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param parent The parent object.
+    */
+   explicit GitJobScheduler(QObject *parent = nullptr);
+   /**
+    * @brief Destructor. Cancels the pending jobs and the running one without waiting for it to finish.
+    */
+   ~GitJobScheduler() override;
+
+   /**
+    * @brief schedule Adds a job to the queue of the given priority. If there is a pending job with the same key, the
+    * new job is merged with it and the id of the pending job is returned.
+    *
+    * @param key The key that identifies the kind of job (for example "fetch").
+    * @param priority The priority of the job.
+    * @param job The operation to run in the background. It must not access any widget.
+    * @return The id of the job.
+    */
+   int schedule(const QString &key, GitJobPriority priority, const std::function<GitExecResult()> &job);
+
+   /**
+    * @brief cancel Cancels a job. If the job is running, the git processes it runs through GitBase are killed; the
+    * processes of other jobs and threads are not affected.
+    *
+    * @param jobId The id of the job.
+    * @return True if the job was pending or running, otherwise false.
+    */
+   bool cancel(int jobId);
+
+   /**
+    * @brief cancelAll Cancels all the pending jobs and the running one.
+    */
+   void cancelAll();
+
+   /**
+    * @brief isPending Checks if a job with the given key is waiting or running.
+    *
+    * @param key The key of the job.
+    * @return True if the job is waiting or running, otherwise false.
+    */
+   bool isPending(const QString &key) const;
+
+   /**
+    * @brief isCurrentJobCanceled Checks if the job running in the calling thread has been canceled. It's always false
+    * outside of a job.
+    *
+    * @return True if the job has been canceled, otherwise false.
+    */
+   static bool isCurrentJobCanceled();
+
+private:
+   struct Job
+   {
+      int id = -1;
+      QString key;
+      std::function<GitExecResult()> run;
+      // Set from any thread when the job is canceled.
+      QSharedPointer<QAtomicInt> canceled;
+   };
+
+   // The state shared with the background thread. The scheduler is null once it's destroyed.
+   struct State
+   {
+      QMutex mutex;
+      GitJobScheduler *scheduler = nullptr;
+      QList<Job> userJobs;
+      QList<Job> backgroundJobs;
+      Job runningJob;
+      bool processing = false;
+      int lastId = 0;
+   };
+
+   QSharedPointer<State> mState;
+
+   static void processJobs(const QSharedPointer<State> &state);
+};
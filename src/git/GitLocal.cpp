@@ -259,7 +259,7 @@ GitExecResult GitLocal::updateIndex(const RevisionFiles &files, const QStringLis
 
    for (const auto &file : selFiles)
    {
-      const auto index = files.mFiles.indexOf(file);
+      const auto index = files.indexOf(file);
 
       if (index != -1 && files.statusCmp(index, RevisionFiles::DELETED))
          toRemove << file;
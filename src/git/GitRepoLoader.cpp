@@ -2,19 +2,40 @@
 
 #include <GitBase.h>
 #include <RevisionsCache.h>
-#include <GitRequestorProcess.h>
-#include <GitBranches.h>
+#include <CacheSnapshot.h>
+#include <GitStreamProcess.h>
+#include <GitConfig.h>
 
 #include <QLogger.h>
 #include <BenchmarkTool.h>
 
 #include <QDir>
+#include <QSet>
+
+#include <algorithm>
 
 using namespace QLogger;
 using namespace GitQlientTools;
 
 static const QString GIT_LOG_FORMAT("%m%HX%P%n%cn<%ce>%n%an<%ae>%n%at%n%s%n%b ");
 
+namespace
+{
+// Above this amount of changed directories a full refresh is cheaper than the pathspecs.
+constexpr int MAX_WIP_PATHSPECS = 64;
+
+QString quotePath(const QString &path)
+{
+   return path.contains(' ') ? QString("$%1$").arg(path) : path;
+}
+
+QString getStatusCommand()
+{
+   // The optional locks would make git refresh the index, which is watched to trigger this very same command.
+   return QString("git --no-optional-locks status --porcelain=v2 -z --branch --untracked-files=all");
+}
+}
+
 GitRepoLoader::GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<RevisionsCache> cache, QObject *parent)
    : QObject(parent)
    , mGitBase(gitBase)
@@ -62,6 +83,94 @@ bool GitRepoLoader::loadRepository()
    return false;
 }
 
+void GitRepoLoader::setShowAll(bool showAll)
+{
+   // The history changes completely so it can't be updated incrementally.
+   if (showAll != mShowAll)
+      mTips.clear();
+
+   mShowAll = showAll;
+}
+
+bool GitRepoLoader::updateRepository()
+{
+   BenchmarkStart();
+
+   if (mTips.isEmpty())
+   {
+      BenchmarkEnd();
+      return loadRepository();
+   }
+
+   if (mLocked)
+   {
+      QLog_Warning("Git", "Git is currently loading data.");
+
+      BenchmarkEnd();
+      return false;
+   }
+
+   const auto previousBranch = mGitBase->getCurrentBranch();
+
+   mGitBase->updateCurrentBranch();
+
+   // The commits of the previous branch that are not in the new one can't be removed incrementally.
+   if (mGitBase->getCurrentBranch() != previousBranch)
+   {
+      QLog_Info("Git", "The current branch changed, the repository will be fully reloaded.");
+
+      BenchmarkEnd();
+      return loadRepository();
+   }
+
+   QLog_Info("Git", "Updating the repository...");
+
+   mLocked = true;
+
+   const auto wipInfo = processWip();
+   const auto previousTips = mTips;
+
+   mTips = getTips(wipInfo.parentSha);
+
+   // The views are notified once, when the references are loaded again.
+   mRevCache->beginUpdate();
+
+   if (previousTips != mTips)
+   {
+      QList<QByteArray> newCommits;
+
+      if (!getCommitsSince(previousTips, newCommits))
+      {
+         QLog_Info("Git", "The history has been rewritten, the repository will be fully reloaded.");
+
+         mRevCache->endUpdate();
+         mLocked = false;
+
+         BenchmarkEnd();
+         return loadRepository();
+      }
+
+      mSnapshotUpToDate = false;
+
+      mRevCache->updateWipCommit(wipInfo.parentSha, wipInfo.status);
+
+      if (const auto insertedRows = mRevCache->prependCommits(newCommits); insertedRows > 0)
+         emit signalRevisionsInserted(1, insertedRows);
+
+      mRevCache->clearReferences();
+   }
+   else
+      mRevCache->updateWipCommit(wipInfo.parentSha, wipInfo.status);
+
+   onRevisionsLoaded(true);
+
+   mRevCache->endUpdate();
+
+   BenchmarkEnd();
+
+   return true;
+}
+
 bool GitRepoLoader::configureRepoDirectory()
 {
    BenchmarkStart();
@@ -95,10 +204,7 @@ void GitRepoLoader::loadReferences()
 
    if (ret3.success)
    {
-      auto ret = mGitBase->getLastCommit();
-
-      if (ret.success)
-         ret.output = ret.output.toString().trimmed();
+      const auto ret = mGitBase->getLastCommit();
 
       QString prevRefSha;
       const auto curBranchSHA = ret.output.toString();
@@ -109,6 +215,9 @@ void GitRepoLoader::loadReferences()
       const auto referencesList = ret3.output.toString().split('\n', QString::SkipEmptyParts);
 #endif
 
+      QVector<QPair<QString, QString>> localBranchesShas;
+      QHash<QString, QString> remoteBranchesShas;
+
       for (const auto &reference : referencesList)
       {
          const auto revSha = reference.left(40);
@@ -143,79 +252,360 @@ void GitRepoLoader::loadReferences()
             mRevCache->insertReference(revSha, type, name);
 
             if (localBranches)
-            {
-               const auto git = new GitBranches(mGitBase);
-               RevisionsCache::LocalBranchDistances distances;
-
-               const auto distToMaster = git->getDistanceBetweenBranches(true, name);
-               auto toMaster = distToMaster.output.toString();
-
-               if (!toMaster.contains("fatal"))
-               {
-                  toMaster.replace('\n', "");
-                  const auto values = toMaster.split('\t');
-                  distances.behindMaster = values.first().toUInt();
-                  distances.aheadMaster = values.last().toUInt();
-               }
-
-               const auto distToOrigin = git->getDistanceBetweenBranches(false, name);
-               auto toOrigin = distToOrigin.output.toString();
-
-               if (!toOrigin.contains("fatal"))
-               {
-                  toOrigin.replace('\n', "");
-                  const auto values = toOrigin.split('\t');
-                  distances.behindOrigin = values.first().toUInt();
-                  distances.aheadOrigin = values.last().toUInt();
-               }
-
-               mRevCache->insertLocalBranchDistances(name, distances);
-            }
+               localBranchesShas.append(qMakePair(name, revSha));
+            else if (type == References::Type::RemoteBranches)
+               remoteBranchesShas.insert(name, revSha);
          }
 
          prevRefSha = revSha;
       }
+
+      loadLocalBranchesDistances(localBranchesShas, remoteBranchesShas);
    }
 
    BenchmarkEnd();
 }
 
+void GitRepoLoader::loadLocalBranchesDistances(const QVector<QPair<QString, QString>> &localBranchesShas,
+                                               const QHash<QString, QString> &remoteBranchesShas)
+{
+   BenchmarkStart();
+
+   QLog_Debug("Git", QString("Calculating the distances of {%1} local branches.").arg(localBranchesShas.count()));
+
+   QScopedPointer<GitConfig> gitConfig(new GitConfig(mGitBase));
+   const auto masterRemote = gitConfig->getRemoteForBranch("master");
+   const auto masterRef
+       = masterRemote.success ? QString("%1/master").arg(masterRemote.output.toString()) : QString("master");
+   auto masterSha = remoteBranchesShas.value(masterRef);
+
+   if (masterSha.isEmpty())
+   {
+      const auto isMaster = [masterRef](const QPair<QString, QString> &branch) { return branch.first == masterRef; };
+      const auto iter = std::find_if(localBranchesShas.cbegin(), localBranchesShas.cend(), isMaster);
+
+      if (iter != localBranchesShas.cend())
+         masterSha = iter->second;
+   }
+
+   const auto upstreamDistances = getUpstreamDistances();
+   QHash<QString, QPair<int, int>> masterDistances;
+   auto masterDistancesLoaded = false;
+
+   for (const auto &branch : localBranchesShas)
+   {
+      RevisionsCache::LocalBranchDistances distances;
+
+      // The history is already loaded, so the distance to master is calculated walking it. Git is only asked for the
+      // branches that are not part of the loaded history, all of them in the same call.
+      if (!masterSha.isEmpty()
+          && !mRevCache->getDistance(masterSha, branch.second, distances.behindMaster, distances.aheadMaster))
+      {
+         if (!masterDistancesLoaded)
+         {
+            masterDistances = getMasterDistances(masterRef);
+            masterDistancesLoaded = true;
+         }
+
+         if (const auto iter = masterDistances.constFind(branch.first); iter != masterDistances.constEnd())
+         {
+            distances.behindMaster = iter->first;
+            distances.aheadMaster = iter->second;
+         }
+         else
+         {
+            // Git versions older than 2.41 don't support the ahead-behind field, so the distance is asked per branch.
+            const auto ret
+                = mGitBase->run(QString("git rev-list --left-right --count %1...%2").arg(masterRef, branch.first));
+
+            if (ret.success)
+            {
+               const auto values = ret.output.toString().trimmed().split('\t');
+               distances.behindMaster = values.first().toInt();
+               distances.aheadMaster = values.last().toInt();
+            }
+         }
+      }
+
+      const auto upstream = upstreamDistances.value(branch.first);
+      distances.behindOrigin = upstream.first;
+      distances.aheadOrigin = upstream.second;
+
+      mRevCache->insertLocalBranchDistances(branch.first, distances);
+   }
+
+   BenchmarkEnd();
+}
+
+QHash<QString, QPair<int, int>> GitRepoLoader::getMasterDistances(const QString &masterRef) const
+{
+   QHash<QString, QPair<int, int>> distances;
+   const auto ret = mGitBase->run(
+       QString("git for-each-ref --format=%(refname)%09%(ahead-behind:%1) refs/heads").arg(masterRef));
+
+   if (!ret.success)
+      return distances;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   const auto lines = ret.output.toString().split('\n', Qt::SkipEmptyParts);
+#else
+   const auto lines = ret.output.toString().split('\n', QString::SkipEmptyParts);
+#endif
+
+   // Every line has the branch and the number of commits it's ahead and behind master separated by a space.
+   for (const auto &line : lines)
+   {
+      const auto fields = line.split('\t');
+      const auto values = fields.value(1).split(' ');
+
+      if (values.count() == 2)
+         distances.insert(fields.first().mid(QString("refs/heads/").length()),
+                          qMakePair(values.last().toInt(), values.first().toInt()));
+   }
+
+   return distances;
+}
+
+QHash<QString, QPair<int, int>> GitRepoLoader::getUpstreamDistances() const
+{
+   QHash<QString, QPair<int, int>> distances;
+   const auto ret = mGitBase->run("git for-each-ref --format=%(refname)%09%(upstream:track,nobracket) refs/heads");
+
+   if (!ret.success)
+      return distances;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   const auto lines = ret.output.toString().split('\n', Qt::SkipEmptyParts);
+#else
+   const auto lines = ret.output.toString().split('\n', QString::SkipEmptyParts);
+#endif
+
+   // The tracking information has the format "ahead N, behind M", where any of the parts can be missing.
+   for (const auto &line : lines)
+   {
+      const auto fields = line.split('\t');
+      auto &distance = distances[fields.first().mid(QString("refs/heads/").length())];
+
+      for (const auto &track : fields.value(1).split(", "))
+      {
+         if (track.startsWith("behind "))
+            distance.first = track.mid(7).toInt();
+         else if (track.startsWith("ahead "))
+            distance.second = track.mid(6).toInt();
+      }
+   }
+
+   return distances;
+}
+
 void GitRepoLoader::requestRevisions()
 {
    BenchmarkStart();
 
    QLog_Debug("Git", "Loading revisions.");
 
+   const auto wipInfo = processWip();
+
+   mTips = getTips(wipInfo.parentSha);
+   mRevCache->setup(wipInfo, {});
+   mRevCache->beginUpdate();
+
+   if (restoreSnapshot())
+   {
+      emit signalLoadingStarted(mRevCache->count());
+
+      onRevisionsLoaded(true);
+      mRevCache->endUpdate();
+
+      BenchmarkEnd();
+      return;
+   }
+
+   mRevCache->endUpdate();
+
+   emit signalLoadingStarted(mRevCache->count());
+
    const auto baseCmd = QString("git log --date-order --no-color --log-size --parents --boundary -z --pretty=format:")
                             .append(GIT_LOG_FORMAT)
                             .append(mShowAll ? QString("--all") : mGitBase->getCurrentBranch());
 
-   const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
-   connect(requestor, &GitRequestorProcess::procDataReady, this, &GitRepoLoader::processRevision);
+   const auto requestor = new GitStreamProcess(mGitBase->getWorkingDir());
+   connect(requestor, &GitStreamProcess::signalRecordsReady, this, &GitRepoLoader::processRevisions);
+   connect(requestor, &GitStreamProcess::signalStreamFinished, this, &GitRepoLoader::onRevisionsLoaded);
    connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
 
-   requestor->run(baseCmd);
+   if (!requestor->run(baseCmd).success)
+   {
+      QLog_Error("Git", "Unable to start the process to load the revisions.");
+
+      requestor->deleteLater();
+
+      onRevisionsLoaded(false);
+   }
 
    BenchmarkEnd();
 }
 
-void GitRepoLoader::processRevision(const QByteArray &ba)
+QByteArray GitRepoLoader::getTips(const QString &headSha) const
+{
+   const auto ret = mGitBase->run("git show-ref -d");
+
+   return QString("%1 HEAD\n%2").arg(headSha, ret.success ? ret.output.toString() : QString()).toUtf8();
+}
+
+bool GitRepoLoader::restoreSnapshot()
 {
    BenchmarkStart();
 
-   QLog_Info("Git", "Revisions received!");
+   CacheSnapshot snapshot(mGitBase->getWorkingDir(), mShowAll, mRevCache->isLazyGraph());
+   mSnapshotUpToDate = false;
 
-   QLog_Debug("Git", "Processing revisions...");
+   if (!snapshot.open())
+   {
+      BenchmarkEnd();
+      return false;
+   }
 
-   const auto &commits = ba.split('\000');
+   const auto previousTips = snapshot.getTips();
 
-   emit signalLoadingStarted(commits.count());
+   if (previousTips == mTips)
+   {
+      QLog_Info("Git", "Loading revisions from the snapshot.");
 
-   const auto wipInfo = processWip();
+      mSnapshotUpToDate = snapshot.restore(*mRevCache);
+
+      BenchmarkEnd();
+
+      return mSnapshotUpToDate;
+   }
+
+   QList<QByteArray> newCommits;
+
+   if (getCommitsSince(previousTips, newCommits) && snapshot.restore(*mRevCache))
+   {
+      QLog_Info("Git", QString("Loading revisions from the snapshot plus {%1} new revisions.").arg(newCommits.count()));
+
+      mRevCache->clearReferences();
+      mRevCache->prependCommits(newCommits);
+
+      BenchmarkEnd();
+
+      return true;
+   }
+
+   BenchmarkEnd();
+
+   return false;
+}
+
+bool GitRepoLoader::getCommitsSince(const QByteArray &previousTips, QList<QByteArray> &commits)
+{
+   // When only the current branch is shown, the commits of the other references are not part of the history.
+   const auto toShaSet = [showAll = mShowAll](const QByteArray &tips) {
+      QSet<QByteArray> shas;
+
+      for (const auto &line : tips.split('\n'))
+      {
+         if (line.size() >= 40 && (showAll || line.mid(41) == "HEAD"))
+            shas.insert(line.left(40));
+      }
+
+      return shas;
+   };
+
+   const auto previousShas = toShaSet(previousTips);
+   const auto currentShas = toShaSet(mTips);
+   const auto removedShas = QSet<QByteArray>(previousShas).subtract(currentShas);
+   const auto addedShas = QSet<QByteArray>(currentShas).subtract(previousShas);
+
+   if (!removedShas.isEmpty())
+   {
+      // If any commit of the snapshot is not reachable anymore the history was rewritten and it's reloaded.
+      const auto ret = mGitBase->run("git rev-list --count --stdin", getRevisionsInput(removedShas, currentShas));
+
+      if (!ret.success || ret.output.toString().trimmed().toInt() != 0)
+         return false;
+   }
+
+   if (addedShas.isEmpty())
+      return true;
+
+   // The revisions go through the standard input, so there is no limit in the number of references.
+   const auto cmd = QString("git log --date-order --no-color --log-size --parents -z --stdin --pretty=format:")
+                        .append(GIT_LOG_FORMAT);
+
+   auto success = false;
+   const auto requestor = new GitStreamProcess(mGitBase->getWorkingDir());
+   connect(requestor, &GitStreamProcess::signalRecordsReady, this,
+           [&commits](const QList<QByteArray> &records) { commits.append(records); });
+   connect(requestor, &GitStreamProcess::signalStreamFinished, this, [&success](bool finished) { success = finished; });
+   connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+
+   if (!requestor->run(cmd).success)
+   {
+      QLog_Error("Git", "Unable to start the process to load the new revisions.");
+
+      requestor->deleteLater();
+
+      return false;
+   }
+
+   // The process finishes in this thread, so the records are delivered before waitForFinished returns.
+   requestor->write(getRevisionsInput(addedShas, previousShas));
+   requestor->closeWriteChannel();
+   requestor->waitForFinished(-1);
+
+   // The lambdas reference local variables.
+   disconnect(requestor, nullptr, this, nullptr);
+
+   return success;
+}
+
+QByteArray GitRepoLoader::getRevisionsInput(const QSet<QByteArray> &included, const QSet<QByteArray> &excluded)
+{
+   QByteArray input;
+
+   for (const auto &sha : included)
+      input.append(sha).append('\n');
+
+   for (const auto &sha : excluded)
+      input.append('^').append(sha).append('\n');
 
-   mRevCache->setup(wipInfo, commits);
+   return input;
+}
+
+void GitRepoLoader::processRevisions(const QList<QByteArray> &commits)
+{
+   BenchmarkStart();
+
+   QLog_Debug("Git", QString("Processing {%1} revisions...").arg(commits.count()));
 
+   const auto totalCommits = mRevCache->appendCommits(commits);
+
+   emit signalLoadingProgress(totalCommits);
+
+   BenchmarkEnd();
+}
+
+void GitRepoLoader::onRevisionsLoaded(bool success)
+{
+   BenchmarkStart();
+
+   if (success)
+      QLog_Info("Git", "All revisions received!");
+   else
+      QLog_Warning("Git", "The revisions were not loaded correctly.");
+
+   // The references are inserted one by one, but the views are only notified once.
+   mRevCache->beginUpdate();
    loadReferences();
+   mRevCache->endUpdate();
+
+   if (success && !mSnapshotUpToDate)
+   {
+      CacheSnapshot snapshot(mGitBase->getWorkingDir(), mShowAll, mRevCache->isLazyGraph());
+      mSnapshotUpToDate = snapshot.save(*mRevCache, mTips);
+   }
 
    mRevCache->setConfigurationDone();
 
@@ -232,25 +622,25 @@ WipRevisionInfo GitRepoLoader::processWip()
 
    QLog_Debug("Git", QString("Executing processWip."));
 
-   mRevCache->setUntrackedFilesList(getUntrackedFiles());
+   // The changes notified until now are covered by the full refresh.
+   {
+      QMutexLocker lock(&mWipMutex);
+      mPendingWipDirs.clear();
+      mPendingWipTrees.clear();
+   }
+
+   // A single status gives HEAD, the staged and unstaged changes and the untracked files.
+   const auto ret = mGitBase->run(getStatusCommand());
 
-   const auto ret = mGitBase->run("git rev-parse --revs-only HEAD");
+   BenchmarkEnd();
 
    if (ret.success)
    {
-      const auto parentSha = ret.output.toString().trimmed();
-
-      const auto ret3 = mGitBase->run(QString("git diff-index %1").arg(parentSha));
-      const auto diffIndex = ret3.success ? ret3.output.toString() : QString();
+      const auto status = ret.output.toString();
 
-      const auto ret4 = mGitBase->run(QString("git diff-index --cached %1").arg(parentSha));
-      const auto diffIndexCached = ret4.success ? ret4.output.toString() : QString();
-
-      return { parentSha, diffIndex, diffIndexCached };
+      return { WorkTreeStatus::parseParentSha(status), status };
    }
 
-   BenchmarkEnd();
-
    return {};
 }
 
@@ -259,33 +649,98 @@ void GitRepoLoader::updateWipRevision()
    BenchmarkStart();
 
    if (const auto wipInfo = processWip(); wipInfo.isValid())
-      mRevCache->updateWipCommit(wipInfo.parentSha, wipInfo.diffIndex, wipInfo.diffIndexCached);
+      mRevCache->updateWipCommit(wipInfo.parentSha, wipInfo.status);
 
    BenchmarkEnd();
 }
 
-QVector<QString> GitRepoLoader::getUntrackedFiles() const
+void GitRepoLoader::addWipChanges(const QStringList &dirs, const QStringList &trees)
+{
+   QMutexLocker lock(&mWipMutex);
+
+   for (const auto &dir : dirs)
+      mPendingWipDirs.insert(dir);
+
+   for (const auto &tree : trees)
+      mPendingWipTrees.insert(tree);
+}
+
+void GitRepoLoader::requestWipUpdate(bool full)
+{
+   QMutexLocker lock(&mWipMutex);
+
+   mFullWipUpdate = mFullWipUpdate || full;
+
+   if (!mWipUpdateQueued)
+   {
+      mWipUpdateQueued = true;
+      QMetaObject::invokeMethod(this, "runWipUpdate", Qt::QueuedConnection);
+   }
+}
+
+void GitRepoLoader::runWipUpdate()
+{
+   QMutexLocker lock(&mWipMutex);
+
+   const auto full = mFullWipUpdate;
+
+   mWipUpdateQueued = false;
+   mFullWipUpdate = false;
+
+   lock.unlock();
+
+   if (full)
+      updateWipRevision();
+   else
+      updateWipChanges();
+
+   emit signalWipUpdated();
+}
+
+void GitRepoLoader::updateWipChanges()
 {
    BenchmarkStart();
 
-   QLog_Debug("Git", QString("Executing getUntrackedFiles."));
+   QMutexLocker lock(&mWipMutex);
 
-   auto runCmd = QString("git ls-files --others");
-   const auto exFile = QString(".git/info/exclude");
-   const auto path = QString("%1/%2").arg(mGitBase->getWorkingDir(), exFile);
+   const auto dirs = mPendingWipDirs;
+   const auto trees = mPendingWipTrees;
 
-   if (QFile::exists(path))
-      runCmd.append(QString(" --exclude-from=$%1$").arg(exFile));
+   mPendingWipDirs.clear();
+   mPendingWipTrees.clear();
 
-   runCmd.append(QString(" --exclude-per-directory=$%1$").arg(".gitignore"));
+   lock.unlock();
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-   const auto ret = mGitBase->run(runCmd).output.toString().split('\n', Qt::SkipEmptyParts).toVector();
-#else
-   const auto ret = mGitBase->run(runCmd).output.toString().split('\n', QString::SkipEmptyParts).toVector();
-#endif
+   if (dirs.isEmpty() && trees.isEmpty())
+   {
+      BenchmarkEnd();
+      return;
+   }
 
-   BenchmarkEnd();
+   if (dirs.count() + trees.count() > MAX_WIP_PATHSPECS)
+   {
+      updateWipRevision();
+
+      BenchmarkEnd();
+      return;
+   }
+
+   QLog_Debug("Git", QString("Updating the WIP for {%1} changed directories.").arg(dirs.count() + trees.count()));
+
+   // The directories only contain the files directly under them, the trees contain all their descendants.
+   QStringList pathspecs;
+
+   for (const auto &dir : dirs)
+      pathspecs.append(quotePath(dir.isEmpty() ? QString(":(glob)*") : QString(":(glob)%1/*").arg(dir)));
 
-   return ret;
+   for (const auto &tree : trees)
+      pathspecs.append(quotePath(tree));
+
+   const auto ret = mGitBase->run(QString("%1 -- %2").arg(getStatusCommand(), pathspecs.join(' ')));
+
+   // The cache refuses the partial status if HEAD moved.
+   if (!ret.success || !mRevCache->updateWipChanges(ret.output.toString(), dirs, trees))
+      updateWipRevision();
+
+   BenchmarkEnd();
 }
@@ -25,7 +25,10 @@
 
 #include <GitExecResult.h>
 
+#include <QHash>
+#include <QMutex>
 #include <QObject>
+#include <QSet>
 #include <QSharedPointer>
 #include <QVector>
 
@@ -39,27 +42,59 @@ class GitRepoLoader : public QObject
 
 signals:
    void signalLoadingStarted(int total);
+   void signalLoadingProgress(int total);
+   void signalRevisionsInserted(int row, int count);
    void signalLoadingFinished();
+   void signalWipUpdated();
    void cancelAllProcesses(QPrivateSignal);
 
 public:
    explicit GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<RevisionsCache> cache,
                           QObject *parent = nullptr);
    bool loadRepository();
+   bool updateRepository();
    void updateWipRevision();
+   void addWipChanges(const QStringList &dirs, const QStringList &trees);
+   void updateWipChanges();
+   /**
+    * @brief Requests a refresh of the WIP in the thread of the loader, so it never runs at the same time than a load.
+    * The requests done before the refresh starts are merged and signalWipUpdated is emitted when it finishes. It can be
+    * called from any thread.
+    *
+    * @param full True to refresh the whole work tree, false to refresh only the changes added with addWipChanges.
+    */
+   void requestWipUpdate(bool full);
    void cancelAll();
-   void setShowAll(bool showAll = true) { mShowAll = showAll; }
+   void setShowAll(bool showAll = true);
 
 private:
    bool mShowAll = true;
    bool mLocked = false;
+   bool mSnapshotUpToDate = false;
+   QByteArray mTips;
    QSharedPointer<GitBase> mGitBase;
    QSharedPointer<RevisionsCache> mRevCache;
 
+   // Directories changed in the work tree since the last WIP refresh.
+   QMutex mWipMutex;
+   QSet<QString> mPendingWipDirs;
+   QSet<QString> mPendingWipTrees;
+   bool mWipUpdateQueued = false;
+   bool mFullWipUpdate = false;
+
+   Q_INVOKABLE void runWipUpdate();
    bool configureRepoDirectory();
    void loadReferences();
+   void loadLocalBranchesDistances(const QVector<QPair<QString, QString>> &localBranchesShas,
+                                   const QHash<QString, QString> &remoteBranchesShas);
+   QHash<QString, QPair<int, int>> getUpstreamDistances() const;
+   QHash<QString, QPair<int, int>> getMasterDistances(const QString &masterRef) const;
    void requestRevisions();
-   void processRevision(const QByteArray &ba);
+   QByteArray getTips(const QString &headSha) const;
+   bool restoreSnapshot();
+   bool getCommitsSince(const QByteArray &previousTips, QList<QByteArray> &commits);
+   static QByteArray getRevisionsInput(const QSet<QByteArray> &included, const QSet<QByteArray> &excluded);
+   void processRevisions(const QList<QByteArray> &commits);
+   void onRevisionsLoaded(bool success);
    WipRevisionInfo processWip();
-   QVector<QString> getUntrackedFiles() const;
 };
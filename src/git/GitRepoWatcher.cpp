@@ -0,0 +1,420 @@
+#include "GitRepoWatcher.h"
+
+#include <GitBase.h>
+#include <GitJobScheduler.h>
+
+#include <QLogger.h>
+#include <BenchmarkTool.h>
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+#include <algorithm>
+
+using namespace QLogger;
+using namespace GitQlientTools;
+
+namespace
+{
+// The batch is reported after this amount of windows even if the events keep coming.
+constexpr int MAX_BATCH_WINDOWS = 10;
+constexpr int CHECK_IGNORE_CHUNK = 200;
+constexpr int DEFAULT_BATCH_WINDOW = 500;
+
+const QStringList METADATA_FILES { "index", "HEAD", "packed-refs" };
+const QString WATCH_DIRS_JOB = "watcher-dirs";
+const QString CHECK_IGNORE_JOB = "watcher-check-ignore";
+
+QStringList splitOutput(const QString &output, QChar separator)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   return output.split(separator, Qt::SkipEmptyParts);
+#else
+   return output.split(separator, QString::SkipEmptyParts);
+#endif
+}
+
+// Gets the git directory and the directories of the work tree with tracked or not ignored files.
+GitExecResult findWatchedDirs(const QSharedPointer<GitBase> &git)
+{
+   const auto ret = git->run("git rev-parse --git-dir");
+   const auto gitDir = ret.success ? ret.output.toString().trimmed() : QString(".git");
+   const auto files = git->run("git ls-files -z --cached --others --exclude-standard");
+   QSet<QString> dirs { QString() };
+
+   for (const auto &file : splitOutput(files.output.toString(), QChar('\0')))
+   {
+      for (auto separator = file.lastIndexOf('/'); separator > 0; separator = file.lastIndexOf('/', separator - 1))
+      {
+         const auto dir = file.left(separator);
+
+         if (dirs.contains(dir))
+            break;
+
+         dirs.insert(dir);
+      }
+   }
+
+   return GitExecResult(true, QVariantList { gitDir, QStringList(dirs.values()) });
+}
+
+// Gets the new directories, relative to the work tree, and the ones that git ignores. The directories are sorted so
+// the parents come first.
+GitExecResult checkIgnoredDirs(const QSharedPointer<GitBase> &git, const QString &workingDir,
+                               const QStringList &newDirs)
+{
+   const auto relativePath = [workingDir](const QString &path) { return path.mid(workingDir.length() + 1); };
+   QStringList candidates;
+
+   for (const auto &newDir : newDirs)
+   {
+      candidates.append(relativePath(newDir));
+
+      QDirIterator it(newDir, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+
+      while (it.hasNext())
+         candidates.append(relativePath(it.next()));
+   }
+
+   QStringList ignored;
+
+   for (auto i = 0; i < candidates.count(); i += CHECK_IGNORE_CHUNK)
+   {
+      QStringList paths;
+
+      for (const auto &candidate : candidates.mid(i, CHECK_IGNORE_CHUNK))
+         paths.append(candidate.contains(' ') ? QString("$%1$").arg(candidate) : candidate);
+
+      const auto ret = git->run(QString("git check-ignore %1").arg(paths.join(' ')));
+
+      ignored.append(splitOutput(ret.output.toString(), '\n'));
+   }
+
+   std::sort(candidates.begin(), candidates.end());
+
+   return GitExecResult(true, QVariantList { candidates, ignored });
+}
+}
+
+GitRepoWatcher::GitRepoWatcher(const QSharedPointer<GitBase> &git, const QSharedPointer<GitJobScheduler> &jobs,
+                               QObject *parent)
+   : QObject(parent)
+   , mGit(git)
+   , mJobs(jobs)
+   , mWatcher(new QFileSystemWatcher(this))
+   , mBatchTimer(new QTimer(this))
+{
+   mBatchTimer->setSingleShot(true);
+   mBatchTimer->setInterval(DEFAULT_BATCH_WINDOW);
+
+   connect(mWatcher, &QFileSystemWatcher::fileChanged, this, &GitRepoWatcher::onFileChanged);
+   connect(mWatcher, &QFileSystemWatcher::directoryChanged, this, &GitRepoWatcher::onDirectoryChanged);
+   connect(mBatchTimer, &QTimer::timeout, this, &GitRepoWatcher::flush);
+   connect(mJobs.data(), &GitJobScheduler::signalJobFinished, this, &GitRepoWatcher::onJobFinished);
+   connect(mJobs.data(), &GitJobScheduler::signalJobCanceled, this, &GitRepoWatcher::onJobCanceled);
+}
+
+void GitRepoWatcher::start()
+{
+   mWorkingDir = QDir::cleanPath(QDir(mGit->getWorkingDir()).absolutePath());
+
+   QLog_Info("UI", QString("Setting the file watcher for dir {%1}").arg(mWorkingDir));
+
+   // Listing the files of a big work tree takes a while, so it's done in the background.
+   mWatchDirsJob = mJobs->schedule(WATCH_DIRS_JOB, GitJobPriority::Background,
+                                   [git = mGit]() { return findWatchedDirs(git); });
+}
+
+void GitRepoWatcher::onJobFinished(int jobId, const QString &, const GitExecResult &result)
+{
+   if (jobId == mWatchDirsJob)
+   {
+      mWatchDirsJob = -1;
+      applyWatchedDirs(result.output.toList());
+   }
+   else if (jobId == mCheckIgnoreJob)
+   {
+      mCheckIgnoreJob = -1;
+      applyNewDirs(result.output.toList());
+   }
+}
+
+void GitRepoWatcher::onJobCanceled(int jobId, const QString &)
+{
+   if (jobId == mWatchDirsJob)
+      mWatchDirsJob = -1;
+   else if (jobId == mCheckIgnoreJob)
+      mCheckIgnoreJob = -1;
+}
+
+void GitRepoWatcher::applyWatchedDirs(const QVariantList &result)
+{
+   BenchmarkStart();
+
+   mGitDir = QDir::cleanPath(QDir(mWorkingDir).absoluteFilePath(result.value(0).toString()));
+
+   watchMetadata();
+
+   const auto dirs = result.value(1).toStringList();
+   QStringList absoluteDirs;
+   absoluteDirs.reserve(dirs.count());
+
+   for (const auto &dir : dirs)
+      absoluteDirs.append(dir.isEmpty() ? mWorkingDir : QString("%1/%2").arg(mWorkingDir, dir));
+
+   watchDirs(absoluteDirs);
+
+   BenchmarkEnd();
+}
+
+void GitRepoWatcher::setBatchWindow(int msecs)
+{
+   mBatchTimer->setInterval(msecs);
+}
+
+void GitRepoWatcher::watchMetadata()
+{
+   const auto watchedFiles = mWatcher->files();
+   QStringList files;
+
+   for (const auto &file : METADATA_FILES)
+   {
+      const auto path = QString("%1/%2").arg(mGitDir, file);
+
+      if (!watchedFiles.contains(path) && QFileInfo::exists(path))
+         files.append(path);
+   }
+
+   if (!files.isEmpty())
+      mWatcher->addPaths(files);
+
+   QStringList dirs;
+
+   if (!mWatchedDirs.contains(mGitDir))
+      dirs.append(mGitDir);
+
+   const auto refsDir = QString("%1/refs").arg(mGitDir);
+
+   if (!mWatchedDirs.contains(refsDir))
+      dirs.append(refsDir);
+
+   QDirIterator it(refsDir, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+   while (it.hasNext())
+   {
+      const auto dir = it.next();
+
+      if (!mWatchedDirs.contains(dir))
+         dirs.append(dir);
+   }
+
+   watchDirs(dirs);
+}
+
+void GitRepoWatcher::watchDirs(const QStringList &dirs)
+{
+   if (dirs.isEmpty())
+      return;
+
+   const auto failed = mWatcher->addPaths(dirs);
+
+   for (const auto &dir : dirs)
+   {
+      if (!failed.contains(dir))
+         mWatchedDirs.insert(dir);
+   }
+
+   if (!failed.isEmpty())
+   {
+      QLog_Warning("UI",
+                   QString("Unable to watch {%1} directories, the system limit was reached.").arg(failed.count()));
+   }
+}
+
+void GitRepoWatcher::watchNewDirs()
+{
+   // The directories found meanwhile are checked when the running job finishes.
+   if (mNewDirs.isEmpty() || mCheckIgnoreJob != -1)
+      return;
+
+   const auto newDirs = mNewDirs.values();
+
+   mNewDirs.clear();
+
+   const auto checkIgnore = [git = mGit, workingDir = mWorkingDir, newDirs]() {
+      return checkIgnoredDirs(git, workingDir, newDirs);
+   };
+
+   mCheckIgnoreJob = mJobs->schedule(CHECK_IGNORE_JOB, GitJobPriority::Background, checkIgnore);
+}
+
+void GitRepoWatcher::applyNewDirs(const QVariantList &result)
+{
+   const auto candidates = result.value(0).toStringList();
+   QSet<QString> ignored;
+
+   for (const auto &path : result.value(1).toStringList())
+      ignored.insert(path);
+
+   QStringList dirs;
+   QSet<QString> skipped;
+
+   for (const auto &candidate : candidates)
+   {
+      const auto separator = candidate.lastIndexOf('/');
+      const auto parent = separator == -1 ? QString() : candidate.left(separator);
+
+      // The parents come first, so the content of an ignored directory is skipped as well.
+      if (ignored.contains(candidate) || skipped.contains(parent))
+      {
+         skipped.insert(candidate);
+         mIgnoredDirs.insert(QString("%1/%2").arg(mWorkingDir, candidate));
+         continue;
+      }
+
+      const auto dir = QString("%1/%2").arg(mWorkingDir, candidate);
+
+      dirs.append(dir);
+
+      if (!mWatchedDirs.contains(parent.isEmpty() ? mWorkingDir : QString("%1/%2").arg(mWorkingDir, parent)))
+         continue;
+
+      // The whole content of a new directory is new.
+      mChangedTrees.insert(dir);
+   }
+
+   watchDirs(dirs);
+
+   if (!mChangedTrees.isEmpty())
+      scheduleBatch();
+
+   watchNewDirs();
+}
+
+void GitRepoWatcher::onFileChanged(const QString &path)
+{
+   if (QFileInfo(path).fileName() == "index")
+      mIndexChanged = true;
+   else
+      mReferencesChanged = true;
+
+   // Git replaces the files instead of modifying them, so the watch gets lost.
+   if (QFileInfo::exists(path) && !mWatcher->files().contains(path))
+      mWatcher->addPath(path);
+
+   scheduleBatch();
+}
+
+void GitRepoWatcher::onDirectoryChanged(const QString &path)
+{
+   if (path == mGitDir)
+   {
+      // Only the metadata files that were replaced matter, the lock files are created and removed all the time.
+      const auto watchedFiles = mWatcher->files();
+
+      for (const auto &file : METADATA_FILES)
+      {
+         const auto filePath = QString("%1/%2").arg(mGitDir, file);
+
+         if (!watchedFiles.contains(filePath) && QFileInfo::exists(filePath))
+         {
+            mWatcher->addPath(filePath);
+
+            if (file == "index")
+               mIndexChanged = true;
+            else
+               mReferencesChanged = true;
+
+            scheduleBatch();
+         }
+      }
+   }
+   else if (path.startsWith(mGitDir + '/'))
+   {
+      mReferencesChanged = true;
+
+      watchMetadata();
+      scheduleBatch();
+   }
+   else
+   {
+      if (!QFileInfo::exists(path))
+      {
+         mWatchedDirs.remove(path);
+         mChangedTrees.insert(path);
+      }
+      else
+      {
+         mChangedDirs.insert(path);
+
+         const auto entries = QDir(path).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden);
+
+         for (const auto &entry : entries)
+         {
+            const auto dir = QString("%1/%2").arg(path, entry);
+
+            if (dir != mGitDir && !mWatchedDirs.contains(dir) && !mIgnoredDirs.contains(dir))
+               mNewDirs.insert(dir);
+         }
+      }
+
+      scheduleBatch();
+   }
+}
+
+void GitRepoWatcher::scheduleBatch()
+{
+   if (!mBatchTimer->isActive())
+   {
+      mBatchStart.start();
+      mBatchTimer->start();
+   }
+   else if (mBatchStart.elapsed() < MAX_BATCH_WINDOWS * mBatchTimer->interval())
+      mBatchTimer->start();
+}
+
+void GitRepoWatcher::flush()
+{
+   BenchmarkStart();
+
+   watchNewDirs();
+
+   if (mIndexChanged)
+      emit signalIndexChanged();
+   else if (!mChangedDirs.isEmpty() || !mChangedTrees.isEmpty())
+   {
+      QStringList dirs;
+      QStringList trees;
+
+      for (const auto &dir : qAsConst(mChangedDirs))
+      {
+         if (!mChangedTrees.contains(dir))
+            dirs.append(relativePath(dir));
+      }
+
+      for (const auto &tree : qAsConst(mChangedTrees))
+         trees.append(relativePath(tree));
+
+      QLog_Debug("UI", QString("Changes in {%1} directories of the work tree.").arg(dirs.count() + trees.count()));
+
+      emit signalWorkTreeChanged(dirs, trees);
+   }
+
+   if (mReferencesChanged)
+      emit signalReferencesChanged();
+
+   mChangedDirs.clear();
+   mChangedTrees.clear();
+   mIndexChanged = false;
+   mReferencesChanged = false;
+
+   BenchmarkEnd();
+}
+
+QString GitRepoWatcher::relativePath(const QString &path) const
+{
+   return path == mWorkingDir ? QString() : path.mid(mWorkingDir.length() + 1);
+}
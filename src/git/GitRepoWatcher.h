@@ -0,0 +1,124 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitExecResult.h>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVariantList>
+
+class GitBase;
+class GitJobScheduler;
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @brief The GitRepoWatcher class watches a repository and reports its changes in batches.
+ *
+ * The work tree directories are watched except the ones ignored by git, so build output or dependencies don't
+ * trigger refreshes. The index, HEAD and the references are watched in the git directory. The events are collected
+ * until no new event arrives during the batch window, and then reported in one go together with the directories that
+ * changed.
+ *
+ * Listing the directories of the work tree and asking git which new directories are ignored is done through the job
+ * scheduler, so the GUI thread never waits for it.
+ */
+class GitRepoWatcher : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief signalWorkTreeChanged Signal triggered when files of the work tree have changed.
+    *
+    * @param dirs The directories, relative to the work tree, whose files changed. Subdirectories are not included.
+    * @param trees The directories, relative to the work tree, that were created or removed with all their content.
+    */
+   void signalWorkTreeChanged(const QStringList &dirs, const QStringList &trees);
+   /**
+    * @brief signalIndexChanged Signal triggered when the git index has changed.
+    */
+   void signalIndexChanged();
+   /**
+    * @brief signalReferencesChanged Signal triggered when HEAD or any reference has changed.
+    */
+   void signalReferencesChanged();
+
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param git The git object to perform Git operations.
+    * @param jobs The scheduler that runs the git operations in the background.
+    * @param parent The parent object.
+    */
+   explicit GitRepoWatcher(const QSharedPointer<GitBase> &git, const QSharedPointer<GitJobScheduler> &jobs,
+                           QObject *parent = nullptr);
+
+   /**
+    * @brief start Starts watching the repository. The directories are watched once git lists them in the background.
+    */
+   void start();
+
+   /**
+    * @brief setBatchWindow Sets the time without new events after which the batched changes are reported.
+    *
+    * @param msecs The window in milliseconds.
+    */
+   void setBatchWindow(int msecs);
+
+private:
+   QSharedPointer<GitBase> mGit;
+   QSharedPointer<GitJobScheduler> mJobs;
+   QFileSystemWatcher *mWatcher = nullptr;
+   QTimer *mBatchTimer = nullptr;
+   QElapsedTimer mBatchStart;
+   QString mWorkingDir;
+   QString mGitDir;
+   QSet<QString> mWatchedDirs;
+   QSet<QString> mChangedDirs;
+   QSet<QString> mChangedTrees;
+   QSet<QString> mNewDirs;
+   QSet<QString> mIgnoredDirs;
+   bool mIndexChanged = false;
+   bool mReferencesChanged = false;
+   int mWatchDirsJob = -1;
+   int mCheckIgnoreJob = -1;
+
+   void onJobFinished(int jobId, const QString &key, const GitExecResult &result);
+   void onJobCanceled(int jobId, const QString &key);
+   void applyWatchedDirs(const QVariantList &result);
+   void watchMetadata();
+   void watchDirs(const QStringList &dirs);
+   void watchNewDirs();
+   void applyNewDirs(const QVariantList &result);
+   void onFileChanged(const QString &path);
+   void onDirectoryChanged(const QString &path);
+   void scheduleBatch();
+   void flush();
+   QString relativePath(const QString &path) const;
+};
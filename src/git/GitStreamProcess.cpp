@@ -0,0 +1,104 @@
+#include "GitStreamProcess.h"
+
+#include <QLogger.h>
+#include <BenchmarkTool.h>
+
+using namespace QLogger;
+using namespace GitQlientTools;
+
+GitStreamProcess::GitStreamProcess(const QString &workingDir, char separator)
+   : AGitProcess(workingDir)
+   , mSeparator(separator)
+{
+}
+
+GitExecResult GitStreamProcess::run(const QString &command)
+{
+   BenchmarkStart();
+
+   const auto ret = execute(command);
+
+   BenchmarkEnd();
+
+   return { ret, "" };
+}
+
+void GitStreamProcess::setBatchSizes(int firstBatchSize, int batchSize)
+{
+   mFirstBatchSize = firstBatchSize;
+   mBatchSize = batchSize;
+}
+
+void GitStreamProcess::onReadyStandardOutput()
+{
+   if (mCanceling)
+      return;
+
+   mBuffer.append(readAllStandardOutput());
+
+   extractRecords();
+
+   const auto threshold = mFirstBatchSent ? mBatchSize : mFirstBatchSize;
+
+   if (mPendingRecords.count() >= threshold)
+      flushRecords();
+}
+
+void GitStreamProcess::onFinished(int code, QProcess::ExitStatus exitStatus)
+{
+   BenchmarkStart();
+
+   // Reading the remaining output here prevents the base class from appending it to the run output.
+   mBuffer.append(readAllStandardOutput());
+
+   AGitProcess::onFinished(code, exitStatus);
+
+   if (!mCanceling)
+   {
+      extractRecords();
+
+      // The last record is not followed by a separator.
+      if (!mBuffer.isEmpty())
+         mPendingRecords.append(mBuffer);
+
+      mBuffer.clear();
+
+      flushRecords();
+
+      QLog_Debug("Git", QString("Stream for process {%1} finished.").arg(mCommand));
+
+      emit signalStreamFinished(!mRealError);
+   }
+
+   deleteLater();
+
+   BenchmarkEnd();
+}
+
+void GitStreamProcess::extractRecords()
+{
+   auto start = 0;
+   auto end = mBuffer.indexOf(mSeparator, start);
+
+   while (end != -1)
+   {
+      mPendingRecords.append(mBuffer.mid(start, end - start));
+      start = end + 1;
+      end = mBuffer.indexOf(mSeparator, start);
+   }
+
+   if (start > 0)
+      mBuffer.remove(0, start);
+}
+
+void GitStreamProcess::flushRecords()
+{
+   if (mPendingRecords.isEmpty())
+      return;
+
+   mFirstBatchSent = true;
+
+   emit signalRecordsReady(mPendingRecords);
+
+   mPendingRecords.clear();
+}
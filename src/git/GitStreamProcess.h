@@ -0,0 +1,72 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <AGitProcess.h>
+
+#include <QList>
+
+/*!
+ \brief The GitStreamProcess runs a Git command asynchronously and splits its standard output in records while the
+ process is still running. Instead of buffering the whole output in a file or in memory, the records are delivered in
+ batches so the consumer can start processing them as soon as Git produces them.
+
+ The first batch is intentionally small so the UI has something to show as soon as possible.
+*/
+class GitStreamProcess : public AGitProcess
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered every time a batch of complete records is available.
+
+    \param records The records without the separator.
+   */
+   void signalRecordsReady(const QList<QByteArray> &records);
+   /*!
+    \brief Signal triggered when the process finished and all the records have been delivered.
+
+    \param success True if Git finished correctly, otherwise false.
+   */
+   void signalStreamFinished(bool success);
+
+public:
+   explicit GitStreamProcess(const QString &workingDir, char separator = '\0');
+   GitExecResult run(const QString &command) override;
+   void setBatchSizes(int firstBatchSize, int batchSize);
+
+private:
+   char mSeparator;
+   int mFirstBatchSize = 500;
+   int mBatchSize = 20000;
+   bool mFirstBatchSent = false;
+   QByteArray mBuffer;
+   QList<QByteArray> mPendingRecords;
+
+   void onReadyStandardOutput() override;
+   void onFinished(int code, QProcess::ExitStatus exitStatus) override;
+   void extractRecords();
+   void flushRecords();
+};
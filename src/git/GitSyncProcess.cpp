@@ -1,8 +1,15 @@
 #include "GitSyncProcess.h"
 
+#include <QElapsedTimer>
 #include <QTemporaryFile>
 #include <QTextStream>
 
+namespace
+{
+constexpr int TIMEOUT_MSECS = 10000;
+constexpr int CANCEL_POLL_MSECS = 50;
+}
+
 GitSyncProcess::GitSyncProcess(const QString &workingDir)
    : AGitProcess(workingDir)
 {
@@ -13,7 +20,32 @@ GitExecResult GitSyncProcess::run(const QString &command)
    const auto processStarted = execute(command);
 
    if (processStarted)
-      waitForFinished(10000);
+   {
+      if (!mInput.isEmpty())
+         write(mInput);
+
+      closeWriteChannel();
+
+      if (!mIsCanceled)
+         waitForFinished(TIMEOUT_MSECS);
+      else
+      {
+         QElapsedTimer timer;
+         timer.start();
+
+         while (state() != QProcess::NotRunning && !waitForFinished(CANCEL_POLL_MSECS)
+                && timer.elapsed() < TIMEOUT_MSECS)
+         {
+            if (mIsCanceled())
+            {
+               mCanceling = true;
+               kill();
+               waitForFinished();
+               break;
+            }
+         }
+      }
+   }
 
    close();
 
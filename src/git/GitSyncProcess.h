@@ -25,10 +25,22 @@
 
 #include "AGitProcess.h"
 
+#include <functional>
+
 class GitSyncProcess final : public AGitProcess
 {
 public:
    GitSyncProcess(const QString &workingDir);
 
    GitExecResult run(const QString &command) override;
+   void setStandardInput(const QByteArray &input) { mInput = input; }
+   /**
+    * @brief Sets the check that run() polls while waiting for the process. The process is killed as soon as it
+    * returns true. Since the check is done from the thread that runs the process, it can be canceled from any thread.
+    */
+   void setCancelCheck(const std::function<bool()> &isCanceled) { mIsCanceled = isCanceled; }
+
+private:
+   QByteArray mInput;
+   std::function<bool()> mIsCanceled;
 };
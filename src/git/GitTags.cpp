@@ -118,10 +118,9 @@ GitExecResult GitTags::getTagCommit(const QString &tagName)
 
    QLog_Debug("Git", QString("Executing getTagCommit: {%1}").arg(tagName));
 
-   const auto ret = mGitBase->run(QString("git rev-list -n 1 %1").arg(tagName));
-   const auto output = ret.output.toString().trimmed();
+   const auto ret = mGitBase->resolveRevision(QString("%1^{commit}").arg(tagName));
 
    BenchmarkEnd();
 
-   return qMakePair(ret.success, output);
+   return ret;
 }
@@ -3,16 +3,23 @@
 #include <CommitHistoryColumns.h>
 #include <CommitInfo.h>
 #include <RevisionsCache.h>
-#include <GitBase.h>
 
 #include <QDateTime>
 #include <QLocale>
+#include <QtConcurrent/QtConcurrentMap>
 
-CommitHistoryModel::CommitHistoryModel(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
-                                       QObject *p)
+#include <algorithm>
+
+namespace
+{
+constexpr int FORMATTING_CHUNK_SIZE = 2000;
+const QString DATE_FORMAT = QStringLiteral("dd MMM yyyy hh:mm");
+}
+
+CommitHistoryModel::CommitHistoryModel(const QSharedPointer<RevisionsCache> &cache, QObject *p)
    : QAbstractItemModel(p)
    , mCache(cache)
-   , mGit(git)
+   , mToolTipDateFormat(QLocale().dateFormat(QLocale::ShortFormat))
 {
    mColumns.insert(CommitHistoryColumns::ID, "Id");
    mColumns.insert(CommitHistoryColumns::GRAPH, "Graph");
@@ -24,7 +31,7 @@ CommitHistoryModel::CommitHistoryModel(const QSharedPointer<RevisionsCache> &cac
 
 int CommitHistoryModel::rowCount(const QModelIndex &parent) const
 {
-   return !parent.isValid() ? mCache->count() : 0;
+   return !parent.isValid() ? mRowCount : 0;
 }
 
 bool CommitHistoryModel::hasChildren(const QModelIndex &parent) const
@@ -40,6 +47,8 @@ QString CommitHistoryModel::sha(int row) const
 void CommitHistoryModel::clear()
 {
    beginResetModel();
+   mRowCount = 0;
+   clearDisplayColumns();
    endResetModel();
    emit headerDataChanged(Qt::Horizontal, 0, 5);
 }
@@ -47,12 +56,131 @@ void CommitHistoryModel::clear()
 void CommitHistoryModel::onNewRevisions(int totalCommits)
 {
    beginResetModel();
+   mRowCount = totalCommits;
+   clearDisplayColumns();
+   buildDisplayColumns(0, totalCommits);
    endResetModel();
+}
+
+void CommitHistoryModel::onRevisionsAppended(int totalCommits)
+{
+   if (totalCommits > mRowCount)
+   {
+      beginInsertRows(QModelIndex(), mRowCount, totalCommits - 1);
+      buildDisplayColumns(mRowCount, totalCommits - mRowCount);
+      mRowCount = totalCommits;
+      endInsertRows();
+   }
+}
 
-   beginInsertRows(QModelIndex(), 0, totalCommits - 2);
+void CommitHistoryModel::onRevisionsInserted(int row, int count)
+{
+   beginInsertRows(QModelIndex(), row, row + count - 1);
+   buildDisplayColumns(row, count);
+   mRowCount += count;
    endInsertRows();
 }
 
+void CommitHistoryModel::buildDisplayColumns(int firstRow, int count)
+{
+   const auto fields = mCache->getDisplayFields(firstRow, count);
+   QVector<int> authorIds(count, -1);
+   QVector<int> dateIds(count, -1);
+   QVector<ObjectId> shas(count);
+   QVector<int> subjectOffsets(count, 0);
+   QVector<int> subjectSizes(count, 0);
+   QVector<qint64> newMinutes;
+
+   for (auto i = 0; i < fields.count(); ++i)
+   {
+      shas[i] = fields.at(i).sha;
+      subjectOffsets[i] = mSubjects.size();
+      subjectSizes[i] = fields.at(i).shortLog.size();
+      mSubjects.append(fields.at(i).shortLog);
+
+      const auto &author = fields.at(i).author;
+      auto authorIter = mAuthorsIndex.constFind(author);
+
+      if (authorIter == mAuthorsIndex.constEnd())
+      {
+         authorIter = mAuthorsIndex.insert(author, mAuthors.count());
+         mAuthors.append(author.split("<").first());
+      }
+
+      authorIds[i] = authorIter.value();
+
+      const auto minute = fields.at(i).date / 60;
+      auto dateIter = mDatesIndex.constFind(minute);
+
+      if (dateIter == mDatesIndex.constEnd())
+      {
+         dateIter = mDatesIndex.insert(minute, mDates.count() + newMinutes.count());
+         newMinutes.append(minute);
+      }
+
+      dateIds[i] = dateIter.value();
+   }
+
+   const auto totalDates = newMinutes.count();
+   const auto firstDate = mDates.count();
+   mDates.resize(firstDate + totalDates);
+
+   const auto formattedDates = mDates.data() + firstDate;
+   const auto formatChunk = [this, &newMinutes, formattedDates, totalDates](int first) {
+      const auto last = std::min(first + FORMATTING_CHUNK_SIZE, totalDates);
+
+      for (auto i = first; i < last; ++i)
+      {
+         const auto date = QDateTime::fromSecsSinceEpoch(newMinutes.at(i) * 60);
+         formattedDates[i] = { date.toString(DATE_FORMAT), date.toString(mToolTipDateFormat) };
+      }
+   };
+
+   // Every date is formatted in its own slot, so big loads can be formatted in parallel.
+   if (totalDates <= FORMATTING_CHUNK_SIZE)
+      formatChunk(0);
+   else
+   {
+      QVector<int> chunks;
+
+      for (auto first = 0; first < totalDates; first += FORMATTING_CHUNK_SIZE)
+         chunks.append(first);
+
+      QtConcurrent::blockingMap(chunks, formatChunk);
+   }
+
+   const auto position = std::clamp(firstRow, 0, mAuthorIds.count());
+   const auto insertRows = [position](auto &column, const auto &values) {
+      if (position == column.count())
+         column.append(values);
+      else
+      {
+         column.insert(position, values.count(), {});
+         std::copy(values.cbegin(), values.cend(), column.begin() + position);
+      }
+   };
+
+   insertRows(mAuthorIds, authorIds);
+   insertRows(mDateIds, dateIds);
+   insertRows(mShas, shas);
+   insertRows(mSubjectOffsets, subjectOffsets);
+   insertRows(mSubjectSizes, subjectSizes);
+}
+
+void CommitHistoryModel::clearDisplayColumns()
+{
+   mAuthorIds.clear();
+   mDateIds.clear();
+   mAuthors.clear();
+   mAuthorsIndex.clear();
+   mDates.clear();
+   mDatesIndex.clear();
+   mShas.clear();
+   mSubjects.clear();
+   mSubjectOffsets.clear();
+   mSubjectSizes.clear();
+}
+
 QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
    if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
@@ -63,7 +191,7 @@ QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation
 
 QModelIndex CommitHistoryModel::index(int row, int column, const QModelIndex &) const
 {
-   return row >= 0 && row < mCache->count() ? createIndex(row, column, nullptr) : QModelIndex();
+   return row >= 0 && row < mRowCount ? createIndex(row, column, nullptr) : QModelIndex();
 }
 
 QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
@@ -71,57 +199,68 @@ QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
    return QModelIndex();
 }
 
-QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
+QVariant CommitHistoryModel::getToolTipData(int row) const
 {
-   QString auxMessage;
-   const auto sha = r.sha();
+   // The WIP has no tooltip.
+   if (row == 0 || row >= mAuthorIds.count() || mAuthorIds.at(row) == -1)
+      return QString();
 
-   if (mGit->getCurrentBranch().isEmpty())
-      auxMessage.append("<p>Status: <b>detached</b></p>");
+   // The status of HEAD is added by the delegate, that keeps it for painting.
+   const auto r = mCache->getCommitViewByRow(row);
+   QString auxMessage;
 
-   const auto localBranches = r.getReferences(References::Type::LocalBranch);
+   const auto localBranches = r.references.getReferences(References::Type::LocalBranch);
 
    if (!localBranches.isEmpty())
       auxMessage.append(QString("<p><b>Local: </b>%1</p>").arg(localBranches.join(",")));
 
-   const auto remoteBranches = r.getReferences(References::Type::RemoteBranches);
+   const auto remoteBranches = r.references.getReferences(References::Type::RemoteBranches);
 
    if (!remoteBranches.isEmpty())
       auxMessage.append(QString("<p><b>Remote: </b>%1</p>").arg(remoteBranches.join(",")));
 
-   const auto tags = r.getReferences(References::Type::Tag);
+   const auto tags = r.references.getReferences(References::Type::Tag);
 
    if (!tags.isEmpty())
       auxMessage.append(QString("<p><b>Tags: </b>%1</p>").arg(tags.join(",")));
 
-   QDateTime d;
-   d.setSecsSinceEpoch(r.authorDate().toUInt());
-
-   QLocale locale;
+   return QString("<p>%1 - %2<p></p>%3</p>%4")
+       .arg(mAuthors.at(mAuthorIds.at(row)), mDates.at(mDateIds.at(row)).toolTip, r.getSha(), auxMessage);
+}
 
-   return sha == CommitInfo::ZERO_SHA
-       ? QString()
-       : QString("<p>%1 - %2<p></p>%3</p>%4")
-             .arg(r.author().split("<").first(), d.toString(locale.dateFormat(QLocale::ShortFormat)), sha, auxMessage);
+QVariant CommitHistoryModel::getDisplayData(int row, int column) const
+{
+   switch (static_cast<CommitHistoryColumns>(column))
+   {
+      case CommitHistoryColumns::SHA:
+         return row < mAuthorIds.count() && mAuthorIds.at(row) != -1 ? mShas.at(row).toSha() : QString();
+      case CommitHistoryColumns::LOG:
+         return row < mAuthorIds.count() && mAuthorIds.at(row) != -1
+             ? QString::fromUtf8(mSubjects.constData() + mSubjectOffsets.at(row), mSubjectSizes.at(row))
+             : QString();
+      case CommitHistoryColumns::AUTHOR:
+         return row < mAuthorIds.count() && mAuthorIds.at(row) != -1 ? mAuthors.at(mAuthorIds.at(row)) : QString();
+      case CommitHistoryColumns::DATE:
+         return row < mDateIds.count() && mDateIds.at(row) != -1 ? mDates.at(mDateIds.at(row)).display : QString();
+      default:
+         return QVariant();
+   }
 }
 
-QVariant CommitHistoryModel::getDisplayData(const CommitInfo &rev, int column) const
+QVariant CommitHistoryModel::getWipDisplayData(int column) const
 {
+   const auto wip = mCache->getCommitInfoByRow(0);
+
    switch (static_cast<CommitHistoryColumns>(column))
    {
-      case CommitHistoryColumns::SHA: {
-         const auto sha = rev.sha();
-         return sha;
-      }
+      case CommitHistoryColumns::SHA:
+         return wip.sha();
       case CommitHistoryColumns::LOG:
-         return rev.shortLog();
-      case CommitHistoryColumns::AUTHOR: {
-         const auto author = rev.author().split("<").first();
-         return author;
-      }
-      case CommitHistoryColumns::DATE: {
-         return QDateTime::fromSecsSinceEpoch(rev.authorDate().toUInt()).toString("dd MMM yyyy hh:mm");
-      }
+         return wip.shortLog();
+      case CommitHistoryColumns::AUTHOR:
+         return wip.author().split("<").first();
+      case CommitHistoryColumns::DATE:
+         return QDateTime::fromSecsSinceEpoch(wip.dateSinceEpoch()).toString(DATE_FORMAT);
       default:
          return QVariant();
    }
@@ -132,13 +271,11 @@ QVariant CommitHistoryModel::data(const QModelIndex &index, int role) const
    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole))
       return QVariant();
 
-   const auto r = mCache->getCommitInfoByRow(index.row());
-
    if (role == Qt::ToolTipRole)
-      return getToolTipData(r);
+      return getToolTipData(index.row());
 
    if (role == Qt::DisplayRole)
-      return getDisplayData(r, index.column());
+      return index.row() == 0 ? getWipDisplayData(index.column()) : getDisplayData(index.row(), index.column());
 
    return QVariant();
 }
@@ -23,11 +23,14 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <ObjectId.h>
+
 #include <QAbstractItemModel>
 #include <QSharedPointer>
+#include <QHash>
+#include <QVector>
 
 class RevisionsCache;
-class GitBase;
 class CommitInfo;
 enum class CommitHistoryColumns;
 
@@ -45,11 +48,9 @@ public:
     * @brief The default constructor.
     *
     * @param cache The internal cache of the current repository.
-    * @param git The git object to execute Git operations.
     * @param parent The parent widget if needed.
     */
-   explicit CommitHistoryModel(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
-                               QObject *parent = nullptr);
+   explicit CommitHistoryModel(const QSharedPointer<RevisionsCache> &cache, QObject *parent = nullptr);
 
    /**
     * @brief Clears the contents without deleting the cache.
@@ -124,6 +125,20 @@ public:
     * @param totalCommits The total of new revisions.
     */
    void onNewRevisions(int totalCommits);
+   /**
+    * @brief Inserts the rows of the revisions that have been appended to the cache while the repository is still
+    * loading. The rows already shown are not reset.
+    *
+    * @param totalCommits The total of revisions available in the cache.
+    */
+   void onRevisionsAppended(int totalCommits);
+   /**
+    * @brief Inserts the rows of the revisions that have been added to the cache in an incremental update.
+    *
+    * @param row The first row where the revisions were inserted.
+    * @param count The number of revisions inserted.
+    */
+   void onRevisionsInserted(int row, int count);
    /*!
     * \brief Gets the number of columns in the model.
     * \return The number of columns.
@@ -132,23 +147,68 @@ public:
 
 private:
    QSharedPointer<RevisionsCache> mCache;
-   QSharedPointer<GitBase> mGit;
+   int mRowCount = 0;
+   QString mToolTipDateFormat;
+
+   /**
+    * @brief The DisplayDate struct contains the formatted texts of a date.
+    */
+   struct DisplayDate
+   {
+      QString display;
+      QString toolTip;
+   };
+
+   // The author and date of every row as indexes in the interned lists. Most of the commits share their author and
+   // many of them the minute, so the texts are only formatted once.
+   QVector<int> mAuthorIds;
+   QVector<int> mDateIds;
+   QVector<QString> mAuthors;
+   QHash<QString, int> mAuthorsIndex;
+   QVector<DisplayDate> mDates;
+   QHash<qint64, int> mDatesIndex;
+   // The SHA and the subject of every row, so the columns are read without locking the cache. The subjects are kept
+   // in UTF-8 in a single buffer.
+   QVector<ObjectId> mShas;
+   QByteArray mSubjects;
+   QVector<int> mSubjectOffsets;
+   QVector<int> mSubjectSizes;
 
+   /**
+    * @brief Builds the display columns of a range of rows reading all of them from the cache at once. The rows are
+    * inserted at the given position.
+    *
+    * @param firstRow The first row to build.
+    * @param count The number of rows.
+    */
+   void buildDisplayColumns(int firstRow, int count);
+   /**
+    * @brief Clears the display columns and the interned texts.
+    */
+   void clearDisplayColumns();
    /**
     * @brief Returns the tool tip data.
     *
-    * @param r The commit to generate the tooltip data.
+    * @param row The row to generate the tooltip data.
     * @return QVariant The tool tip data.
     */
-   QVariant getToolTipData(const CommitInfo &r) const;
+   QVariant getToolTipData(int row) const;
    /**
     * @brief Returns the data that will be display for every \p column.
     *
-    * @param rev The commit infor to retrieve the data that will be displayed.
+    * @param row The row to retrieve the data that will be displayed.
+    * @param column The column where the data will be shown.
+    * @return QVariant The data to be shown.
+    */
+   QVariant getDisplayData(int row, int column) const;
+   /**
+    * @brief Returns the data of the WIP. It changes with every update of the working directory so it's not part of
+    * the precomputed columns.
+    *
     * @param column The column where the data will be shown.
     * @return QVariant The data to be shown.
     */
-   QVariant getDisplayData(const CommitInfo &rev, int column) const;
+   QVariant getWipDisplayData(int column) const;
 
    QMap<CommitHistoryColumns, QString> mColumns;
 };
@@ -3,17 +3,26 @@
 #include <CommitHistoryModel.h>
 #include <CommitHistoryColumns.h>
 #include <CommitHistoryContextMenu.h>
-#include <ShaFilterProxyModel.h>
+#include <RowFilterProxyModel.h>
 #include <CommitInfo.h>
 #include <RevisionsCache.h>
 
 #include <QHeaderView>
 #include <QSettings>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QScrollBar>
+
+#include <algorithm>
 
 #include <QLogger.h>
 using namespace QLogger;
 
+namespace
+{
+constexpr int MAX_BENCHMARK_FRAMES = 2000;
+}
+
 CommitHistoryView::CommitHistoryView(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
                                      QWidget *parent)
    : QTreeView(parent)
@@ -37,7 +46,10 @@ void CommitHistoryView::setModel(QAbstractItemModel *model)
    connect(this, &CommitHistoryView::customContextMenuRequested, this, &CommitHistoryView::showContextMenu,
            Qt::UniqueConnection);
 
-   mCommitHistoryModel = dynamic_cast<CommitHistoryModel *>(model);
+   // The filter proxy is set on top of the history model, that is kept to restore it.
+   if (const auto historyModel = dynamic_cast<CommitHistoryModel *>(model))
+      mCommitHistoryModel = historyModel;
+
    QTreeView::setModel(model);
    setupGeometry();
    connect(this->selectionModel(), &QItemSelectionModel::selectionChanged, this,
@@ -53,25 +65,81 @@ void CommitHistoryView::setModel(QAbstractItemModel *model)
 
 void CommitHistoryView::filterBySha(const QStringList &shaList)
 {
-   mIsFiltering = true;
+   mFilterShas = shaList;
+   mFilterText.clear();
+
+   applyFilter(mCache->getRows(shaList));
+}
 
-   if (mProxyModel)
+void CommitHistoryView::filterByText(const QString &text)
+{
+   if (text.isEmpty())
    {
-      mProxyModel->beginResetModel();
-      mProxyModel->setAcceptedSha(shaList);
-      mProxyModel->endResetModel();
+      activateFilter(false);
+      return;
    }
-   else
+
+   // A commit that contains the new text also contains the previous one, so narrowing only checks the rows shown.
+   const auto narrowing = mIsFiltering && mProxyModel && model() == mProxyModel && !mFilterText.isEmpty()
+       && text.contains(mFilterText, Qt::CaseInsensitive);
+   const auto rows = narrowing ? mCache->filterRows(mProxyModel->getRows(), text) : mCache->searchCommits(text);
+
+   mFilterText = text;
+   mFilterShas.clear();
+
+   applyFilter(rows);
+}
+
+void CommitHistoryView::activateFilter(bool activate)
+{
+   mIsFiltering = activate;
+
+   if (!activate)
    {
-      mProxyModel = new ShaFilterProxyModel(this);
+      mFilterShas.clear();
+      mFilterText.clear();
+
+      if (mProxyModel && model() == mProxyModel)
+         setModel(mCommitHistoryModel);
+   }
+}
+
+int CommitHistoryView::sourceRow(int row) const
+{
+   return mIsFiltering && mProxyModel && model() == mProxyModel ? mProxyModel->sourceRow(row) : row;
+}
+
+void CommitHistoryView::applyFilter(const QVector<int> &rows)
+{
+   mIsFiltering = true;
+
+   if (!mProxyModel)
+   {
+      mProxyModel = new RowFilterProxyModel(this);
       mProxyModel->setSourceModel(mCommitHistoryModel);
-      mProxyModel->setAcceptedSha(shaList);
-      setModel(mProxyModel);
+
+      // The proxy empties itself on the reset and only shifts its rows on the insertion, so these must be connected
+      // after it to look for the matching commits again.
+      connect(mCommitHistoryModel, &CommitHistoryModel::modelReset, this, &CommitHistoryView::refreshFilter);
+      connect(mCommitHistoryModel, &CommitHistoryModel::rowsInserted, this, &CommitHistoryView::refreshFilter);
    }
 
+   mProxyModel->setRows(rows);
+
+   if (model() != mProxyModel)
+      setModel(mProxyModel);
+
    setupGeometry();
 }
 
+void CommitHistoryView::refreshFilter()
+{
+   if (!mFilterShas.isEmpty())
+      mProxyModel->setRows(mCache->getRows(mFilterShas));
+   else if (!mFilterText.isEmpty())
+      mProxyModel->setRows(mCache->searchCommits(mFilterText));
+}
+
 CommitHistoryView::~CommitHistoryView()
 {
    QSettings s;
@@ -112,6 +180,18 @@ void CommitHistoryView::currentChanged(const QModelIndex &index, const QModelInd
    mCurrentSha = model()->index(index.row(), static_cast<int>(CommitHistoryColumns::SHA)).data().toString();
 }
 
+void CommitHistoryView::setHighlightedRows(const QVector<int> &rows)
+{
+   mHighlightedRows = rows;
+
+   viewport()->update();
+}
+
+bool CommitHistoryView::isHighlighted(int row) const
+{
+   return std::binary_search(mHighlightedRows.cbegin(), mHighlightedRows.cend(), row);
+}
+
 void CommitHistoryView::clear()
 {
    mCommitHistoryModel->clear();
@@ -125,11 +205,8 @@ void CommitHistoryView::focusOnCommit(const QString &goToSha)
 
    auto row = mCache->getCommitPos(mCurrentSha);
 
-   if (mIsFiltering)
-   {
-      const auto sourceIndex = mProxyModel->sourceModel()->index(row, 0);
-      row = mProxyModel->mapFromSource(sourceIndex).row();
-   }
+   if (mIsFiltering && mProxyModel && model() == mProxyModel)
+      row = mProxyModel->proxyRow(row);
 
    clearSelection();
 
@@ -146,7 +223,8 @@ QModelIndexList CommitHistoryView::selectedIndexes() const
 
 void CommitHistoryView::showContextMenu(const QPoint &pos)
 {
-   if (!mIsFiltering)
+   // The history filtered by text keeps its menu, the views filtered by SHA provide their own.
+   if (!mIsFiltering || !mFilterText.isEmpty())
    {
       const auto shas = getSelectedShaList();
 
@@ -183,9 +261,10 @@ QList<QString> CommitHistoryView::getSelectedShaList() const
 
    for (auto index : indexes)
    {
-      const auto sha = mCommitHistoryModel->sha(index.row());
+      const auto row = sourceRow(index.row());
+      const auto sha = mCommitHistoryModel->sha(row);
       const auto dtStr
-          = mCommitHistoryModel->index(index.row(), static_cast<int>(CommitHistoryColumns::DATE)).data().toString();
+          = mCommitHistoryModel->index(row, static_cast<int>(CommitHistoryColumns::DATE)).data().toString();
       const auto dt = QDateTime::fromString(dtStr, "dd MMM yyyy hh:mm");
 
       shas.insert(dt, sha);
@@ -220,3 +299,44 @@ QList<QString> CommitHistoryView::getSelectedShaList() const
 
    return commitsInSameBranch || shas.count() == 1 ? shas.values() : QList<QString>();
 }
+
+void CommitHistoryView::runScrollBenchmark()
+{
+   if (!isVisible())
+   {
+      QLog_Warning("UI", "The scroll benchmark needs the history view to be visible.");
+      return;
+   }
+
+   executeDelayedItemsLayout();
+
+   const auto scrollBar = verticalScrollBar();
+   const auto initialValue = scrollBar->value();
+   const auto step = qMax(1, scrollBar->pageStep());
+   const auto frames = qMin(MAX_BENCHMARK_FRAMES, scrollBar->maximum() / step + 1);
+
+   const auto paintFrames = [this, scrollBar, step, frames](bool down) {
+      QElapsedTimer timer;
+      timer.start();
+
+      for (auto frame = 0; frame < frames; ++frame)
+      {
+         scrollBar->setValue((down ? frame : frames - 1 - frame) * step);
+         viewport()->repaint();
+      }
+
+      return frames * 1000.0 / qMax<qint64>(1, timer.elapsed());
+   };
+
+   const auto fpsDown = paintFrames(true);
+   const auto fpsUp = paintFrames(false);
+
+   scrollBar->setValue(initialValue);
+
+   QLog_Info("UI",
+             QString("Scroll benchmark: {%1} frames of {%2} rows. Down: {%3} fps. Up: {%4} fps.")
+                 .arg(frames)
+                 .arg(step)
+                 .arg(fpsDown, 0, 'f', 1)
+                 .arg(fpsUp, 0, 'f', 1));
+}
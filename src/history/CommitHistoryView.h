@@ -28,7 +28,7 @@
 class RevisionsCache;
 class GitBase;
 class CommitHistoryModel;
-class ShaFilterProxyModel;
+class RowFilterProxyModel;
 
 /**
  * @brief The CommitHistoryView is the class that represents the View in a MVC pattern. It shows the data provided by
@@ -109,23 +109,50 @@ public:
     */
    QList<QString> getSelectedShaList() const;
    /**
-    * @brief If the view has a filter active this method tells the filter which SHAs are going to be shown.
+    * @brief Filters the view to show only the given SHAs. The filter is kept when the history is reloaded.
     *
     * @param shaList List of SHA to pass to the filter.
     */
    void filterBySha(const QStringList &shaList);
    /**
-    * @brief Activates/deactivates filtering in the view.
+    * @brief Filters the view to show only the commits whose subject, body, author or SHA contain the text. When the
+    * text contains the text of the current filter, only the commits already shown are checked.
+    *
+    * @param text The text to filter by. An empty text removes the filter.
+    */
+   void filterByText(const QString &text);
+   /**
+    * @brief Activates/deactivates filtering in the view. Deactivating it shows the whole history again.
     *
     * @param activate True to activate the filter. Otherwise false,
     */
-   void activateFilter(bool activate) { mIsFiltering = activate; }
+   void activateFilter(bool activate);
    /**
     * @brief Tells if the user has any active filter.
     *
     * @return bool Returns true if the widget is actively filtering. Otherwise, false.
     */
    bool hasActiveFilter() const { return mIsFiltering; }
+   /**
+    * @brief Maps a row of the view to the row of the history model.
+    *
+    * @param row The row in the view.
+    * @return int The row in the history model.
+    */
+   int sourceRow(int row) const;
+   /**
+    * @brief Highlights the given rows of the source model, for example the results of a search.
+    *
+    * @param rows The rows sorted in ascending order. An empty list removes the highlight.
+    */
+   void setHighlightedRows(const QVector<int> &rows);
+   /**
+    * @brief Tells if a row of the source model is highlighted.
+    *
+    * @param row The row.
+    * @return bool Returns true if the row is highlighted. Otherwise, false.
+    */
+   bool isHighlighted(int row) const;
 
    /**
     * @brief Clears any selection or data in the view.
@@ -149,14 +176,22 @@ public:
     * @return QModelIndexList The list of selected indexes.
     */
    QModelIndexList selectedIndexes() const override;
+   /**
+    * @brief Scrolls the view page by page from the top to the bottom and back, painting every page synchronously. The
+    * frames per second of each pass are written in the log.
+    */
+   void runScrollBenchmark();
 
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
    CommitHistoryModel *mCommitHistoryModel = nullptr;
-   ShaFilterProxyModel *mProxyModel = nullptr;
+   RowFilterProxyModel *mProxyModel = nullptr;
    bool mIsFiltering = false;
    QString mCurrentSha;
+   QVector<int> mHighlightedRows;
+   QStringList mFilterShas;
+   QString mFilterText;
 
    /**
     * @brief Shows the context menu for the CommitHistoryView.
@@ -169,6 +204,16 @@ private:
     * destroyed.
     */
    void saveHeaderState();
+   /**
+    * @brief Shows only the given rows of the history model.
+    *
+    * @param rows The rows sorted in ascending order.
+    */
+   void applyFilter(const QVector<int> &rows);
+   /**
+    * @brief Calculates again the rows of the current filter after the history model is reset or gets new rows.
+    */
+   void refreshFilter();
    /**
     * @brief Configures the tree view and how the columns look like.
     *
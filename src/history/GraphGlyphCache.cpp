@@ -0,0 +1,43 @@
+#include "GraphGlyphCache.h"
+
+namespace
+{
+// The costs are in KB so the budgets are about 4 MB each.
+constexpr int MAX_LANES_COST = 4 * 1024;
+constexpr int MAX_BADGES_COST = 4 * 1024;
+
+int pixmapCost(const QPixmap &pixmap)
+{
+   return qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024);
+}
+}
+
+GraphGlyphCache::GraphGlyphCache()
+   : mLanes(MAX_LANES_COST)
+   , mBadges(MAX_BADGES_COST)
+{
+}
+
+QPixmap GraphGlyphCache::lane(const LaneKey &key) const
+{
+   const auto pixmap = mLanes.object(key);
+
+   return pixmap ? *pixmap : QPixmap();
+}
+
+void GraphGlyphCache::insertLane(const LaneKey &key, const QPixmap &pixmap)
+{
+   mLanes.insert(key, new QPixmap(pixmap), pixmapCost(pixmap));
+}
+
+QPixmap GraphGlyphCache::badge(const BadgeKey &key) const
+{
+   const auto pixmap = mBadges.object(key);
+
+   return pixmap ? *pixmap : QPixmap();
+}
+
+void GraphGlyphCache::insertBadge(const BadgeKey &key, const QPixmap &pixmap)
+{
+   mBadges.insert(key, new QPixmap(pixmap), pixmapCost(pixmap));
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QCache>
+#include <QColor>
+#include <QPixmap>
+#include <QString>
+
+/**
+ * @brief The GraphGlyphCache class keeps the pixmaps of the lanes and the reference badges painted in the history
+ * graph. Painting them needs antialiased paths and text measurements, but the combinations that appear in a
+ * repository are only a few, so once they are rendered scrolling is mostly a matter of blitting pixmaps.
+ *
+ * The pixmaps are rendered for a device pixel ratio, so it's part of the keys.
+ */
+class GraphGlyphCache
+{
+public:
+   /**
+    * @brief The LaneKey struct identifies the pixmap of a lane segment.
+    */
+   struct LaneKey
+   {
+      int type = 0;
+      bool headPresent = false;
+      bool isWip = false;
+      bool hasChilds = false;
+      QRgb color = 0;
+      QRgb activeColor = 0;
+      QRgb mergeColor = 0;
+      int dpr = 100;
+
+      bool operator==(const LaneKey &other) const
+      {
+         return type == other.type && headPresent == other.headPresent && isWip == other.isWip
+             && hasChilds == other.hasChilds && color == other.color && activeColor == other.activeColor
+             && mergeColor == other.mergeColor && dpr == other.dpr;
+      }
+   };
+
+   /**
+    * @brief The BadgeKey struct identifies the pixmap of a reference badge.
+    */
+   struct BadgeKey
+   {
+      QString text;
+      QRgb color = 0;
+      bool bold = false;
+      int dpr = 100;
+
+      bool operator==(const BadgeKey &other) const
+      {
+         return text == other.text && color == other.color && bold == other.bold && dpr == other.dpr;
+      }
+   };
+
+   GraphGlyphCache();
+
+   /**
+    * @brief Converts a device pixel ratio to the value used in the keys.
+    *
+    * @param dpr The device pixel ratio.
+    * @return The ratio in hundredths.
+    */
+   static int dprKey(qreal dpr) { return qRound(dpr * 100); }
+
+   /**
+    * @brief Gets the pixmap of a lane.
+    *
+    * @param key The key of the lane.
+    * @return The pixmap or a null pixmap if it's not cached.
+    */
+   QPixmap lane(const LaneKey &key) const;
+   /**
+    * @brief Stores the pixmap of a lane.
+    *
+    * @param key The key of the lane.
+    * @param pixmap The rendered pixmap.
+    */
+   void insertLane(const LaneKey &key, const QPixmap &pixmap);
+
+   /**
+    * @brief Gets the pixmap of a badge.
+    *
+    * @param key The key of the badge.
+    * @return The pixmap or a null pixmap if it's not cached.
+    */
+   QPixmap badge(const BadgeKey &key) const;
+   /**
+    * @brief Stores the pixmap of a badge.
+    *
+    * @param key The key of the badge.
+    * @param pixmap The rendered pixmap.
+    */
+   void insertBadge(const BadgeKey &key, const QPixmap &pixmap);
+
+private:
+   QCache<LaneKey, QPixmap> mLanes;
+   QCache<BadgeKey, QPixmap> mBadges;
+};
+
+inline uint qHash(const GraphGlyphCache::LaneKey &key, uint seed = 0)
+{
+   return seed ^ key.color ^ (key.mergeColor * 31u) ^ (key.activeColor * 17u)
+       ^ static_cast<uint>(key.type | key.headPresent << 8 | key.isWip << 9 | key.hasChilds << 10 | key.dpr << 11);
+}
+
+inline uint qHash(const GraphGlyphCache::BadgeKey &key, uint seed = 0)
+{
+   return qHash(key.text, seed) ^ key.color ^ static_cast<uint>(key.bold | key.dpr << 1);
+}
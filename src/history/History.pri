@@ -5,12 +5,16 @@ HEADERS += \
     $$PWD/CommitHistoryContextMenu.h \
     $$PWD/CommitHistoryModel.h \
     $$PWD/CommitHistoryView.h \
+    $$PWD/GraphGlyphCache.h \
+    $$PWD/RenderSnapshot.h \
     $$PWD/RepositoryViewDelegate.h \
-    $$PWD/ShaFilterProxyModel.h
+    $$PWD/RowFilterProxyModel.h
 
 SOURCES += \
     $$PWD/CommitHistoryContextMenu.cpp \
     $$PWD/CommitHistoryModel.cpp \
     $$PWD/CommitHistoryView.cpp \
+    $$PWD/GraphGlyphCache.cpp \
+    $$PWD/RenderSnapshot.cpp \
     $$PWD/RepositoryViewDelegate.cpp \
-    $$PWD/ShaFilterProxyModel.cpp
+    $$PWD/RowFilterProxyModel.cpp
@@ -0,0 +1,35 @@
+#include "RenderSnapshot.h"
+
+namespace
+{
+// The records are only built for the rows that are painted, so this is only reached after scrolling a lot.
+constexpr auto MAX_RECORDS = 20000;
+}
+
+RenderSnapshot::RenderSnapshot(int generation, int wipGeneration, const HeadState &head)
+   : mGeneration(generation)
+   , mWipGeneration(wipGeneration)
+   , mHead(head)
+{
+}
+
+void RenderSnapshot::updateWip(int wipGeneration)
+{
+   mWipGeneration = wipGeneration;
+   mRows.remove(0);
+}
+
+const RenderSnapshot::Row *RenderSnapshot::find(int row) const
+{
+   const auto iter = mRows.constFind(row);
+
+   return iter != mRows.constEnd() ? &iter.value() : nullptr;
+}
+
+const RenderSnapshot::Row &RenderSnapshot::insert(int row, Row record)
+{
+   if (mRows.count() >= MAX_RECORDS)
+      mRows.clear();
+
+   return *mRows.insert(row, std::move(record));
+}
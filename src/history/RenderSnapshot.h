@@ -0,0 +1,144 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QColor>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The RenderSnapshot class keeps the display records that the RepositoryViewDelegate uses to paint the rows of
+ * the graph. Every record is built once from the cache and it's immutable after that: the texts are already formatted
+ * and measured, the lanes are stored as bytes and the reference badges are already resolved with their colors.
+ *
+ * The snapshot belongs to a generation of the RevisionsCache. When the cache changes the delegate replaces it outside
+ * of the painting, building the records of the visible rows in advance. When only the WIP changes, only its record is
+ * discarded. The HEAD state is kept apart so it's never queried while painting.
+ */
+class RenderSnapshot
+{
+public:
+   /**
+    * @brief The Badge struct is the precomputed representation of a reference painted in the log column.
+    */
+   struct Badge
+   {
+      QString text;
+      QColor color;
+      QColor textColor;
+      bool bold = false;
+      int width = 0;
+      int minimalWidth = 0;
+      int textHeight = 0;
+   };
+
+   /**
+    * @brief The Row struct contains everything needed to paint a row without accessing the cache.
+    */
+   struct Row
+   {
+      QString sha;
+      bool isWip = false;
+      bool hasChilds = false;
+      bool hasParents = false;
+      bool pendingChanges = false;
+      QByteArray lanes;
+      int activeLane = 0;
+      QVector<QString> texts;
+      QVector<int> textWidths;
+      QVector<Badge> badges;
+   };
+
+   /**
+    * @brief The HeadState struct stores the current branch or the detached SHA of the repository.
+    */
+   struct HeadState
+   {
+      QString currentBranch;
+      QString detachedSha;
+
+      bool operator==(const HeadState &other) const
+      {
+         return currentBranch == other.currentBranch && detachedSha == other.detachedSha;
+      }
+      bool operator!=(const HeadState &other) const { return !(*this == other); }
+   };
+
+   RenderSnapshot() = default;
+   /**
+    * @brief Creates an empty snapshot for the given generation of the cache.
+    *
+    * @param generation The generation of the cache.
+    * @param wipGeneration The generation of the WIP.
+    * @param head The HEAD state of the repository.
+    */
+   RenderSnapshot(int generation, int wipGeneration, const HeadState &head);
+
+   /**
+    * @brief Gets the generation of the cache the records belong to.
+    *
+    * @return The generation.
+    */
+   int getGeneration() const { return mGeneration; }
+   /**
+    * @brief Gets the generation of the WIP the record of the WIP belongs to.
+    *
+    * @return The generation of the WIP.
+    */
+   int getWipGeneration() const { return mWipGeneration; }
+   /**
+    * @brief Discards the record of the WIP, keeping the rest of the records.
+    *
+    * @param wipGeneration The new generation of the WIP.
+    */
+   void updateWip(int wipGeneration);
+   /**
+    * @brief Gets the HEAD state used to build the badges.
+    *
+    * @return The HEAD state.
+    */
+   const HeadState &getHeadState() const { return mHead; }
+   /**
+    * @brief Finds the record of a row.
+    *
+    * @param row The row in the cache.
+    * @return The record or nullptr if it's not built yet.
+    */
+   const Row *find(int row) const;
+   /**
+    * @brief Stores the record of a row. If the snapshot grows too much, the previous records are discarded.
+    *
+    * @param row The row in the cache.
+    * @param record The record to store.
+    * @return The stored record.
+    */
+   const Row &insert(int row, Row record);
+
+private:
+   int mGeneration = -1;
+   int mWipGeneration = -1;
+   HeadState mHead;
+   QHash<int, Row> mRows;
+};
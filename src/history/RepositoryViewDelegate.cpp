@@ -4,25 +4,75 @@
 #include <GitLocal.h>
 #include <Lane.h>
 #include <LaneType.h>
-#include <CommitInfo.h>
+#include <CommitStore.h>
 #include <CommitHistoryColumns.h>
 #include <CommitHistoryView.h>
 #include <CommitHistoryModel.h>
 #include <RevisionsCache.h>
 #include <GitBase.h>
 
-#include <QSortFilterProxyModel>
 #include <QPainter>
 #include <QPainterPath>
+#include <QScrollBar>
+#include <QHelpEvent>
+#include <QToolTip>
 
-static const int MIN_VIEW_WIDTH_PX = 480;
+namespace
+{
+constexpr int MIN_VIEW_WIDTH_PX = 480;
+// The lanes overflow a bit to the right of their width, so the glyphs have some margin.
+constexpr int LANE_GLYPH_MARGIN = 4;
+constexpr int BADGE_TEXT_PADDING = 3;
+const QString MINIMAL_BADGE_TEXT = QStringLiteral(". . .");
+
+int textWidth(const QFontMetrics &metrics, const QString &text)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+   return metrics.horizontalAdvance(text);
+#else
+   return metrics.boundingRect(text).width();
+#endif
+}
+
+Lane laneAt(const RenderSnapshot::Row &record, int i)
+{
+   return Lane(static_cast<LaneType>(static_cast<quint8>(record.lanes.at(i))));
+}
+
+QFont textFont(QFont font)
+{
+   font.setPointSize(9);
+
+   return font;
+}
+
+QFont shaFont(QFont font)
+{
+   font.setPointSize(10);
+   font.setFamily("Ubuntu Mono");
+
+   return font;
+}
+}
 
 RepositoryViewDelegate::RepositoryViewDelegate(const QSharedPointer<RevisionsCache> &cache,
                                                const QSharedPointer<GitBase> &git, CommitHistoryView *view)
    : mCache(cache)
    , mGit(git)
    , mView(view)
+   , mHighlightColor(GitQlientStyles::getOrange())
 {
+   mHighlightColor.setAlpha(60);
+
+   mRefreshTimer.setSingleShot(true);
+   mRefreshTimer.setInterval(0);
+
+   connect(&mRefreshTimer, &QTimer::timeout, this, &RepositoryViewDelegate::refreshSnapshot);
+   connect(mCache.data(), &RevisionsCache::signalCacheUpdated, this, &RepositoryViewDelegate::scheduleRefresh);
+   // The rows that appear when scrolling are built before the view paints them.
+   connect(mView->verticalScrollBar(), &QScrollBar::valueChanged, this, &RepositoryViewDelegate::buildVisibleRecords);
+
+   scheduleRefresh();
 }
 
 void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt, const QModelIndex &index) const
@@ -30,45 +80,208 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
    p->setRenderHints(QPainter::Antialiasing);
 
    QStyleOptionViewItem newOpt(opt);
-   newOpt.font.setPointSize(9);
+   newOpt.font = textFont(newOpt.font);
+
+   const auto row = mView->sourceRow(index.row());
 
    if (newOpt.state & QStyle::State_Selected)
       p->fillRect(newOpt.rect, GitQlientStyles::getGraphSelectionColor());
    else if (newOpt.state & QStyle::State_MouseOver)
       p->fillRect(newOpt.rect, GitQlientStyles::getGraphHoverColor());
+   else if (mView->isHighlighted(row))
+      p->fillRect(newOpt.rect, mHighlightColor);
 
-   const auto row = mView->hasActiveFilter()
-       ? dynamic_cast<QSortFilterProxyModel *>(mView->model())->mapToSource(index).row()
-       : index.row();
+   // The cache is never read while painting. A row without record is painted again once it's built.
+   const auto record = mSnapshot.find(row);
 
-   const auto commit = mCache->getCommitInfoByRow(row);
-
-   if (commit.sha().isEmpty())
+   if (!record)
+   {
+      scheduleRefresh();
       return;
+   }
 
-   if (index.column() == static_cast<int>(CommitHistoryColumns::GRAPH))
-      paintGraph(p, newOpt, commit);
-   else if (index.column() == static_cast<int>(CommitHistoryColumns::LOG))
-      paintLog(p, newOpt, commit, index.data().toString());
-   else
+   const auto column = index.column();
+
+   if (column == static_cast<int>(CommitHistoryColumns::GRAPH))
+      paintGraph(p, newOpt, *record);
+   else if (column == static_cast<int>(CommitHistoryColumns::LOG))
+      paintLog(p, newOpt, *record);
+   else if (column < record->texts.count())
    {
       p->setPen(GitQlientStyles::getTextColor());
       newOpt.rect.setX(newOpt.rect.x() + 10);
 
-      auto text = index.data().toString();
+      if (column == static_cast<int>(CommitHistoryColumns::SHA))
+         newOpt.font = shaFont(newOpt.font);
+
+      paintText(p, newOpt, record->texts.at(column), record->textWidths.at(column));
+   }
+}
+
+void RepositoryViewDelegate::scheduleRefresh() const
+{
+   if (!mRefreshTimer.isActive())
+      mRefreshTimer.start();
+}
 
-      if (index.column() == static_cast<int>(CommitHistoryColumns::SHA))
+void RepositoryViewDelegate::refreshSnapshot()
+{
+   RenderSnapshot::HeadState head;
+   head.currentBranch = mGit->getCurrentBranch();
+
+   if (head.currentBranch.isEmpty() || head.currentBranch == "HEAD")
+   {
+      if (const auto ret = mGit->getLastCommit(); ret.success)
+         head.detachedSha = ret.output.toString().trimmed();
+   }
+
+   const auto generation = mCache->getGeneration();
+   const auto wipGeneration = mCache->getWipGeneration();
+
+   // When only the local changes are updated, the records of the commits are still valid.
+   if (generation != mSnapshot.getGeneration() || head != mSnapshot.getHeadState())
+      mSnapshot = RenderSnapshot(generation, wipGeneration, head);
+   else if (wipGeneration != mSnapshot.getWipGeneration())
+      mSnapshot.updateWip(wipGeneration);
+
+   buildVisibleRecords();
+}
+
+void RepositoryViewDelegate::buildVisibleRecords()
+{
+   const auto model = mView->model();
+
+   if (!model || model->rowCount() == 0)
+      return;
+
+   const auto viewport = mView->viewport()->rect();
+   const auto first = mView->indexAt(viewport.topLeft());
+   const auto last = mView->indexAt(viewport.bottomLeft());
+   const auto firstRow = first.isValid() ? first.row() : 0;
+   const auto lastRow = last.isValid() ? last.row() : model->rowCount() - 1;
+   const auto font = textFont(mView->font());
+   auto built = false;
+
+   for (auto viewRow = firstRow; viewRow <= lastRow; ++viewRow)
+   {
+      const auto row = mView->sourceRow(viewRow);
+
+      if (mSnapshot.find(row))
+         continue;
+
+      if (auto record = buildRecord(model->index(viewRow, 0), row, font); !record.sha.isEmpty())
+      {
+         mSnapshot.insert(row, std::move(record));
+         built = true;
+      }
+   }
+
+   if (built)
+      mView->viewport()->update();
+}
+
+RenderSnapshot::Row RepositoryViewDelegate::buildRecord(const QModelIndex &index, int row, const QFont &font) const
+{
+   const auto commit = mCache->getCommitViewByRow(row);
+
+   if (!commit.isValid())
+      return {};
+
+   RenderSnapshot::Row record;
+   record.sha = commit.getSha();
+   record.isWip = commit.isWip;
+   record.hasChilds = commit.hasChilds;
+   record.hasParents = commit.parentsCount != 0;
+   record.pendingChanges = record.isWip && mCache->pendingLocalChanges();
+   record.activeLane = commit.getActiveLane();
+   record.lanes = commit.lanes;
+
+   const QFontMetrics fm(font);
+   const QFontMetrics shaFm(shaFont(font));
+   const auto columns = index.model()->columnCount();
+
+   record.texts.reserve(columns);
+   record.textWidths.reserve(columns);
+
+   for (auto column = 0; column < columns; ++column)
+   {
+      auto text = index.sibling(index.row(), column).data().toString();
+
+      if (column == static_cast<int>(CommitHistoryColumns::SHA))
       {
-         newOpt.font.setPointSize(10);
-         newOpt.font.setFamily("Ubuntu Mono");
          text = text.left(8);
+         record.textWidths.append(textWidth(shaFm, text));
       }
+      else
+         record.textWidths.append(textWidth(fm, text));
+
+      record.texts.append(text);
+   }
+
+   if (!commit.references.isEmpty())
+      record.badges = buildBadges(commit, font);
+
+   return record;
+}
+
+QVector<RenderSnapshot::Badge> RepositoryViewDelegate::buildBadges(const CommitView &commit, const QFont &font) const
+{
+   const auto &head = mSnapshot.getHeadState();
+   QMap<QString, QColor> markValues;
+
+   if (!head.detachedSha.isEmpty() && commit.getSha() == head.detachedSha)
+      markValues.insert("detached", GitQlientStyles::getDetachedColor());
+
+   const auto localBranches = commit.references.getReferences(References::Type::LocalBranch);
+   for (const auto &branch : localBranches)
+      markValues.insert(branch,
+                        branch == head.currentBranch ? GitQlientStyles::getCurrentBranchColor()
+                                                     : GitQlientStyles::getLocalBranchColor());
+
+   const auto remoteBranches = commit.references.getReferences(References::Type::RemoteBranches);
+   for (const auto &branch : remoteBranches)
+      markValues.insert(branch, QColor("#011f4b"));
+
+   const auto tags = commit.references.getReferences(References::Type::Tag);
+   for (const auto &tag : tags)
+      markValues.insert(tag, GitQlientStyles::getTagColor());
+
+   QVector<RenderSnapshot::Badge> badges;
+   badges.reserve(markValues.count());
 
-      QFontMetrics fm(newOpt.font);
-      p->setFont(newOpt.font);
-      p->drawText(newOpt.rect, fm.elidedText(text, Qt::ElideRight, newOpt.rect.width()),
-                  QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
+   for (auto mapIt = markValues.constBegin(); mapIt != markValues.constEnd(); ++mapIt)
+   {
+      RenderSnapshot::Badge badge;
+      badge.text = mapIt.key();
+      badge.color = mapIt.value();
+      // TODO: Fix this with a nicer way
+      badge.textColor = QColor(badge.color == QColor("#dec3c3") ? QString("#000000") : QString("#FFFFFF"));
+      badge.bold = badge.text == "detached" || badge.text == head.currentBranch;
+
+      auto badgeFont = font;
+      badgeFont.setBold(badge.bold);
+
+      const QFontMetrics fm(badgeFont);
+      const auto textBoundingRect = fm.boundingRect(badge.text);
+      badge.width = textBoundingRect.width() + 2 * BADGE_TEXT_PADDING;
+      badge.minimalWidth = fm.boundingRect(MINIMAL_BADGE_TEXT).width() + 2 * BADGE_TEXT_PADDING;
+      badge.textHeight = textBoundingRect.height();
+
+      badges.append(badge);
    }
+
+   return badges;
+}
+
+void RepositoryViewDelegate::paintText(QPainter *p, const QStyleOptionViewItem &opt, const QString &text,
+                                       int width) const
+{
+   p->setFont(opt.font);
+
+   const auto fits = width <= opt.rect.width();
+
+   p->drawText(opt.rect, fits ? text : QFontMetrics(opt.font).elidedText(text, Qt::ElideRight, opt.rect.width()),
+               QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
 }
 
 QSize RepositoryViewDelegate::sizeHint(const QStyleOptionViewItem &, const QModelIndex &) const
@@ -76,6 +289,25 @@ QSize RepositoryViewDelegate::sizeHint(const QStyleOptionViewItem &, const QMode
    return QSize(LANE_WIDTH, ROW_HEIGHT);
 }
 
+bool RepositoryViewDelegate::helpEvent(QHelpEvent *event, QAbstractItemView *view, const QStyleOptionViewItem &option,
+                                       const QModelIndex &index)
+{
+   if (event && event->type() == QEvent::ToolTip && index.isValid()
+       && !mSnapshot.getHeadState().detachedSha.isEmpty())
+   {
+      auto toolTip = index.data(Qt::ToolTipRole).toString();
+
+      if (!toolTip.isEmpty())
+      {
+         toolTip.append("<p>Status: <b>detached</b></p>");
+         QToolTip::showText(event->globalPos(), toolTip, view);
+         return true;
+      }
+   }
+
+   return QStyledItemDelegate::helpEvent(event, view, option, index);
+}
+
 void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, int x2,
                                             const QColor &col, const QColor &activeCol, const QColor &mergeColor,
                                             bool isWip, bool hasChilds) const
@@ -223,8 +455,8 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool
    }
 }
 
-QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const CommitInfo &commit, int currentLaneIndex,
-                                             const QColor &defaultColor, bool &isSet) const
+QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const RenderSnapshot::Row &record,
+                                             int currentLaneIndex, const QColor &defaultColor, bool &isSet) const
 {
    auto mergeColor = defaultColor;
    //= GitQlientStyles::getBranchColorAt((commit.getLanesCount() - 1) % GitQlientStyles::getTotalBranchColors());
@@ -244,7 +476,7 @@ QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const Comm
       case LaneType::JOIN_L:
          for (auto laneCount = 0; laneCount < currentLaneIndex; ++laneCount)
          {
-            if (commit.getLane(laneCount).equals(LaneType::JOIN_L))
+            if (laneAt(record, laneCount).equals(LaneType::JOIN_L))
             {
                mergeColor = GitQlientStyles::getBranchColorAt(laneCount % GitQlientStyles::getTotalBranchColors());
                isSet = true;
@@ -259,7 +491,8 @@ QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const Comm
    return mergeColor;
 }
 
-void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem &opt, const CommitInfo &commit) const
+void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem &opt,
+                                        const RenderSnapshot::Row &record) const
 {
    p->save();
    p->setClipRect(opt.rect, Qt::IntersectClip);
@@ -268,26 +501,24 @@ void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem
    if (mView->hasActiveFilter())
    {
       const auto activeColor = GitQlientStyles::getBranchColorAt(0);
-      paintGraphLane(p, LaneType::ACTIVE, false, 0, LANE_WIDTH, activeColor, activeColor, activeColor, false,
-                     commit.hasChilds());
+      drawLane(p, LaneType::ACTIVE, false, 0, activeColor, activeColor, activeColor, false, record.hasChilds);
    }
    else
    {
-      if (commit.sha() == CommitInfo::ZERO_SHA)
+      if (record.isWip)
       {
          const auto activeColor = GitQlientStyles::getBranchColorAt(0);
          QColor color = activeColor;
 
-         if (mCache->pendingLocalChanges())
+         if (record.pendingChanges)
             color = QColor("#D89000");
 
-         paintGraphLane(p, LaneType::BRANCH, false, 0, LANE_WIDTH, color, activeColor, activeColor, true,
-                        commit.parentsCount() != 0);
+         drawLane(p, LaneType::BRANCH, false, 0, color, activeColor, activeColor, true, record.hasParents);
       }
       else
       {
-         const auto laneNum = commit.getLanesCount();
-         const auto activeLane = commit.getActiveLane();
+         const auto laneNum = record.lanes.count();
+         const auto activeLane = record.activeLane;
          const auto activeColor
              = GitQlientStyles::getBranchColorAt(activeLane % GitQlientStyles::getTotalBranchColors());
          auto x1 = 0;
@@ -299,11 +530,11 @@ void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem
          {
             x1 = x2 - LANE_WIDTH;
 
-            auto currentLane = commit.getLane(i);
+            const auto currentLane = laneAt(record, i);
 
             if (!laneHeadPresent && i < laneNum - 1)
             {
-               auto prevLane = commit.getLane(i + 1);
+               const auto prevLane = laneAt(record, i + 1);
                laneHeadPresent
                    = prevLane.isHead() || prevLane.equals(LaneType::JOIN_R) || prevLane.equals(LaneType::JOIN_L);
             }
@@ -316,10 +547,10 @@ void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem
                   color = GitQlientStyles::getBranchColorAt(i % GitQlientStyles::getTotalBranchColors());
 
                if (!isSet)
-                  mergeColor = getMergeColor(currentLane, commit, i, color, isSet);
+                  mergeColor = getMergeColor(currentLane, record, i, color, isSet);
 
-               paintGraphLane(p, currentLane, laneHeadPresent, x1, x2, color, activeColor, mergeColor, false,
-                              commit.hasChilds());
+               drawLane(p, currentLane, laneHeadPresent, x1, color, activeColor, mergeColor, false,
+                        record.hasChilds);
 
                if (mView->hasActiveFilter())
                   break;
@@ -330,94 +561,108 @@ void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem
    p->restore();
 }
 
-void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &opt, const CommitInfo &commit,
-                                      const QString &text) const
+void RepositoryViewDelegate::drawLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, const QColor &col,
+                                      const QColor &activeCol, const QColor &mergeColor, bool isWip,
+                                      bool hasChilds) const
 {
-   const auto sha = commit.sha();
+   const auto dpr = p->device()->devicePixelRatioF();
 
-   if (sha.isEmpty())
-      return;
+   GraphGlyphCache::LaneKey key;
+   key.type = static_cast<int>(lane.getType());
+   key.headPresent = laneHeadPresent;
+   key.isWip = isWip;
+   key.hasChilds = hasChilds;
+   key.color = col.rgba();
+   key.activeColor = activeCol.rgba();
+   key.mergeColor = mergeColor.rgba();
+   key.dpr = GraphGlyphCache::dprKey(dpr);
+
+   auto glyph = mGlyphCache.lane(key);
+
+   if (glyph.isNull())
+   {
+      glyph = QPixmap(QSize(LANE_WIDTH + 2 * LANE_GLYPH_MARGIN, ROW_HEIGHT) * dpr);
+      glyph.setDevicePixelRatio(dpr);
+      glyph.fill(Qt::transparent);
+
+      QPainter painter(&glyph);
+      painter.setRenderHints(QPainter::Antialiasing);
+      paintGraphLane(&painter, lane, laneHeadPresent, LANE_GLYPH_MARGIN, LANE_GLYPH_MARGIN + LANE_WIDTH, col,
+                     activeCol, mergeColor, isWip, hasChilds);
+      painter.end();
+
+      mGlyphCache.insertLane(key, glyph);
+   }
+
+   p->drawPixmap(x1 - LANE_GLYPH_MARGIN, 0, glyph);
+}
 
+void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &opt,
+                                      const RenderSnapshot::Row &record) const
+{
    auto offset = 0;
 
-   if (commit.hasReferences() && !mView->hasActiveFilter())
+   if (!record.badges.isEmpty() && !mView->hasActiveFilter())
    {
       offset = 5;
-      paintTagBranch(p, opt, offset, sha);
+      paintTagBranch(p, opt, offset, record.badges);
    }
 
    auto newOpt = opt;
    newOpt.rect.setX(opt.rect.x() + offset + 5);
 
-   QFontMetrics fm(newOpt.font);
+   const auto column = static_cast<int>(CommitHistoryColumns::LOG);
 
-   p->setFont(newOpt.font);
    p->setPen(GitQlientStyles::getTextColor());
-   p->drawText(newOpt.rect, fm.elidedText(text, Qt::ElideRight, newOpt.rect.width()),
-               QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
+   paintText(p, newOpt, record.texts.value(column), record.textWidths.value(column));
 }
 
 void RepositoryViewDelegate::paintTagBranch(QPainter *painter, QStyleOptionViewItem o, int &startPoint,
-                                            const QString &sha) const
+                                            const QVector<RenderSnapshot::Badge> &badges) const
 {
-   QMap<QString, QColor> markValues;
-   const auto currentBranch = mGit->getCurrentBranch();
-   const auto commit = mCache->getCommitInfo(sha);
-
-   if ((currentBranch.isEmpty() || currentBranch == "HEAD"))
-   {
-      if (const auto ret = mGit->getLastCommit(); ret.success && commit.sha() == ret.output.toString().trimmed())
-         markValues.insert("detached", GitQlientStyles::getDetachedColor());
-   }
-
-   if (commit.hasReferences())
-   {
-      const auto localBranches = commit.getReferences(References::Type::LocalBranch);
-      for (const auto &branch : localBranches)
-         markValues.insert(branch,
-                           branch == currentBranch ? GitQlientStyles::getCurrentBranchColor()
-                                                   : GitQlientStyles::getLocalBranchColor());
-
-      const auto remoteBranches = commit.getReferences(References::Type::RemoteBranches);
-      for (const auto &branch : remoteBranches)
-         markValues.insert(branch, QColor("#011f4b"));
-
-      const auto tags = commit.getReferences(References::Type::Tag);
-      for (const auto &tag : tags)
-         markValues.insert(tag, GitQlientStyles::getTagColor());
-   }
-
    const auto showMinimal = o.rect.width() <= MIN_VIEW_WIDTH_PX;
    const int mark_spacing = 5; // Space between markers in pixels
-   const auto mapEnd = markValues.constEnd();
+   const auto dpr = painter->device()->devicePixelRatioF();
 
-   for (auto mapIt = markValues.constBegin(); mapIt != mapEnd; ++mapIt)
+   for (const auto &badge : badges)
    {
-      const auto isCurrentSpot = mapIt.key() == "detached" || mapIt.key() == currentBranch;
-      o.font.setBold(isCurrentSpot);
-
-      const auto nameToDisplay = showMinimal ? QString(". . .") : mapIt.key();
-      QFontMetrics fm(o.font);
-      const auto textBoundingRect = fm.boundingRect(nameToDisplay);
-      const int textPadding = 3;
-      const auto rectWidth = textBoundingRect.width() + 2 * textPadding;
-
-      painter->save();
-      painter->setRenderHint(QPainter::Antialiasing);
-      painter->setPen(QPen(mapIt.value(), 2));
-      QPainterPath path;
-      path.addRoundedRect(QRectF(o.rect.x() + startPoint, o.rect.y() + 4, rectWidth, ROW_HEIGHT - 8), 1, 1);
-      painter->fillPath(path, mapIt.value());
-      painter->drawPath(path);
+      const auto &nameToDisplay = showMinimal ? MINIMAL_BADGE_TEXT : badge.text;
+      const auto rectWidth = showMinimal ? badge.minimalWidth : badge.width;
 
-      // TODO: Fix this with a nicer way
-      painter->setPen(QColor(mapIt.value() == QColor("#dec3c3") ? QString("#000000") : QString("#FFFFFF")));
+      GraphGlyphCache::BadgeKey key;
+      key.text = nameToDisplay;
+      key.color = badge.color.rgba();
+      key.bold = badge.bold;
+      key.dpr = GraphGlyphCache::dprKey(dpr);
+
+      auto glyph = mGlyphCache.badge(key);
+
+      if (glyph.isNull())
+      {
+         // The pen of the border takes one pixel out of the rect in each side.
+         glyph = QPixmap(QSize(rectWidth + 2, ROW_HEIGHT) * dpr);
+         glyph.setDevicePixelRatio(dpr);
+         glyph.fill(Qt::transparent);
+
+         o.font.setBold(badge.bold);
+
+         QPainter glyphPainter(&glyph);
+         glyphPainter.setRenderHint(QPainter::Antialiasing);
+         glyphPainter.setPen(QPen(badge.color, 2));
+         QPainterPath path;
+         path.addRoundedRect(QRectF(1, 4, rectWidth, ROW_HEIGHT - 8), 1, 1);
+         glyphPainter.fillPath(path, badge.color);
+         glyphPainter.drawPath(path);
+
+         glyphPainter.setPen(badge.textColor);
+         glyphPainter.setFont(o.font);
+         glyphPainter.drawText(1 + BADGE_TEXT_PADDING, badge.textHeight + 2, nameToDisplay);
+         glyphPainter.end();
+
+         mGlyphCache.insertBadge(key, glyph);
+      }
 
-      const auto fontRect = textBoundingRect.height();
-      const auto y = o.rect.y() + ROW_HEIGHT - (ROW_HEIGHT - fontRect) + 2;
-      painter->setFont(o.font);
-      painter->drawText(o.rect.x() + startPoint + textPadding, y, nameToDisplay);
-      painter->restore();
+      painter->drawPixmap(o.rect.x() + startPoint - 1, o.rect.y(), glyph);
 
       startPoint += rectWidth + mark_spacing;
    }
@@ -23,13 +23,18 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <RenderSnapshot.h>
+#include <GraphGlyphCache.h>
+
 #include <QStyledItemDelegate>
+#include <QTimer>
 
 class CommitHistoryView;
 class RevisionsCache;
 class GitBase;
 class Lane;
-class CommitInfo;
+struct CommitView;
+class QFont;
 
 const int ROW_HEIGHT = 25;
 const int LANE_WIDTH = 3 * ROW_HEIGHT / 4;
@@ -69,29 +74,84 @@ public:
     * @return QSize returns the size of a row.
     */
    QSize sizeHint(const QStyleOptionViewItem &, const QModelIndex &) const override;
+   /**
+    * @brief Shows the tooltip of the model adding the status of HEAD from the snapshot, so it's not read from Git
+    * while hovering.
+    *
+    * @return Returns true if the event was handled.
+    */
+   bool helpEvent(QHelpEvent *event, QAbstractItemView *view, const QStyleOptionViewItem &option,
+                  const QModelIndex &index) override;
 
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
    CommitHistoryView *mView = nullptr;
    int diffTargetRow = -1;
+   RenderSnapshot mSnapshot;
+   mutable GraphGlyphCache mGlyphCache;
+   QColor mHighlightColor;
+   // Coalesces several changes of the cache in a single refresh.
+   mutable QTimer mRefreshTimer;
+
+   /**
+    * @brief Schedules the refresh of the display records. It's also requested while painting a row that has no
+    * record yet.
+    */
+   void scheduleRefresh() const;
+   /**
+    * @brief Reads the current branch or the detached SHA and, if the cache or the HEAD changed, replaces the snapshot
+    * with a new one. If only the WIP changed, only its record is discarded. Then the visible rows are built.
+    */
+   void refreshSnapshot();
+   /**
+    * @brief Builds the display records of the visible rows that don't have one yet. It's done out of the painting so
+    * the cache is never locked while painting.
+    */
+   void buildVisibleRecords();
+   /**
+    * @brief Builds the display record of a row from the cache and the texts of the model.
+    *
+    * @param index An index of the row in the view.
+    * @param row The row in the cache.
+    * @param font The font used to paint the texts.
+    * @return The record, with an empty SHA if the row has no commit.
+    */
+   RenderSnapshot::Row buildRecord(const QModelIndex &index, int row, const QFont &font) const;
+   /**
+    * @brief Builds the badges of the references of a commit with their colors and sizes.
+    *
+    * @param commit The commit.
+    * @param font The font used to paint the badges.
+    * @return The list of badges sorted by name.
+    */
+   QVector<RenderSnapshot::Badge> buildBadges(const CommitView &commit, const QFont &font) const;
 
    /**
     * @brief Paints the log column. This method is in charge of painting the commit message as well as tags or branches.
     *
     * @param p The painter device.
     * @param o The style options of the item.
-    * @param i The index with the item data.
+    * @param record The display record of the row.
     */
-   void paintLog(QPainter *p, const QStyleOptionViewItem &o, const CommitInfo &commit, const QString &text) const;
+   void paintLog(QPainter *p, const QStyleOptionViewItem &o, const RenderSnapshot::Row &record) const;
+   /**
+    * @brief Paints a text that was already measured. The text is only elided if it doesn't fit.
+    *
+    * @param p The painter device.
+    * @param o The style options of the item.
+    * @param text The text to paint.
+    * @param width The width of the text.
+    */
+   void paintText(QPainter *p, const QStyleOptionViewItem &o, const QString &text, int width) const;
    /**
     * @brief Method that sets up the configuration to paint the lane for the commit graph representation.
     *
     * @param p The painter device.
     * @param o The style options of the item.
-    * @param index The index with the item data.
+    * @param record The display record of the row.
     */
-   void paintGraph(QPainter *p, const QStyleOptionViewItem &o, const CommitInfo &commit) const;
+   void paintGraph(QPainter *p, const QStyleOptionViewItem &o, const RenderSnapshot::Row &record) const;
 
    /**
     * @brief Specialization method called by @ref paintGrapth that does the actual lane painting.
@@ -109,16 +169,33 @@ private:
    void paintGraphLane(QPainter *p, const Lane &type, bool laneHeadPresent, int x1, int x2, const QColor &col,
                        const QColor &activeCol, const QColor &mergeColor, bool isWip = false, bool hasChilds = true) const;
 
+   /**
+    * @brief Paints a lane blitting its cached pixmap. The pixmap is rendered with @ref paintGraphLane the first time.
+    *
+    * @param p The painter device.
+    * @param lane The lane to paint.
+    * @param laneHeadPresent Tells the method if the lane contains a head.
+    * @param x1 X coordinate where the painting starts
+    * @param col Color of the lane
+    * @param activeCol Color of the active lane
+    * @param mergeColor Color of the lane where the merge comes from in case the commit is a end-merge point.
+    * @param isWip Tells the method if it's the WIP commit so it's painted differently.
+    * @param hasChilds Tells the method if the commit has children.
+    */
+   void drawLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, const QColor &col,
+                 const QColor &activeCol, const QColor &mergeColor, bool isWip, bool hasChilds) const;
+
    /**
     * @brief Specialized method that paints a tag in the commit message column.
     *
     * @param painter The painter device.
     * @param opt The style options of the item.
     * @param startPoint The starting X coordinate for the tag.
-    * @param sha The SHA reference to paint. It can be local branch, remote branch, tag or it could be detached.
+    * @param badges The badges to paint. They can be local branches, remote branches, tags or the detached HEAD.
     */
-   void paintTagBranch(QPainter *painter, QStyleOptionViewItem opt, int &startPoint, const QString &sha) const;
+   void paintTagBranch(QPainter *painter, QStyleOptionViewItem opt, int &startPoint,
+                       const QVector<RenderSnapshot::Badge> &badges) const;
 
-   QColor getMergeColor(const Lane &currentLane, const CommitInfo &commit, int currentLaneIndex,
+   QColor getMergeColor(const Lane &currentLane, const RenderSnapshot::Row &record, int currentLaneIndex,
                         const QColor &defaultColor, bool &isSet) const;
 };
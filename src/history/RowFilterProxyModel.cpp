@@ -0,0 +1,149 @@
+#include "RowFilterProxyModel.h"
+
+#include <algorithm>
+
+RowFilterProxyModel::RowFilterProxyModel(QObject *parent)
+   : QAbstractProxyModel(parent)
+{
+}
+
+void RowFilterProxyModel::setSourceModel(QAbstractItemModel *newSourceModel)
+{
+   beginResetModel();
+
+   if (const auto previous = sourceModel())
+      disconnect(previous, nullptr, this, nullptr);
+
+   QAbstractProxyModel::setSourceModel(newSourceModel);
+
+   mRows.clear();
+
+   if (newSourceModel)
+   {
+      connect(newSourceModel, &QAbstractItemModel::rowsInserted, this, &RowFilterProxyModel::onSourceRowsInserted);
+      connect(newSourceModel, &QAbstractItemModel::modelAboutToBeReset, this,
+              &RowFilterProxyModel::beginResetModel);
+      connect(newSourceModel, &QAbstractItemModel::modelReset, this, &RowFilterProxyModel::onSourceReset);
+      connect(newSourceModel, &QAbstractItemModel::dataChanged, this,
+              [this](const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles) {
+                 const auto first = std::lower_bound(mRows.cbegin(), mRows.cend(), topLeft.row()) - mRows.cbegin();
+                 const auto last
+                     = std::upper_bound(mRows.cbegin(), mRows.cend(), bottomRight.row()) - mRows.cbegin() - 1;
+
+                 if (first <= last)
+                 {
+                    emit dataChanged(index(static_cast<int>(first), topLeft.column()),
+                                     index(static_cast<int>(last), bottomRight.column()), roles);
+                 }
+              });
+   }
+
+   updateProxyRows();
+
+   endResetModel();
+}
+
+void RowFilterProxyModel::setRows(const QVector<int> &rows)
+{
+   beginResetModel();
+
+   mRows = rows;
+   updateProxyRows();
+
+   endResetModel();
+}
+
+QModelIndex RowFilterProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+   if (!proxyIndex.isValid() || !sourceModel())
+      return QModelIndex();
+
+   return sourceModel()->index(sourceRow(proxyIndex.row()), proxyIndex.column());
+}
+
+QModelIndex RowFilterProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+   if (!sourceIndex.isValid())
+      return QModelIndex();
+
+   return index(proxyRow(sourceIndex.row()), sourceIndex.column());
+}
+
+QModelIndex RowFilterProxyModel::index(int row, int column, const QModelIndex &parent) const
+{
+   return !parent.isValid() && row >= 0 && row < mRows.count() && column >= 0 && column < columnCount()
+       ? createIndex(row, column)
+       : QModelIndex();
+}
+
+QModelIndex RowFilterProxyModel::parent(const QModelIndex &) const
+{
+   return QModelIndex();
+}
+
+int RowFilterProxyModel::rowCount(const QModelIndex &parent) const
+{
+   return !parent.isValid() ? mRows.count() : 0;
+}
+
+int RowFilterProxyModel::columnCount(const QModelIndex &parent) const
+{
+   return !parent.isValid() && sourceModel() ? sourceModel()->columnCount() : 0;
+}
+
+bool RowFilterProxyModel::hasChildren(const QModelIndex &parent) const
+{
+   return !parent.isValid();
+}
+
+QVariant RowFilterProxyModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+   // The columns are the same than in the source model, even when no row is shown.
+   return sourceModel() ? sourceModel()->headerData(section, orientation, role) : QVariant();
+}
+
+void RowFilterProxyModel::updateProxyRows()
+{
+   mProxyRows.fill(-1, sourceModel() ? sourceModel()->rowCount() : 0);
+
+   for (auto row = 0; row < mRows.count(); ++row)
+   {
+      if (mRows.at(row) < mProxyRows.count())
+         mProxyRows[mRows.at(row)] = row;
+   }
+}
+
+void RowFilterProxyModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+   if (parent.isValid())
+      return;
+
+   const auto count = last - first + 1;
+
+   // Appending rows doesn't change the rows shown.
+   if (mRows.isEmpty() || mRows.constLast() < first)
+   {
+      mProxyRows.insert(std::min(first, mProxyRows.count()), count, -1);
+      return;
+   }
+
+   beginResetModel();
+
+   for (auto &row : mRows)
+   {
+      if (row >= first)
+         row += count;
+   }
+
+   updateProxyRows();
+
+   endResetModel();
+}
+
+void RowFilterProxyModel::onSourceReset()
+{
+   mRows.clear();
+   updateProxyRows();
+
+   endResetModel();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QAbstractProxyModel>
+#include <QVector>
+
+/**
+ * @brief The RowFilterProxyModel class is a proxy that shows only a set of rows of the source model. The accepted rows
+ * are kept as a sorted vector of source rows together with the reverse mapping, so both directions of the mapping are
+ * a lookup and the filter never has to read the data of the source model.
+ *
+ * When rows are inserted in the source model the accepted rows are shifted so they keep pointing to the same commits.
+ * When the source model is reset the filter is emptied and the owner is in charge of setting the new rows.
+ */
+class RowFilterProxyModel : public QAbstractProxyModel
+{
+   Q_OBJECT
+
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param parent The parent object if needed.
+    */
+   explicit RowFilterProxyModel(QObject *parent = nullptr);
+
+   /**
+    * @brief Sets the source model and connects to its changes.
+    *
+    * @param sourceModel The source model.
+    */
+   void setSourceModel(QAbstractItemModel *sourceModel) override;
+   /**
+    * @brief Sets the rows of the source model that will be shown.
+    *
+    * @param rows The source rows sorted in ascending order.
+    */
+   void setRows(const QVector<int> &rows);
+   /**
+    * @brief Gets the rows of the source model that are shown.
+    *
+    * @return The source rows sorted in ascending order.
+    */
+   const QVector<int> &getRows() const { return mRows; }
+   /**
+    * @brief Maps a row of the proxy to the source model.
+    *
+    * @param row The proxy row.
+    * @return The source row or -1 if it doesn't exist.
+    */
+   int sourceRow(int row) const { return row >= 0 && row < mRows.count() ? mRows.at(row) : -1; }
+   /**
+    * @brief Maps a row of the source model to the proxy.
+    *
+    * @param sourceRow The source row.
+    * @return The proxy row or -1 if the row is not shown.
+    */
+   int proxyRow(int sourceRow) const
+   {
+      return sourceRow >= 0 && sourceRow < mProxyRows.count() ? mProxyRows.at(sourceRow) : -1;
+   }
+
+   QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+   QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+   QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+   QModelIndex parent(const QModelIndex &index) const override;
+   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+   int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+   bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+   QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+   QVector<int> mRows;
+   // The proxy row of every source row, -1 if the row is not shown.
+   QVector<int> mProxyRows;
+
+   void updateProxyRows();
+   void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+   void onSourceReset();
+};